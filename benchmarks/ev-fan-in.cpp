@@ -0,0 +1,101 @@
+//
+// Copyright (c) 2019-2020 Ivan Baidakou (basiliscos) (the dot dmol at gmail dot com)
+//
+// Distributed under the MIT Software License
+//
+
+/*
+    Measures inbound throughput of ev supervisor, when several producer threads
+    concurrently enqueue messages to the single actor.
+
+    Usage: ev-fan-in [producers] [messages_per_producer]
+*/
+
+#include "rotor/ev.hpp"
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct item_t {};
+
+struct consumer_t : public rotor::actor_base_t {
+    consumer_t(rotor::supervisor_t &sup, std::size_t expected_) : rotor::actor_base_t{sup}, expected{expected_} {}
+
+    void init_start() noexcept override {
+        subscribe(&consumer_t::on_item);
+        rotor::actor_base_t::init_start();
+    }
+
+    void on_start(rotor::message_t<rotor::payload::start_actor_t> &msg) noexcept override {
+        rotor::actor_base_t::on_start(msg);
+        started = true;
+    }
+
+    void on_item(rotor::message_t<item_t> &) noexcept {
+        if (++received == expected) {
+            finish = std::chrono::high_resolution_clock::now();
+            supervisor.do_shutdown();
+        }
+    }
+
+    std::size_t expected;
+    std::size_t received = 0;
+    std::atomic_bool started{false};
+    std::chrono::time_point<std::chrono::high_resolution_clock> finish;
+};
+
+int main(int argc, char **argv) {
+    std::size_t producers = argc > 1 ? std::stoul(argv[1]) : 4;
+    std::size_t per_producer = argc > 2 ? std::stoul(argv[2]) : 1000000;
+    auto total = producers * per_producer;
+
+    auto *loop = ev_loop_new(0);
+    auto system_context = rotor::ev::system_context_ev_t::ptr_t{new rotor::ev::system_context_ev_t()};
+    auto timeout = boost::posix_time::milliseconds{500};
+    auto conf = rotor::ev::supervisor_config_ev_t{timeout, loop, true};
+    auto sup = system_context->create_supervisor<rotor::ev::supervisor_ev_t>(conf);
+    auto consumer = sup->create_actor<consumer_t>(timeout, total);
+    auto address = consumer->get_address();
+
+    std::atomic_bool go{false};
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < producers; ++i) {
+        threads.emplace_back([&] {
+            while (!go) {
+                std::this_thread::yield();
+            }
+            for (std::size_t j = 0; j < per_producer; ++j) {
+                sup->enqueue(rotor::make_message<item_t>(address));
+            }
+        });
+    }
+
+    std::chrono::time_point<std::chrono::high_resolution_clock> start;
+    std::thread starter([&] {
+        while (!consumer->started) {
+            std::this_thread::yield();
+        }
+        start = std::chrono::high_resolution_clock::now();
+        go = true;
+    });
+
+    sup->start();
+    ev_run(loop);
+
+    starter.join();
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    std::chrono::duration<double> diff = consumer->finish - start;
+    std::cout << producers << " producers, " << total << " messages in " << diff.count() << "s, "
+              << (total / diff.count()) << " messages/s\n";
+
+    address.reset();
+    consumer.reset();
+    sup.reset();
+    return 0;
+}
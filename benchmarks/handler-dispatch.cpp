@@ -0,0 +1,139 @@
+//
+// Copyright (c) 2019-2020 Ivan Baidakou (basiliscos) (the dot dmol at gmail dot com)
+//
+// Distributed under the MIT Software License
+//
+
+/*
+    Measures pub-sub fanout: one message is delivered to several subscribers
+    (actors) of the same supervisor. The handlers invocation via virtual
+    `handler_base_t::call` is compared with the devirtualized thunk invocation,
+    and then the whole supervisor delivery (which uses thunks) is measured.
+
+    Usage: handler-dispatch [messages] [subscribers]
+*/
+
+#include "rotor.hpp"
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+struct sample_t {};
+
+struct subscriber_base_t : public rotor::actor_base_t {
+    using rotor::actor_base_t::actor_base_t;
+
+    rotor::address_ptr_t topic;
+    std::size_t received = 0;
+};
+
+/* different subscriber types, i.e. the handlers are not monomorphic, as in real application */
+template <int N> struct subscriber_t : public subscriber_base_t {
+    using subscriber_base_t::subscriber_base_t;
+
+    void init_start() noexcept override {
+        subscribe(&subscriber_t::on_sample, topic);
+        rotor::actor_base_t::init_start();
+    }
+
+    void on_sample(rotor::message_t<sample_t> &) noexcept { received += N; }
+};
+
+template <int N>
+static void add_subscriber(rotor::supervisor_t &sup, const rotor::address_ptr_t &topic,
+                           std::vector<rotor::intrusive_ptr_t<subscriber_base_t>> &actors,
+                           std::vector<rotor::subscription_t::classified_handlers_t> &handlers) {
+    auto timeout = boost::posix_time::milliseconds{500}; /* does not matter */
+    auto actor = sup.create_actor<subscriber_t<N>>(timeout);
+    actor->topic = topic;
+    auto handler = rotor::wrap_handler(*actor, &subscriber_t<N>::on_sample);
+    auto thunk = handler->thunk;
+    handlers.emplace_back(rotor::subscription_t::classified_handlers_t{std::move(handler), thunk, true});
+    actors.emplace_back(std::move(actor));
+}
+
+struct dummy_supervisor : public rotor::supervisor_t {
+    using rotor::supervisor_t::supervisor_t;
+
+    void start_timer(const rotor::pt::time_duration &, timer_id_t) noexcept override {}
+    void cancel_timer(timer_id_t) noexcept override {}
+    void start() noexcept override {}
+    void shutdown() noexcept override {}
+    void enqueue(rotor::message_ptr_t) noexcept override {}
+};
+
+using bench_clock_t = std::chrono::high_resolution_clock;
+
+static void report(const char *title, bench_clock_t::time_point start, std::size_t deliveries) {
+    std::chrono::duration<double> diff = bench_clock_t::now() - start;
+    std::cout << title << ": " << deliveries << " deliveries in " << diff.count() << "s, "
+              << (deliveries / diff.count()) << " deliveries/s\n";
+}
+
+int main(int argc, char **argv) {
+    std::size_t messages = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    std::size_t subscribers = argc > 2 ? std::stoul(argv[2]) : 8;
+    auto deliveries = messages * subscribers;
+
+    rotor::system_context_t ctx{};
+    auto timeout = boost::posix_time::milliseconds{500}; /* does not matter */
+    rotor::supervisor_config_t cfg{timeout};
+    auto sup = ctx.create_supervisor<dummy_supervisor>(nullptr, cfg);
+    auto topic = sup->make_address();
+
+    /* the same layout as supervisor's recipients table */
+    std::vector<rotor::intrusive_ptr_t<subscriber_base_t>> actors;
+    std::vector<rotor::subscription_t::classified_handlers_t> handlers;
+    for (std::size_t i = 0; i < subscribers; ++i) {
+        switch (i % 4) {
+        case 0:
+            add_subscriber<1>(*sup, topic, actors, handlers);
+            break;
+        case 1:
+            add_subscriber<2>(*sup, topic, actors, handlers);
+            break;
+        case 2:
+            add_subscriber<3>(*sup, topic, actors, handlers);
+            break;
+        default:
+            add_subscriber<4>(*sup, topic, actors, handlers);
+        }
+    }
+    sup->do_process();
+
+    auto message = rotor::make_message<sample_t>(topic);
+
+    auto start = bench_clock_t::now();
+    for (std::size_t i = 0; i < messages; ++i) {
+        for (auto &it : handlers) {
+            it.handler->call(message);
+        }
+    }
+    report("virtual call", start, deliveries);
+
+    start = bench_clock_t::now();
+    for (std::size_t i = 0; i < messages; ++i) {
+        for (auto &it : handlers) {
+            it.thunk(*it.handler, *message);
+        }
+    }
+    report("thunk call", start, deliveries);
+
+    start = bench_clock_t::now();
+    for (std::size_t i = 0; i < messages; ++i) {
+        sup->put(rotor::make_message<sample_t>(topic));
+        sup->do_process();
+    }
+    report("supervisor delivery", start, deliveries);
+
+    std::size_t received = 0;
+    for (auto &actor : actors) {
+        received += actor->received;
+    }
+    std::cout << "checksum: " << received << "\n";
+
+    sup->do_shutdown();
+    sup->do_process();
+    return 0;
+}
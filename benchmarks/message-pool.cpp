@@ -0,0 +1,118 @@
+//
+// Copyright (c) 2019-2020 Ivan Baidakou (basiliscos) (the dot dmol at gmail dot com)
+//
+// Distributed under the MIT Software License
+//
+
+/*
+    Measures global heap allocations per message in loop-less (single locality)
+    ping-pong with and without locality message pool.
+*/
+
+#include "rotor.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+
+static std::size_t allocations = 0;
+
+void *operator new(std::size_t size) {
+    ++allocations;
+    if (auto ptr = std::malloc(size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+
+struct ping_t {};
+struct pong_t {};
+
+struct pinger_t : public rotor::actor_base_t {
+    using rotor::actor_base_t::actor_base_t;
+
+    void set_ponger_addr(const rotor::address_ptr_t &addr) { ponger_addr = addr; }
+
+    void init_start() noexcept override {
+        subscribe(&pinger_t::on_pong);
+        rotor::actor_base_t::init_start();
+    }
+
+    void on_start(rotor::message_t<rotor::payload::start_actor_t> &msg) noexcept override {
+        rotor::actor_base_t::on_start(msg);
+        send<ping_t>(ponger_addr);
+    }
+
+    void on_pong(rotor::message_t<pong_t> &) noexcept {
+        if (--pings_left) {
+            send<ping_t>(ponger_addr);
+        } else {
+            supervisor.do_shutdown();
+        }
+    }
+
+    std::size_t pings_left;
+    rotor::address_ptr_t ponger_addr;
+};
+
+struct ponger_t : public rotor::actor_base_t {
+    using rotor::actor_base_t::actor_base_t;
+
+    void set_pinger_addr(const rotor::address_ptr_t &addr) { pinger_addr = addr; }
+
+    void init_start() noexcept override {
+        subscribe(&ponger_t::on_ping);
+        rotor::actor_base_t::init_start();
+    }
+
+    void on_ping(rotor::message_t<ping_t> &) noexcept { send<pong_t>(pinger_addr); }
+
+    rotor::address_ptr_t pinger_addr;
+};
+
+struct dummy_supervisor : public rotor::supervisor_t {
+    using rotor::supervisor_t::supervisor_t;
+
+    void start_timer(const rotor::pt::time_duration &, timer_id_t) noexcept override {}
+    void cancel_timer(timer_id_t) noexcept override {}
+    void start() noexcept override {}
+    void shutdown() noexcept override {}
+    void enqueue(rotor::message_ptr_t) noexcept override {}
+};
+
+static void measure(bool use_pool, std::size_t round_trips) {
+    rotor::system_context_t ctx{};
+    auto timeout = boost::posix_time::milliseconds{500}; /* does not matter */
+    rotor::supervisor_config_t cfg{timeout};
+    cfg.message_pool = use_pool;
+    auto sup = ctx.create_supervisor<dummy_supervisor>(nullptr, cfg);
+
+    auto pinger = sup->create_actor<pinger_t>(timeout);
+    auto ponger = sup->create_actor<ponger_t>(timeout);
+    pinger->set_ponger_addr(ponger->get_address());
+    pinger->pings_left = round_trips;
+    ponger->set_pinger_addr(pinger->get_address());
+
+    auto allocations_before = allocations;
+    auto start = std::chrono::high_resolution_clock::now();
+    sup->do_process();
+    auto end = std::chrono::high_resolution_clock::now();
+    auto total_allocations = allocations - allocations_before;
+
+    std::chrono::duration<double> diff = end - start;
+    auto messages = round_trips * 2;
+    std::cout << (use_pool ? "with" : "without") << " message pool: " << messages << " messages, "
+              << (static_cast<double>(total_allocations) / messages) << " allocations/message, " << diff.count()
+              << "s, " << (messages / diff.count()) << " messages/s\n";
+}
+
+int main(int argc, char **argv) {
+    std::size_t round_trips = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    measure(false, round_trips);
+    measure(true, round_trips);
+    return 0;
+}
@@ -0,0 +1,210 @@
+//
+// Copyright (c) 2019-2020 Ivan Baidakou (basiliscos) (the dot dmol at gmail dot com)
+//
+// Distributed under the MIT Software License
+//
+
+#include "bench.h"
+#include "rotor.hpp"
+#include "rotor/asio.hpp"
+#include <thread>
+
+namespace r = rotor;
+namespace ra = rotor::asio;
+namespace asio = boost::asio;
+using namespace rotor_bench;
+
+namespace {
+
+struct ping_t {};
+struct pong_t {};
+
+const auto timeout = r::pt::milliseconds{500};
+
+struct holding_supervisor_t : public ra::supervisor_asio_t {
+    using guard_t = asio::executor_work_guard<asio::io_context::executor_type>;
+
+    holding_supervisor_t(ra::supervisor_asio_t *sup, const ra::supervisor_config_asio_t &cfg)
+        : ra::supervisor_asio_t{sup, cfg}, guard{asio::make_work_guard(cfg.strand->context())} {}
+
+    void shutdown_finish() noexcept override {
+        ra::supervisor_asio_t::shutdown_finish();
+        guard.reset();
+    }
+
+    guard_t guard;
+};
+
+struct pinger_t : public r::actor_base_t {
+    using r::actor_base_t::actor_base_t;
+
+    void init_start() noexcept override {
+        subscribe(&pinger_t::on_pong);
+        r::actor_base_t::init_start();
+    }
+
+    void on_start(r::message_t<r::payload::start_actor_t> &msg) noexcept override {
+        r::actor_base_t::on_start(msg);
+        start = bench_clock_t::now();
+        send<ping_t>(ponger_addr);
+    }
+
+    void on_pong(r::message_t<pong_t> &) noexcept {
+        if (--pings_left) {
+            send<ping_t>(ponger_addr);
+        } else {
+            finish = bench_clock_t::now();
+            supervisor.shutdown();
+            ponger_addr->supervisor.shutdown();
+        }
+    }
+
+    std::size_t pings_left = 0;
+    r::address_ptr_t ponger_addr;
+    bench_clock_t::time_point start;
+    bench_clock_t::time_point finish;
+};
+
+struct ponger_t : public r::actor_base_t {
+    using r::actor_base_t::actor_base_t;
+
+    void init_start() noexcept override {
+        subscribe(&ponger_t::on_ping);
+        r::actor_base_t::init_start();
+    }
+
+    void on_ping(r::message_t<ping_t> &) noexcept { send<pong_t>(pinger_addr); }
+
+    r::address_ptr_t pinger_addr;
+};
+
+result_t ping_pong_threads(std::size_t scale) {
+    asio::io_context io_ctx1;
+    asio::io_context io_ctx2;
+    auto sys_ctx1 = ra::system_context_asio_t::ptr_t{new ra::system_context_asio_t(io_ctx1)};
+    auto sys_ctx2 = ra::system_context_asio_t::ptr_t{new ra::system_context_asio_t(io_ctx2)};
+    ra::supervisor_config_asio_t conf1{timeout, std::make_shared<asio::io_context::strand>(io_ctx1)};
+    ra::supervisor_config_asio_t conf2{timeout, std::make_shared<asio::io_context::strand>(io_ctx2)};
+    auto sup1 = sys_ctx1->create_supervisor<holding_supervisor_t>(conf1);
+    auto sup2 = sys_ctx2->create_supervisor<holding_supervisor_t>(conf2);
+
+    auto round_trips = std::max(scale / 20, std::size_t{1});
+    auto pinger = sup1->create_actor<pinger_t>(timeout);
+    auto ponger = sup2->create_actor<ponger_t>(timeout);
+    pinger->pings_left = round_trips;
+    pinger->ponger_addr = ponger->get_address();
+    ponger->pinger_addr = pinger->get_address();
+
+    // the threads are not started yet, so it is safe to initialize in the main thread;
+    // the ponger have to be ready before the first ping
+    sup2->do_process();
+    sup1->do_process();
+
+    auto t1 = std::thread([&] { io_ctx1.run(); });
+    auto t2 = std::thread([&] { io_ctx2.run(); });
+    t1.join();
+    t2.join();
+
+    std::chrono::duration<double> diff = pinger->finish - pinger->start;
+    return result_t{"messages", round_trips * 2, diff.count()};
+}
+
+struct sample_res_t {
+    std::size_t value;
+};
+
+struct sample_req_t {
+    using response_t = sample_res_t;
+    std::size_t value;
+};
+
+using request_t = r::request_traits_t<sample_req_t>::request::message_t;
+using response_t = r::request_traits_t<sample_req_t>::response::message_t;
+
+struct server_t : public r::actor_base_t {
+    using r::actor_base_t::actor_base_t;
+
+    void init_start() noexcept override {
+        subscribe(&server_t::on_request);
+        r::actor_base_t::init_start();
+    }
+
+    void on_request(request_t &req) noexcept { reply_to(req, req.payload.request_payload.value + 1); }
+};
+
+struct client_t : public r::actor_base_t {
+    using r::actor_base_t::actor_base_t;
+
+    void init_start() noexcept override {
+        subscribe(&client_t::on_response);
+        r::actor_base_t::init_start();
+    }
+
+    void on_start(r::message_t<r::payload::start_actor_t> &msg) noexcept override {
+        r::actor_base_t::on_start(msg);
+        start = bench_clock_t::now();
+        make_request();
+    }
+
+    void make_request() noexcept {
+        if (latency) {
+            latency->begin();
+        }
+        request<sample_req_t>(server_addr, requests_left).send(timeout);
+    }
+
+    void on_response(response_t &res) noexcept {
+        if (latency) {
+            latency->end();
+        }
+        if (!res.payload.ec && --requests_left) {
+            make_request();
+        } else {
+            finish = bench_clock_t::now();
+            supervisor.do_shutdown();
+        }
+    }
+
+    std::size_t requests_left = 0;
+    r::address_ptr_t server_addr;
+    latency_recorder_t *latency = nullptr;
+    bench_clock_t::time_point start;
+    bench_clock_t::time_point finish;
+};
+
+/* the timeout timers are real, i.e. each request arms and cancels asio deadline timer */
+result_t request_response(std::size_t scale, bool with_latency) {
+    asio::io_context io_ctx;
+    auto sys_ctx = ra::system_context_asio_t::ptr_t{new ra::system_context_asio_t(io_ctx)};
+    ra::supervisor_config_asio_t conf{timeout, std::make_shared<asio::io_context::strand>(io_ctx)};
+    auto sup = sys_ctx->create_supervisor<ra::supervisor_asio_t>(conf);
+
+    auto requests = std::max(scale / 20, std::size_t{1});
+    auto server = sup->create_actor<server_t>(timeout);
+    auto client = sup->create_actor<client_t>(timeout);
+    client->requests_left = requests;
+    client->server_addr = server->get_address();
+    latency_recorder_t latency;
+    if (with_latency) {
+        latency.samples.reserve(requests);
+        client->latency = &latency;
+    }
+
+    sup->start();
+    io_ctx.run();
+
+    std::chrono::duration<double> diff = client->finish - client->start;
+    return result_t{"requests", requests - client->requests_left, diff.count(), std::move(latency.samples)};
+}
+
+} // namespace
+
+namespace rotor_bench {
+
+void add_asio(suite_t &suite) {
+    suite.add("asio/ping-pong-2-threads", ping_pong_threads);
+    suite.add("asio/request-response", [](std::size_t scale) { return request_response(scale, false); });
+    suite.add("asio/request-latency", [](std::size_t scale) { return request_response(scale, true); });
+}
+
+} // namespace rotor_bench
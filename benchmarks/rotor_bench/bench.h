@@ -0,0 +1,109 @@
+#pragma once
+
+//
+// Copyright (c) 2019-2020 Ivan Baidakou (basiliscos) (the dot dmol at gmail dot com)
+//
+// Distributed under the MIT Software License
+//
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace rotor_bench {
+
+using bench_clock_t = std::chrono::steady_clock;
+
+/** \struct result_t
+ *  \brief outcome of a single scenario run
+ */
+struct result_t {
+    /** \brief what is counted, e.g. "messages" or "actors" */
+    std::string unit;
+
+    /** \brief amount of processed units */
+    std::size_t count;
+
+    /** \brief wall time spent on processing */
+    double seconds;
+
+    /** \brief optional per-unit latency samples, in seconds */
+    std::vector<double> latencies = {};
+};
+
+/** \struct stopwatch_t
+ *  \brief measures elapsed time since construction */
+struct stopwatch_t {
+    stopwatch_t() noexcept : start{bench_clock_t::now()} {}
+
+    /** \brief makes a result of `count` processed units in the elapsed time */
+    result_t result(const char *unit, std::size_t count) const {
+        std::chrono::duration<double> diff = bench_clock_t::now() - start;
+        return result_t{unit, count, diff.count()};
+    }
+
+    bench_clock_t::time_point start;
+};
+
+/** \struct latency_recorder_t
+ *  \brief collects the time between `begin` and `end` marks */
+struct latency_recorder_t {
+    void begin() noexcept { mark = bench_clock_t::now(); }
+
+    void end() {
+        std::chrono::duration<double> diff = bench_clock_t::now() - mark;
+        samples.push_back(diff.count());
+    }
+
+    bench_clock_t::time_point mark;
+    std::vector<double> samples;
+};
+
+/** \struct suite_t
+ *  \brief ordered list of named benchmark scenarios
+ *
+ * A scenario takes the scale (the baseline amount of iterations) and returns
+ * the amount of processed units and the time spent.
+ *
+ */
+struct suite_t {
+    using scenario_t = std::function<result_t(std::size_t scale)>;
+
+    struct entry_t {
+        std::string name;
+        scenario_t scenario;
+    };
+
+    void add(std::string name, scenario_t scenario) {
+        entries.emplace_back(entry_t{std::move(name), std::move(scenario)});
+    }
+
+    std::vector<entry_t> entries;
+};
+
+/** \brief registers loop-less scenarios (single thread, manual `do_process`) */
+void add_core(suite_t &suite);
+
+#ifdef ROTOR_BENCH_ASIO
+/** \brief registers boost::asio scenarios */
+void add_asio(suite_t &suite);
+#endif
+
+#ifdef ROTOR_BENCH_EV
+/** \brief registers libev scenarios */
+void add_ev(suite_t &suite);
+#endif
+
+#ifdef ROTOR_BENCH_POOL
+/** \brief registers thread pool scenarios, i.e. the scaling from 1 to N cores */
+void add_pool(suite_t &suite);
+#endif
+
+#ifdef ROTOR_BENCH_SHARD
+/** \brief registers thread-per-core shards scenarios */
+void add_shard(suite_t &suite);
+#endif
+
+} // namespace rotor_bench
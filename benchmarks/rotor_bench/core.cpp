@@ -0,0 +1,312 @@
+//
+// Copyright (c) 2019-2020 Ivan Baidakou (basiliscos) (the dot dmol at gmail dot com)
+//
+// Distributed under the MIT Software License
+//
+
+#include "bench.h"
+#include "rotor.hpp"
+
+namespace r = rotor;
+using namespace rotor_bench;
+
+namespace {
+
+struct ping_t {};
+struct pong_t {};
+struct sample_t {};
+
+struct sample_res_t {
+    std::size_t value;
+};
+
+struct sample_req_t {
+    using response_t = sample_res_t;
+    std::size_t value;
+};
+
+using request_t = r::request_traits_t<sample_req_t>::request::message_t;
+using response_t = r::request_traits_t<sample_req_t>::response::message_t;
+
+const auto timeout = r::pt::milliseconds{500}; /* does not matter, timers are not fired */
+
+struct bench_supervisor_t : public r::supervisor_t {
+    using r::supervisor_t::supervisor_t;
+
+    void start_timer(const r::pt::time_duration &, timer_id_t) noexcept override {}
+    void cancel_timer(timer_id_t) noexcept override {}
+    void start() noexcept override {}
+    void shutdown() noexcept override {}
+    void enqueue(r::message_ptr_t) noexcept override {}
+};
+
+using bench_supervisor_ptr_t = r::intrusive_ptr_t<bench_supervisor_t>;
+
+bench_supervisor_ptr_t make_supervisor(r::system_context_t &ctx) {
+    r::supervisor_config_t cfg{timeout};
+    auto sup = ctx.create_supervisor<bench_supervisor_t>(nullptr, cfg);
+    sup->do_process();
+    return sup;
+}
+
+void finish(bench_supervisor_t &sup) {
+    sup.do_shutdown();
+    sup.do_process();
+}
+
+struct pinger_t : public r::actor_base_t {
+    using r::actor_base_t::actor_base_t;
+
+    void init_start() noexcept override {
+        subscribe(&pinger_t::on_pong);
+        r::actor_base_t::init_start();
+    }
+
+    void on_pong(r::message_t<pong_t> &) noexcept {
+        if (--pings_left) {
+            send<ping_t>(ponger_addr);
+        }
+    }
+
+    std::size_t pings_left = 0;
+    r::address_ptr_t ponger_addr;
+};
+
+struct ponger_t : public r::actor_base_t {
+    using r::actor_base_t::actor_base_t;
+
+    void init_start() noexcept override {
+        subscribe(&ponger_t::on_ping);
+        r::actor_base_t::init_start();
+    }
+
+    void on_ping(r::message_t<ping_t> &) noexcept { send<pong_t>(pinger_addr); }
+
+    r::address_ptr_t pinger_addr;
+};
+
+result_t ping_pong(std::size_t scale) {
+    r::system_context_t ctx;
+    auto sup = make_supervisor(ctx);
+    auto pinger = sup->create_actor<pinger_t>(timeout);
+    auto ponger = sup->create_actor<ponger_t>(timeout);
+    pinger->ponger_addr = ponger->get_address();
+    ponger->pinger_addr = pinger->get_address();
+    sup->do_process();
+
+    auto round_trips = std::max(scale / 2, std::size_t{1});
+    pinger->pings_left = round_trips;
+    stopwatch_t watch;
+    sup->put(r::make_message<ping_t>(ponger->get_address()));
+    sup->do_process();
+    auto result = watch.result("messages", round_trips * 2);
+
+    finish(*sup);
+    return result;
+}
+
+struct subscriber_t : public r::actor_base_t {
+    using r::actor_base_t::actor_base_t;
+
+    void init_start() noexcept override {
+        subscribe(&subscriber_t::on_sample, topic);
+        r::actor_base_t::init_start();
+    }
+
+    void on_sample(r::message_t<sample_t> &) noexcept { ++received; }
+
+    r::address_ptr_t topic;
+    std::size_t received = 0;
+};
+
+result_t pub_sub(std::size_t scale, std::size_t width) {
+    r::system_context_t ctx;
+    auto sup = make_supervisor(ctx);
+    auto topic = sup->make_address();
+    for (std::size_t i = 0; i < width; ++i) {
+        auto actor = sup->create_actor<subscriber_t>(timeout);
+        actor->topic = topic;
+    }
+    sup->do_process();
+
+    auto messages = std::max(scale / width, std::size_t{1});
+    stopwatch_t watch;
+    for (std::size_t i = 0; i < messages; ++i) {
+        sup->put(r::make_message<sample_t>(topic));
+        sup->do_process();
+    }
+    auto result = watch.result("deliveries", messages * width);
+
+    finish(*sup);
+    return result;
+}
+
+struct server_t : public r::actor_base_t {
+    using r::actor_base_t::actor_base_t;
+
+    void init_start() noexcept override {
+        subscribe(&server_t::on_request);
+        r::actor_base_t::init_start();
+    }
+
+    void on_request(request_t &req) noexcept { reply_to(req, req.payload.request_payload.value + 1); }
+};
+
+struct client_t : public r::actor_base_t {
+    using r::actor_base_t::actor_base_t;
+
+    void init_start() noexcept override {
+        subscribe(&client_t::on_response);
+        r::actor_base_t::init_start();
+    }
+
+    void make_request() noexcept {
+        if (latency) {
+            latency->begin();
+        }
+        request<sample_req_t>(server_addr, requests_left).send(timeout);
+    }
+
+    void on_response(response_t &res) noexcept {
+        if (latency) {
+            latency->end();
+        }
+        if (!res.payload.ec && --requests_left) {
+            make_request();
+        }
+    }
+
+    std::size_t requests_left = 0;
+    r::address_ptr_t server_addr;
+    latency_recorder_t *latency = nullptr;
+};
+
+/* the response is not copied, but it still makes two queue hops: to the imaginary
+ * address of the client, and then, re-targeted, to the client itself */
+result_t request_response(std::size_t scale, bool with_latency) {
+    r::system_context_t ctx;
+    auto sup = make_supervisor(ctx);
+    auto server = sup->create_actor<server_t>(timeout);
+    auto client = sup->create_actor<client_t>(timeout);
+    client->server_addr = server->get_address();
+    sup->do_process();
+
+    auto requests = std::max(scale / 4, std::size_t{1});
+    latency_recorder_t latency;
+    if (with_latency) {
+        latency.samples.reserve(requests);
+        client->latency = &latency;
+    }
+    client->requests_left = requests;
+    stopwatch_t watch;
+    client->make_request();
+    sup->do_process();
+    auto result = watch.result("requests", requests);
+    result.latencies = std::move(latency.samples);
+
+    finish(*sup);
+    return result;
+}
+
+/* the requests are passed to the server via proxy, which forwards them as is */
+struct proxy_t : public r::actor_base_t {
+    using r::actor_base_t::actor_base_t;
+
+    void init_start() noexcept override {
+        subscribe(&proxy_t::on_request);
+        r::actor_base_t::init_start();
+    }
+
+    void on_request(request_t &req) noexcept { forward_request(req, server_addr); }
+
+    r::address_ptr_t server_addr;
+};
+
+result_t request_proxy(std::size_t scale) {
+    r::system_context_t ctx;
+    auto sup = make_supervisor(ctx);
+    auto server = sup->create_actor<server_t>(timeout);
+    auto proxy = sup->create_actor<proxy_t>(timeout);
+    auto client = sup->create_actor<client_t>(timeout);
+    proxy->server_addr = server->get_address();
+    client->server_addr = proxy->get_address();
+    sup->do_process();
+
+    auto requests = std::max(scale / 4, std::size_t{1});
+    client->requests_left = requests;
+    stopwatch_t watch;
+    client->make_request();
+    sup->do_process();
+    auto result = watch.result("requests", requests);
+
+    finish(*sup);
+    return result;
+}
+
+struct idle_actor_t : public r::actor_base_t {
+    using r::actor_base_t::actor_base_t;
+};
+
+result_t actor_lifetime(std::size_t scale) {
+    r::system_context_t ctx;
+    auto sup = make_supervisor(ctx);
+
+    auto actors = std::max(scale / 100, std::size_t{1});
+    stopwatch_t watch;
+    for (std::size_t i = 0; i < actors; ++i) {
+        auto actor = sup->create_actor<idle_actor_t>(timeout);
+        sup->do_process();
+        actor->do_shutdown();
+        sup->do_process();
+    }
+    auto result = watch.result("actors", actors);
+
+    finish(*sup);
+    return result;
+}
+
+struct churner_t : public r::actor_base_t {
+    using r::actor_base_t::actor_base_t;
+
+    void on_sample(r::message_t<sample_t> &) noexcept {}
+};
+
+result_t subscription_churn(std::size_t scale) {
+    r::system_context_t ctx;
+    auto sup = make_supervisor(ctx);
+    auto actor = sup->create_actor<churner_t>(timeout);
+    auto topic = sup->make_address();
+    sup->do_process();
+
+    auto cycles = std::max(scale / 10, std::size_t{1});
+    stopwatch_t watch;
+    for (std::size_t i = 0; i < cycles; ++i) {
+        actor->subscribe(&churner_t::on_sample, topic);
+        sup->do_process();
+        actor->unsubscribe(&churner_t::on_sample, topic);
+        sup->do_process();
+    }
+    auto result = watch.result("cycles", cycles);
+
+    finish(*sup);
+    return result;
+}
+
+} // namespace
+
+namespace rotor_bench {
+
+void add_core(suite_t &suite) {
+    suite.add("core/ping-pong", ping_pong);
+    for (std::size_t width : {1, 8, 64}) {
+        suite.add("core/pub-sub/fanout-" + std::to_string(width),
+                  [width](std::size_t scale) { return pub_sub(scale, width); });
+    }
+    suite.add("core/request-response", [](std::size_t scale) { return request_response(scale, false); });
+    suite.add("core/request-latency", [](std::size_t scale) { return request_response(scale, true); });
+    suite.add("core/request-proxy", request_proxy);
+    suite.add("core/actor-create-teardown", actor_lifetime);
+    suite.add("core/subscribe-unsubscribe", subscription_churn);
+}
+
+} // namespace rotor_bench
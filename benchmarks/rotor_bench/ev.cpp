@@ -0,0 +1,101 @@
+//
+// Copyright (c) 2019-2020 Ivan Baidakou (basiliscos) (the dot dmol at gmail dot com)
+//
+// Distributed under the MIT Software License
+//
+
+#include "bench.h"
+#include "rotor.hpp"
+#include "rotor/ev.hpp"
+#include <thread>
+
+namespace r = rotor;
+namespace re = rotor::ev;
+using namespace rotor_bench;
+
+namespace {
+
+struct ping_t {};
+struct pong_t {};
+
+const auto timeout = r::pt::milliseconds{500};
+
+struct pinger_t : public r::actor_base_t {
+    using r::actor_base_t::actor_base_t;
+
+    void init_start() noexcept override {
+        subscribe(&pinger_t::on_pong);
+        r::actor_base_t::init_start();
+    }
+
+    void on_start(r::message_t<r::payload::start_actor_t> &msg) noexcept override {
+        r::actor_base_t::on_start(msg);
+        start = bench_clock_t::now();
+        send<ping_t>(ponger_addr);
+    }
+
+    void on_pong(r::message_t<pong_t> &) noexcept {
+        if (--pings_left) {
+            send<ping_t>(ponger_addr);
+        } else {
+            finish = bench_clock_t::now();
+            supervisor.shutdown();
+            ponger_addr->supervisor.shutdown();
+        }
+    }
+
+    std::size_t pings_left = 0;
+    r::address_ptr_t ponger_addr;
+    bench_clock_t::time_point start;
+    bench_clock_t::time_point finish;
+};
+
+struct ponger_t : public r::actor_base_t {
+    using r::actor_base_t::actor_base_t;
+
+    void init_start() noexcept override {
+        subscribe(&ponger_t::on_ping);
+        r::actor_base_t::init_start();
+    }
+
+    void on_ping(r::message_t<ping_t> &) noexcept { send<pong_t>(pinger_addr); }
+
+    r::address_ptr_t pinger_addr;
+};
+
+result_t ping_pong_threads(std::size_t scale) {
+    auto sys_ctx1 = re::system_context_ev_t::ptr_t{new re::system_context_ev_t()};
+    auto sys_ctx2 = re::system_context_ev_t::ptr_t{new re::system_context_ev_t()};
+    re::supervisor_config_ev_t conf1{timeout, ev_loop_new(0), true};
+    re::supervisor_config_ev_t conf2{timeout, ev_loop_new(0), true};
+    auto sup1 = sys_ctx1->create_supervisor<re::supervisor_ev_t>(conf1);
+    auto sup2 = sys_ctx2->create_supervisor<re::supervisor_ev_t>(conf2);
+
+    auto round_trips = std::max(scale / 20, std::size_t{1});
+    auto pinger = sup1->create_actor<pinger_t>(timeout);
+    auto ponger = sup2->create_actor<ponger_t>(timeout);
+    pinger->pings_left = round_trips;
+    pinger->ponger_addr = ponger->get_address();
+    ponger->pinger_addr = pinger->get_address();
+
+    // the loops are not running yet, so it is safe to initialize in the main thread;
+    // the ponger have to be ready before the first ping
+    sup2->do_process();
+    sup1->do_process();
+
+    auto t1 = std::thread([&] { ev_run(conf1.loop); });
+    auto t2 = std::thread([&] { ev_run(conf2.loop); });
+    t1.join();
+    t2.join();
+
+    std::chrono::duration<double> diff = pinger->finish - pinger->start;
+    return result_t{"messages", round_trips * 2, diff.count()};
+}
+
+} // namespace
+
+namespace rotor_bench {
+
+void add_ev(suite_t &suite) { suite.add("ev/ping-pong-2-threads", ping_pong_threads); }
+
+} // namespace rotor_bench
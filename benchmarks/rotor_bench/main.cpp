@@ -0,0 +1,167 @@
+//
+// Copyright (c) 2019-2020 Ivan Baidakou (basiliscos) (the dot dmol at gmail dot com)
+//
+// Distributed under the MIT Software License
+//
+
+/*
+    Benchmark suite of core messaging paths. The results are written as JSON
+    (to stdout or to the file), the human-readable summary goes to stderr.
+
+    Usage: rotor_bench [--filter=substring] [--scale=N] [--out=file.json] [--list]
+*/
+
+#include "bench.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+
+using namespace rotor_bench;
+
+namespace {
+
+const char *refcount_mode() {
+#if defined(ROTOR_REFCOUNT_THREADUNSAFE)
+    return "thread-unsafe";
+#elif defined(ROTOR_REFCOUNT_HYBRID)
+    return "hybrid";
+#else
+    return "atomic";
+#endif
+}
+
+struct options_t {
+    std::string filter;
+    std::size_t scale = 1000000;
+    std::string out;
+    bool list = false;
+};
+
+/* accepts positive decimal integers only, i.e. "0", "0.05" or "1e6" are rejected */
+bool parse_scale(const char *value, std::size_t &scale) {
+    std::size_t result = 0;
+    const char *c = value;
+    for (; *c >= '0' && *c <= '9'; ++c) {
+        auto digit = static_cast<std::size_t>(*c - '0');
+        if (result > (std::numeric_limits<std::size_t>::max() - digit) / 10) {
+            return false;
+        }
+        result = result * 10 + digit;
+    }
+    if (c == value || *c || !result) {
+        return false;
+    }
+    scale = result;
+    return true;
+}
+
+bool parse(int argc, char **argv, options_t &opts) {
+    auto usage = [&]() {
+        std::cerr << "usage: " << argv[0] << " [--filter=substring] [--scale=N] [--out=file.json] [--list]\n";
+    };
+    for (int i = 1; i < argc; ++i) {
+        std::string arg(argv[i]);
+        auto value = [&](const char *prefix) -> const char * {
+            std::string p(prefix);
+            return arg.compare(0, p.size(), p) == 0 ? argv[i] + p.size() : nullptr;
+        };
+        if (auto v = value("--filter=")) {
+            opts.filter = v;
+        } else if (auto v = value("--scale=")) {
+            if (!parse_scale(v, opts.scale)) {
+                std::cerr << "invalid scale: " << v << ", a positive integer is expected\n";
+                usage();
+                return false;
+            }
+        } else if (auto v = value("--out=")) {
+            opts.out = v;
+        } else if (arg == "--list") {
+            opts.list = true;
+        } else {
+            std::cerr << "unknown argument: " << arg << "\n";
+            usage();
+            return false;
+        }
+    }
+    return true;
+}
+
+/* returns the sample of the given rank (0..1) in nanoseconds; the samples are sorted */
+double percentile(const std::vector<double> &samples, double rank) {
+    auto index = static_cast<std::size_t>(rank * (samples.size() - 1));
+    return samples[index] * 1e9;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    options_t opts;
+    if (!parse(argc, argv, opts)) {
+        return 1;
+    }
+
+    suite_t suite;
+    add_core(suite);
+#ifdef ROTOR_BENCH_ASIO
+    add_asio(suite);
+#endif
+#ifdef ROTOR_BENCH_EV
+    add_ev(suite);
+#endif
+#ifdef ROTOR_BENCH_POOL
+    add_pool(suite);
+#endif
+#ifdef ROTOR_BENCH_SHARD
+    add_shard(suite);
+#endif
+
+    if (opts.list) {
+        for (auto &entry : suite.entries) {
+            std::cout << entry.name << "\n";
+        }
+        return 0;
+    }
+
+    std::stringstream json;
+    json << "{\n  \"context\": {\"refcount\": \"" << refcount_mode() << "\", \"scale\": " << opts.scale
+         << "},\n  \"benchmarks\": [";
+    bool first = true;
+    for (auto &entry : suite.entries) {
+        if (entry.name.find(opts.filter) == std::string::npos) {
+            continue;
+        }
+        auto r = entry.scenario(opts.scale);
+        auto rate = r.seconds > 0 ? r.count / r.seconds : 0.0;
+        std::cerr << entry.name << ": " << r.count << " " << r.unit << " in " << r.seconds << "s, " << rate << " "
+                  << r.unit << "/s\n";
+        json << (first ? "\n" : ",\n") << "    {\"name\": \"" << entry.name << "\", \"unit\": \"" << r.unit
+             << "\", \"count\": " << r.count << ", \"seconds\": " << r.seconds << ", \"rate\": " << rate;
+        if (!r.latencies.empty()) {
+            auto &samples = r.latencies;
+            std::sort(samples.begin(), samples.end());
+            auto p50 = percentile(samples, 0.5);
+            auto p99 = percentile(samples, 0.99);
+            auto max = percentile(samples, 1.0);
+            std::cerr << "    latency, ns: p50 = " << p50 << ", p99 = " << p99 << ", max = " << max << "\n";
+            json << ", \"latency_ns\": {\"p50\": " << p50 << ", \"p99\": " << p99 << ", \"max\": " << max << "}";
+        }
+        json << "}";
+        first = false;
+    }
+    json << "\n  ]\n}\n";
+
+    if (opts.out.empty()) {
+        std::cout << json.str();
+    } else {
+        std::ofstream out(opts.out);
+        out << json.str();
+        if (!out) {
+            std::cerr << "cannot write " << opts.out << "\n";
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,138 @@
+//
+// Copyright (c) 2019-2020 Ivan Baidakou (basiliscos) (the dot dmol at gmail dot com)
+//
+// Distributed under the MIT Software License
+//
+
+#include "bench.h"
+#include "rotor.hpp"
+#include "rotor/pool.hpp"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace r = rotor;
+namespace rp = rotor::pool;
+using namespace rotor_bench;
+
+namespace {
+
+struct hello_t {};
+struct ping_t {};
+struct pong_t {};
+
+const auto timeout = r::pt::milliseconds{500};
+
+/* the amount of ping-pong pairs is fixed, so that the same work is spread over more threads */
+const std::size_t pairs = 32;
+
+struct shared_t {
+    std::atomic<std::size_t> finished{0};
+    r::supervisor_t *root = nullptr;
+    bench_clock_t::time_point finish;
+};
+
+struct ponger_t : public r::actor_base_t {
+    using r::actor_base_t::actor_base_t;
+
+    void init_start() noexcept override {
+        subscribe(&ponger_t::on_hello);
+        subscribe(&ponger_t::on_ping);
+        r::actor_base_t::init_start();
+    }
+
+    void on_start(r::message_t<r::payload::start_actor_t> &msg) noexcept override {
+        r::actor_base_t::on_start(msg);
+        send<hello_t>(pinger_addr);
+    }
+
+    void on_hello(r::message_t<hello_t> &) noexcept { send<hello_t>(pinger_addr); }
+
+    void on_ping(r::message_t<ping_t> &) noexcept { send<pong_t>(pinger_addr); }
+
+    r::address_ptr_t pinger_addr;
+};
+
+/* whoever starts later, greets the other one; the pinger starts on the first greeting */
+struct pinger_t : public r::actor_base_t {
+    using r::actor_base_t::actor_base_t;
+
+    void init_start() noexcept override {
+        subscribe(&pinger_t::on_hello);
+        subscribe(&pinger_t::on_pong);
+        r::actor_base_t::init_start();
+    }
+
+    void on_start(r::message_t<r::payload::start_actor_t> &msg) noexcept override {
+        r::actor_base_t::on_start(msg);
+        send<hello_t>(ponger_addr);
+    }
+
+    void on_hello(r::message_t<hello_t> &) noexcept {
+        if (!pinging) {
+            pinging = true;
+            send<ping_t>(ponger_addr);
+        }
+    }
+
+    void on_pong(r::message_t<pong_t> &) noexcept {
+        if (--pings_left) {
+            send<ping_t>(ponger_addr);
+        } else if (++shared->finished == pairs) {
+            shared->finish = bench_clock_t::now();
+            shared->root->shutdown();
+        }
+    }
+
+    std::size_t pings_left = 0;
+    bool pinging = false;
+    r::address_ptr_t ponger_addr;
+    shared_t *shared = nullptr;
+};
+
+/* each actor is in its own locality, i.e. each message crosses the localities */
+result_t ping_pong_scaling(std::size_t scale, std::size_t threads) {
+    auto sys_ctx = rp::system_context_pool_t::ptr_t{new rp::system_context_pool_t(threads)};
+    rp::supervisor_config_pool_t conf{timeout};
+    auto root = sys_ctx->create_supervisor<rp::supervisor_pool_t>(conf);
+
+    shared_t shared;
+    shared.root = root.get();
+    auto round_trips = std::max(scale / 20 / pairs, std::size_t{1});
+    for (std::size_t i = 0; i < pairs; ++i) {
+        auto sup1 = root->create_actor<rp::supervisor_pool_t>(timeout, conf);
+        auto sup2 = root->create_actor<rp::supervisor_pool_t>(timeout, conf);
+        auto pinger = sup1->create_actor<pinger_t>(timeout);
+        auto ponger = sup2->create_actor<ponger_t>(timeout);
+        pinger->pings_left = round_trips;
+        pinger->ponger_addr = ponger->get_address();
+        pinger->shared = &shared;
+        ponger->pinger_addr = pinger->get_address();
+    }
+
+    // the start-up of the localities is included, as it is spread over the threads too
+    stopwatch_t stopwatch;
+    root->start();
+    sys_ctx->run();
+    std::chrono::duration<double> diff = shared.finish - stopwatch.start;
+    return result_t{"messages", round_trips * 2 * pairs, diff.count()};
+}
+
+} // namespace
+
+namespace rotor_bench {
+
+void add_pool(suite_t &suite) {
+    std::size_t cores = std::max(std::thread::hardware_concurrency(), 1u);
+    // 1, 2, 4 ... threads up to the amount of cores
+    for (std::size_t threads = 1;; threads *= 2) {
+        auto n = std::min(threads, cores);
+        suite.add("pool/scaling-" + std::to_string(n),
+                  [n](std::size_t scale) { return ping_pong_scaling(scale, n); });
+        if (n == cores) {
+            break;
+        }
+    }
+}
+
+} // namespace rotor_bench
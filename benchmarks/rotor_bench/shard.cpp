@@ -0,0 +1,99 @@
+//
+// Copyright (c) 2019-2020 Ivan Baidakou (basiliscos) (the dot dmol at gmail dot com)
+//
+// Distributed under the MIT Software License
+//
+
+#include "bench.h"
+#include "rotor.hpp"
+#include "rotor/shard.hpp"
+
+namespace r = rotor;
+namespace rs = rotor::shard;
+using namespace rotor_bench;
+
+namespace {
+
+struct ping_t {};
+struct pong_t {};
+
+const auto timeout = r::pt::milliseconds{500};
+
+struct pinger_t : public r::actor_base_t {
+    using r::actor_base_t::actor_base_t;
+
+    void init_start() noexcept override {
+        subscribe(&pinger_t::on_pong);
+        r::actor_base_t::init_start();
+    }
+
+    void on_start(r::message_t<r::payload::start_actor_t> &msg) noexcept override {
+        r::actor_base_t::on_start(msg);
+        start = bench_clock_t::now();
+        send<ping_t>(ponger_addr);
+    }
+
+    void on_pong(r::message_t<pong_t> &) noexcept {
+        if (--pings_left) {
+            send<ping_t>(ponger_addr);
+        } else {
+            finish = bench_clock_t::now();
+            supervisor.shutdown();
+            ponger_addr->supervisor.shutdown();
+        }
+    }
+
+    std::size_t pings_left = 0;
+    r::address_ptr_t ponger_addr;
+    bench_clock_t::time_point start;
+    bench_clock_t::time_point finish;
+};
+
+struct ponger_t : public r::actor_base_t {
+    using r::actor_base_t::actor_base_t;
+
+    void init_start() noexcept override {
+        subscribe(&ponger_t::on_ping);
+        r::actor_base_t::init_start();
+    }
+
+    void on_ping(r::message_t<ping_t> &) noexcept { send<pong_t>(pinger_addr); }
+
+    r::address_ptr_t pinger_addr;
+};
+
+/* the same as "asio/ping-pong-2-threads", but the threads are the shards connected by the rings */
+result_t ping_pong_shards(std::size_t scale, std::size_t idle_spins) {
+    auto sys_ctx = rs::system_context_shard_t::ptr_t{new rs::system_context_shard_t(2, 1024, idle_spins)};
+    auto sup1 = sys_ctx->create_supervisor<rs::supervisor_shard_t>(rs::supervisor_config_shard_t{timeout, 0});
+    auto sup2 = sys_ctx->create_supervisor<rs::supervisor_shard_t>(rs::supervisor_config_shard_t{timeout, 1});
+
+    auto round_trips = std::max(scale / 20, std::size_t{1});
+    auto pinger = sup1->create_actor<pinger_t>(timeout);
+    auto ponger = sup2->create_actor<ponger_t>(timeout);
+    pinger->pings_left = round_trips;
+    pinger->ponger_addr = ponger->get_address();
+    ponger->pinger_addr = pinger->get_address();
+
+    // the threads are not started yet, so it is safe to initialize in the main thread;
+    // the ponger have to be ready before the first ping
+    sup2->do_process();
+    sup1->do_process();
+    sys_ctx->run();
+
+    std::chrono::duration<double> diff = pinger->finish - pinger->start;
+    return result_t{"messages", round_trips * 2, diff.count()};
+}
+
+} // namespace
+
+namespace rotor_bench {
+
+void add_shard(suite_t &suite) {
+    suite.add("shard/ping-pong-2-threads", [](std::size_t scale) { return ping_pong_shards(scale, 10000); });
+    suite.add("shard/ping-pong-2-threads-spin", [](std::size_t scale) {
+        return ping_pong_shards(scale, rs::system_context_shard_t::never_park);
+    });
+}
+
+} // namespace rotor_bench
@@ -0,0 +1,87 @@
+//
+// Copyright (c) 2019-2020 Ivan Baidakou (basiliscos) (the dot dmol at gmail dot com)
+//
+// Distributed under the MIT Software License
+//
+
+/*
+    Measures local message dispatching (lookup of recipients by destination
+    address and message type) with different amount of subscriptions.
+
+    Usage: subscription-dispatch [messages]
+*/
+
+#include "rotor.hpp"
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+struct sample_t {};
+
+struct sink_t : public rotor::actor_base_t {
+    using rotor::actor_base_t::actor_base_t;
+
+    void on_sample(rotor::message_t<sample_t> &) noexcept { ++received; }
+
+    std::size_t received = 0;
+};
+
+struct dummy_supervisor : public rotor::supervisor_t {
+    using rotor::supervisor_t::supervisor_t;
+
+    void start_timer(const rotor::pt::time_duration &, timer_id_t) noexcept override {}
+    void cancel_timer(timer_id_t) noexcept override {}
+    void start() noexcept override {}
+    void shutdown() noexcept override {}
+    void enqueue(rotor::message_ptr_t) noexcept override {}
+};
+
+static void measure(std::size_t subscriptions, std::size_t messages) {
+    rotor::system_context_t ctx{};
+    auto timeout = boost::posix_time::milliseconds{500}; /* does not matter */
+    rotor::supervisor_config_t cfg{timeout};
+    auto sup = ctx.create_supervisor<dummy_supervisor>(nullptr, cfg);
+    auto sink = sup->create_actor<sink_t>(timeout);
+    sup->do_process();
+
+    std::vector<rotor::address_ptr_t> addresses;
+    addresses.reserve(subscriptions);
+    for (std::size_t i = 0; i < subscriptions; ++i) {
+        auto addr = sup->make_address();
+        sink->subscribe(&sink_t::on_sample, addr);
+        addresses.emplace_back(std::move(addr));
+    }
+    sup->do_process();
+
+    std::mt19937 gen(subscriptions);
+    std::uniform_int_distribution<std::size_t> distr(0, subscriptions - 1);
+    std::vector<rotor::message_ptr_t> batch;
+    batch.reserve(messages);
+    for (std::size_t i = 0; i < messages; ++i) {
+        batch.emplace_back(rotor::make_message<sample_t>(addresses[distr(gen)]));
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (auto &message : batch) {
+        sup->put(std::move(message));
+    }
+    sup->do_process();
+    auto end = std::chrono::high_resolution_clock::now();
+
+    std::chrono::duration<double> diff = end - start;
+    std::cout << subscriptions << " subscriptions: " << sink->received << " messages in " << diff.count() << "s, "
+              << (messages / diff.count()) << " messages/s\n";
+
+    sup->do_shutdown();
+    sup->do_process();
+}
+
+int main(int argc, char **argv) {
+    std::size_t messages = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    for (std::size_t subscriptions : {10, 1000, 100000}) {
+        measure(subscriptions, messages);
+    }
+    return 0;
+}
@@ -33,7 +33,9 @@ capable to serve can be handled, i.e. via queueing.
 
 3.2. If the pool size and client's simultaneous requests are uncoordinated, then http-manager
 can queue requests. However, some *back-pressure* mechanisms should be imposed into http-manager
-to prevent the queue to grow infinitely.
+to prevent the queue to grow infinitely. The generic `rotor::router_t` does that (bounded
+queue, `request_rejected` error above the limit) as well as the free-worker bookkeeping,
+which is done manually here for illustration purposes.
 
 3.3. The http-requests are stateless (i.e. no http/1.1). This cannot be improved whitout
 internal protocol change, as the socket should not be closed, the same http-client
@@ -59,6 +61,9 @@ is how reliable do you treat your actors. If they are unreliable (i.e. might hav
 bugs etc.), then there should be 2 timers. On the later stage of the development,
 it might be switched to one timer per request if reliability has been proven
 and it is desirable to get rid of additional timer from performance point of view.
+The manager's request inherits the deadline of the client's one (`send_within`),
+i.e. the 2nd timer does not outlive the 1st one and does not need the separate
+timeout value.
 
 6. There should be no crashes, no memory leaks
 
@@ -333,7 +338,7 @@ struct http_manager_t : public ra::supervisor_asio_t {
         auto worker_addr = *it;
         workers.erase(it);
         auto &payload = req.payload.request_payload;
-        auto request_id = request<payload::http_request_t>(worker_addr, payload).send(payload.timeout);
+        auto request_id = request<payload::http_request_t>(worker_addr, payload).send_within(req.payload);
         req_mapping.emplace(request_id, &req);
     }
 
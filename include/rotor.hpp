@@ -11,9 +11,11 @@
  */
 
 #include "rotor/actor_base.h"
+#include "rotor/credit.hpp"
 #include "rotor/address.hpp"
 #include "rotor/message.h"
 #include "rotor/registry.h"
+#include "rotor/router.hpp"
 #include "rotor/supervisor.h"
 #include "rotor/system_context.h"
 
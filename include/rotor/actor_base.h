@@ -192,12 +192,56 @@ struct actor_base_t : public arc_base_t<actor_base_t> {
     request_builder_t<typename request_wrapper_t<R>::request_t>
     request_via(const address_ptr_t &dest_addr, const address_ptr_t &reply_addr, Args &&... args);
 
+    /** \brief returns scatter-gather request builder, the aggregate will be delivered to
+     * the "main" actor address
+     *
+     * The requests are added via `request` method of {@link gather_builder_t}, and
+     * are not actually sent, until its `send` method will be invoked.
+     *
+     */
+    template <typename R> gather_builder_t<typename request_wrapper_t<R>::request_t> gather();
+
+    /** \brief cancels the request, previously sent by the actor
+     *
+     * The timeout timer of the request is cancelled, and the error response with
+     * `request_cancelled` code is delivered to the reply address instead of
+     * the regular response, which is silently dropped, if it will arrive later.
+     * The {@link payload::cancel_request_t} notice is sent to the destination address
+     * of the request.
+     *
+     * For scatter-gather request, the aggregate with `request_cancelled` code is delivered,
+     * and the notice is sent to each destination, which has not replied yet.
+     *
+     * Returns `false` if the request is not in progress any longer (i.e. the
+     * response has been already delivered).
+     *
+     */
+    bool cancel_request(request_id_t request_id) noexcept;
+
     /** \brief convenient method for constructing and sending response to a request
      *
      * `args` are forwarded to response payload constuction
      */
     template <typename Request, typename... Args> void reply_to(Request &message, Args &&... args);
 
+    /** \brief forwards the request to other destination as is, i.e. without copying it
+     *
+     * The request message is re-targeted to the `destination` address and sent again,
+     * while its request id, reply address and deadline are kept, so the response of the
+     * destination is delivered directly to the original requester, and the timeout
+     * is still guarded by the requester's supervisor. The forwarding actor does not
+     * participate in the request any longer.
+     *
+     * As the original message is modified, it is forwarded only if nobody else can
+     * observe it, i.e. the actor is the single subscriber to the request on its address,
+     * the actor belongs to the locality of the address, and the message is not
+     * held by anyone except the current delivery and the requester's pending request
+     * record. Otherwise nothing is done and `false` is returned, so the request has to
+     * be served (or replied with error) by the actor itself.
+     *
+     */
+    template <typename Request> bool forward_request(Request &message, const address_ptr_t &destination);
+
     /** \brief convenient method for constructing and sending error response to a request */
     template <typename Request, typename... Args> void reply_with_error(Request &message, const std::error_code &ec);
 
@@ -294,6 +338,7 @@ struct actor_base_t : public arc_base_t<actor_base_t> {
     friend struct actor_behavior_t;
     friend struct supervisor_t;
     template <typename T> friend struct request_builder_t;
+    template <typename T> friend struct gather_builder_t;
 };
 
 /** \brief intrusive pointer for actor*/
@@ -8,6 +8,7 @@
 
 #include "arc.hpp"
 #include "actor_base.h"
+#include "message.h"
 #include <unordered_map>
 #include <vector>
 
@@ -42,11 +43,11 @@ struct address_mapping_t {
      * supervisor's address.
      *
      */
-    void set(actor_base_t &actor, const void *message, const handler_ptr_t &handler,
+    void set(actor_base_t &actor, message_type_t message, const handler_ptr_t &handler,
              const address_ptr_t &dest_addr) noexcept;
 
     /** \brief returns temporal destination address for the actor/message type */
-    address_ptr_t get_addr(actor_base_t &actor, const void *message) noexcept;
+    address_ptr_t get_addr(actor_base_t &actor, message_type_t message) noexcept;
 
     /** \brief returns all subscription points for the actor
      *
@@ -57,7 +58,7 @@ struct address_mapping_t {
     points_t destructive_get(actor_base_t &actor) noexcept;
 
   private:
-    using point_map_t = std::unordered_map<const void *, point_t>;
+    using point_map_t = std::unordered_map<message_type_t, point_t>;
     using actor_map_t = std::unordered_map<const void *, point_map_t>;
     actor_map_t actor_map;
 };
@@ -8,6 +8,7 @@
 
 #include <boost/intrusive_ptr.hpp>
 #include <boost/smart_ptr/intrusive_ref_counter.hpp>
+#include <atomic>
 
 namespace rotor {
 
@@ -25,4 +26,70 @@ template <typename T> using arc_base_t = boost::intrusive_ref_counter<T, counter
 /** \brief alias for intrusive pointer */
 template <typename T> using intrusive_ptr_t = boost::intrusive_ptr<T>;
 
+/** \struct hybrid_arc_base_t
+ *  \brief base class to inject ref-counter, which is non-atomic until the object is shared
+ *
+ * While an object is used only by a single thread (i.e. within single locality),
+ * its ref-counter is modified via plain (non-RMW) loads and stores. Once `share`
+ * is invoked, all further modifications are atomic.
+ *
+ * The `share` must be invoked by the owning thread *before* the object
+ * is handed over to other thread; the hand-over itself must synchronize
+ * the threads (e.g. by lock-free queue with release/acquire semantics).
+ *
+ */
+template <typename T> class hybrid_arc_base_t {
+  public:
+    /** \brief constructs object with zero ref-counter in non-shared mode */
+    hybrid_arc_base_t() noexcept : counter{0}, shared{false} {}
+
+    /** \brief copy constructor, the ref-counter is not copied */
+    hybrid_arc_base_t(const hybrid_arc_base_t &) noexcept : counter{0}, shared{false} {}
+
+    /** \brief assignment, the ref-counter is not modified */
+    hybrid_arc_base_t &operator=(const hybrid_arc_base_t &) noexcept { return *this; }
+
+    /** \brief returns the ref-counter value */
+    unsigned int use_count() const noexcept { return counter.load(std::memory_order_relaxed); }
+
+    /** \brief switches ref-counter into atomic mode (irreversible) */
+    void share() const noexcept { shared.store(true, std::memory_order_relaxed); }
+
+    /** \brief returns `true` if the ref-counter is in atomic mode */
+    bool is_shared() const noexcept { return shared.load(std::memory_order_relaxed); }
+
+  protected:
+    ~hybrid_arc_base_t() = default;
+
+  private:
+    mutable std::atomic<unsigned int> counter;
+    mutable std::atomic_bool shared;
+
+    template <typename U> friend void intrusive_ptr_add_ref(const hybrid_arc_base_t<U> *p) noexcept;
+    template <typename U> friend void intrusive_ptr_release(const hybrid_arc_base_t<U> *p) noexcept;
+};
+
+/** \brief increments ref-counter of the object (intrusive_ptr support) */
+template <typename T> inline void intrusive_ptr_add_ref(const hybrid_arc_base_t<T> *p) noexcept {
+    if (p->shared.load(std::memory_order_relaxed)) {
+        p->counter.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        p->counter.store(p->counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+}
+
+/** \brief decrements ref-counter of the object and destroys it, if it is no longer referenced */
+template <typename T> inline void intrusive_ptr_release(const hybrid_arc_base_t<T> *p) noexcept {
+    unsigned int left;
+    if (p->shared.load(std::memory_order_relaxed)) {
+        left = p->counter.fetch_sub(1, std::memory_order_acq_rel) - 1;
+    } else {
+        left = p->counter.load(std::memory_order_relaxed) - 1;
+        p->counter.store(left, std::memory_order_relaxed);
+    }
+    if (!left) {
+        delete static_cast<const T *>(p);
+    }
+}
+
 } // namespace rotor
@@ -7,6 +7,7 @@
 //
 
 #include "rotor/supervisor.h"
+#include "rotor/mpsc_queue.hpp"
 #include "supervisor_config_asio.h"
 #include "system_context_asio.h"
 #include "forwarder.hpp"
@@ -46,27 +47,19 @@ template <typename Actor, typename Handler, typename ArgsCount, typename ErrHand
  * handler, the change should be performed in synchronized way, i.e.
  * via `strand`.
  *
+ * Messages from other threads are accumulated in the lock-free inbound
+ * queue of the locality leader; only the first message into the empty queue
+ * schedules (defers) the drain on the `strand`, which moves the whole batch
+ * into the leader's queue and processes it at once.
+ *
+ * When the processing budget (see `supervisor_config_t::process_budget`) is
+ * exhausted, the rest of the messages is processed in the handler posted to
+ * the `strand`, i.e. the other ready handlers (I/O completions, timers) are
+ * not starved by message storms.
+ *
  */
 struct supervisor_asio_t : public supervisor_t {
 
-    /** \struct timer_t
-     * \brief boos::asio::deadline_timer with timer identity  */
-    struct timer_t : public asio::deadline_timer {
-
-        /** \brief timer identity */
-        timer_id_t timer_id;
-
-        /** \brief constructs timer using timer_id and boos asio io_context */
-        timer_t(timer_id_t timer_id_, asio::io_context &io_context)
-            : asio::deadline_timer(io_context), timer_id{timer_id_} {}
-    };
-
-    /** \brief unique pointer to timer */
-    using timer_ptr_t = std::unique_ptr<timer_t>;
-
-    /** \brief timer id to timer pointer mapping type */
-    using timers_map_t = std::unordered_map<std::uint32_t, timer_ptr_t>;
-
     /** \brief constructs new supervisor from parent supervisor, intrusive
      * pointer to system context and supervisor config and
 
@@ -80,11 +73,9 @@ struct supervisor_asio_t : public supervisor_t {
     virtual void start() noexcept override;
     virtual void shutdown() noexcept override;
     virtual void enqueue(message_ptr_t message) noexcept override;
-    virtual void start_timer(const pt::time_duration &send, timer_id_t timer_id) noexcept override;
-    virtual void cancel_timer(timer_id_t timer_id) noexcept override;
 
-    /** \brief callback when an error happen on the timer, identified by timer_id */
-    virtual void on_timer_error(timer_id_t timer_id, const sys::error_code &ec) noexcept;
+    /** \brief callback when an error happen on the supervisor's timer */
+    virtual void on_timer_error(const sys::error_code &ec) noexcept;
 
     /** \brief creates an actor by forwaring `args` to it
      *
@@ -117,11 +108,24 @@ struct supervisor_asio_t : public supervisor_t {
     /** \brief returns exeuction strand */
     inline asio::io_context::strand &get_strand() noexcept { return *strand; }
 
-    /** \brief timer id to timer pointer mapping */
-    timers_map_t timers_map;
+    /** \brief the single timer, which wakes the supervisor up for its nearest timer deadline */
+    asio::deadline_timer timer;
 
     /** \brief config for the supervisor */
     supervisor_config_asio_t::strand_ptr_t strand;
+
+    /** \brief inbound messages queue, i.e. messages received from other threads,
+     * which are not yet moved into the leader's queue
+     */
+    mpsc_queue_t inbound;
+
+  protected:
+    virtual void arm_timer(const pt::time_duration &delay) noexcept override;
+    virtual void disarm_timer() noexcept override;
+    virtual void defer_process() noexcept override;
+
+    /** \brief whether the `do_process` invocation is already posted to the `strand` */
+    bool process_deferred;
 };
 
 template <typename Actor> inline boost::asio::io_context::strand &get_strand(Actor &actor) {
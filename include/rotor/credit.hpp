@@ -0,0 +1,152 @@
+#pragma once
+
+//
+// Copyright (c) 2019-2020 Ivan Baidakou (basiliscos) (the dot dmol at gmail dot com)
+//
+// Distributed under the MIT Software License
+//
+
+#include "supervisor.h"
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+namespace rotor {
+
+/** \struct credit_sender_t
+ *  \brief the producer side of credit channel: sends messages of type `T` to the
+ *  consumer, as long as the consumer permits that
+ *
+ * The sender starts without credits; each sent message consumes one credit, and
+ * when there are no credits, the message is not sent (it is up to the producer,
+ * whether to postpone the message production or to buffer it). The credits are
+ * granted by the consumer via `message::credit_grant_t`, which is sent to the
+ * producer's main address; the producer actor should subscribe to it and pass
+ * it to `on_grant` of the appropriate sender, and then resume the production.
+ *
+ * As the grants are ordinary messages, the producer and the consumer might
+ * be located on different supervisors, threads and event loops.
+ *
+ */
+template <typename T> struct credit_sender_t {
+    /** \brief constructs the channel from the producer actor to the consumer address */
+    credit_sender_t(actor_base_t &owner_, const address_ptr_t &consumer_) noexcept
+        : owner{owner_}, consumer{consumer_}, credits{0}, sent{0} {}
+
+    /** \brief sends the message to the consumer, if there is at least one credit
+     *
+     * Returns `false` if the message was not sent due to the lack of credits.
+     *
+     */
+    template <typename... Args> bool send(Args &&... args) {
+        if (!credits) {
+            return false;
+        }
+        --credits;
+        ++sent;
+        owner.template send<T>(consumer, std::forward<Args>(args)...);
+        return true;
+    }
+
+    /** \brief adds the granted credits; returns `false` if the grant belongs
+     * to other consumer */
+    bool on_grant(const message::credit_grant_t &message) noexcept {
+        if (message.payload.consumer != consumer) {
+            return false;
+        }
+        credits += message.payload.credits;
+        return true;
+    }
+
+    /** \brief returns the amount of messages, which can be sent right now */
+    inline std::size_t get_credits() const noexcept { return credits; }
+
+    /** \brief returns total amount of sent messages */
+    inline std::size_t get_sent() const noexcept { return sent; }
+
+    /** \brief returns the consumer address */
+    inline const address_ptr_t &get_consumer() const noexcept { return consumer; }
+
+  private:
+    actor_base_t &owner;
+    address_ptr_t consumer;
+    std::size_t credits;
+    std::size_t sent;
+};
+
+/** \struct credit_receiver_t
+ *  \brief the consumer side of credit channel: grants credits to the producer
+ *
+ * The receiver grants the whole `window` upon `open`, and then it grants the
+ * credits back for the processed messages, but not individually: the credits
+ * are accumulated and granted by `batch`es (by default, a half of the window).
+ * Hence, there are no more than `window` messages on the way to the consumer or
+ * waiting for processing, while there is only one control message per `batch`
+ * of the credited messages.
+ *
+ * The consumer actor should `open` the receiver when the producer is already
+ * able to handle the grants (i.e. it has subscribed to `message::credit_grant_t`),
+ * otherwise the initial grant is lost.
+ *
+ */
+struct credit_receiver_t {
+    /** \brief constructs the receiver of the messages from the producer address
+     *
+     * If `batch` is zero, the half of window is used.
+     *
+     */
+    credit_receiver_t(actor_base_t &owner_, const address_ptr_t &producer_, std::size_t window_,
+                      std::size_t batch_ = 0) noexcept
+        : owner{owner_}, producer{producer_}, window{window_},
+          batch{batch_ ? batch_ : std::max(window_ / 2, std::size_t{1})}, pending{0}, grants{0} {
+        assert(window && "credit window should be positive");
+        assert(batch <= window && "credit batch should not exceed the window");
+    }
+
+    /** \brief grants the whole window to the producer */
+    void open() noexcept { grant(window); }
+
+    /** \brief accounts the processed messages, grants the credits back when
+     * the batch is accumulated */
+    void consumed(std::size_t count = 1) noexcept {
+        pending += count;
+        if (pending >= batch) {
+            flush();
+        }
+    }
+
+    /** \brief grants the accumulated credits immediately (if any) */
+    void flush() noexcept {
+        if (pending) {
+            grant(pending);
+            pending = 0;
+        }
+    }
+
+    /** \brief returns the maximum amount of not yet processed messages */
+    inline std::size_t get_window() const noexcept { return window; }
+
+    /** \brief returns the amount of credits, which are granted at once */
+    inline std::size_t get_batch() const noexcept { return batch; }
+
+    /** \brief returns the amount of processed messages, not yet granted back */
+    inline std::size_t get_pending() const noexcept { return pending; }
+
+    /** \brief returns total amount of sent grants */
+    inline std::size_t get_grants() const noexcept { return grants; }
+
+  private:
+    void grant(std::size_t credits) noexcept {
+        ++grants;
+        owner.send<payload::credit_grant_t>(producer, owner.get_address(), credits);
+    }
+
+    actor_base_t &owner;
+    address_ptr_t producer;
+    std::size_t window;
+    std::size_t batch;
+    std::size_t pending;
+    std::size_t grants;
+};
+
+} // namespace rotor
@@ -18,6 +18,8 @@ enum class error_code_t {
     supervisor_defined,
     already_registered,
     unknown_service,
+    request_cancelled,
+    request_rejected,
 };
 
 namespace details {
@@ -7,13 +7,12 @@
 //
 
 #include "rotor/supervisor.h"
+#include "rotor/mpsc_queue.hpp"
 #include "rotor/ev/supervisor_config_ev.h"
 #include "rotor/ev/system_context_ev.h"
 #include "rotor/system_context.h"
 #include <ev.h>
-#include <mutex>
-#include <memory>
-#include <unordered_map>
+#include <atomic>
 
 namespace rotor {
 namespace ev {
@@ -31,20 +30,13 @@ namespace ev {
  * in that case different supervisors, and they will be able to communicate
  * via rotor-messaging.
  *
+ * When the processing budget (see `supervisor_config_t::process_budget`) is
+ * exhausted, the rest of the messages is processed from the `ev_idle` watcher,
+ * i.e. when there are no other pending events in the loop.
+ *
  */
 struct supervisor_ev_t : public supervisor_t {
 
-    /** \struct timer_t
-     * \brief inheritance of ev_timer, which holds rotor `timer_id`
-     */
-    struct timer_t : public ev_timer {
-        /** \brief local timer identifier within the scrope of the supervisor */
-        timer_id_t timer_id;
-    };
-
-    /** \brief an alias for unique pointer, holding `timer_t` */
-    using timer_ptr_t = std::unique_ptr<timer_t>;
-
     /** \brief constructs new supervisor from parent supervisor and supervisor config
      *
      * the `parent` supervisor can be `null`
@@ -65,9 +57,6 @@ struct supervisor_ev_t : public supervisor_t {
     virtual void start() noexcept override;
     virtual void shutdown() noexcept override;
     virtual void enqueue(message_ptr_t message) noexcept override;
-    virtual void start_timer(const pt::time_duration &send, timer_id_t timer_id) noexcept override;
-    virtual void cancel_timer(timer_id_t timer_id) noexcept override;
-    virtual void on_timer_trigger(timer_id_t timer_id) noexcept override;
     virtual void shutdown_finish() noexcept override;
 
     /** \brief retuns ev-loop associated with the supervisor */
@@ -77,12 +66,19 @@ struct supervisor_ev_t : public supervisor_t {
     inline system_context_ev_t *get_context() noexcept { return static_cast<system_context_ev_t *>(context); }
 
   protected:
-    /** \brief a type for mapping `timer_id` to timer */
-    using timers_map_t = std::unordered_map<timer_id_t, timer_ptr_t>;
-
     /** \brief EV-specific trampoline function for `on_async` method */
     static void async_cb(EV_P_ ev_async *w, int revents) noexcept;
 
+    /** \brief EV-specific trampoline function for `trigger_timers` method */
+    static void timer_cb(EV_P_ ev_timer *w, int revents) noexcept;
+
+    /** \brief EV-specific trampoline function for deferred `do_process` */
+    static void idle_cb(EV_P_ ev_idle *w, int revents) noexcept;
+
+    virtual void arm_timer(const pt::time_duration &delay) noexcept override;
+    virtual void disarm_timer() noexcept override;
+    virtual void defer_process() noexcept override;
+
     /** \brief Process external messages (from inbound queue).
      *
      * Used for moving messages in a thread-safe way for the supervisor
@@ -101,26 +97,27 @@ struct supervisor_ev_t : public supervisor_t {
     /** \brief ev-loop specific thread-safe wake-up notifier for external messages delivery */
     ev_async async_watcher;
 
-    /** \brief mutex for protecting inbound queue and pending flag */
-    std::mutex inbound_mutex;
-
-    /** \brief whether refcounter should be decreased
+    /** \brief whether the supervisor is already notified via `async_watcher`
      *
      * Async events are "compressed" by EV, i.e. a few async sygnals can be
      * delivere as one. As we do inc/dec for atomic counter, this might be
      * a problem. So by the flag we are sure, that inc/dec will happen
-     * only once.
+     * only once. It also spares `ev_async_send` invocations, while the
+     * supervisor has not yet been woken up.
      *
      */
-    bool pending;
+    std::atomic_bool pending;
 
-    /** \brief inbound messages queue, i.e.the structure to hold messages
+    /** \brief lock-free inbound messages queue, i.e.the structure to hold messages
      * received from other supervisors / threads
      */
-    queue_t inbound;
+    mpsc_queue_t inbound;
+
+    /** \brief the single timer, which wakes the supervisor up for its nearest timer deadline */
+    ev_timer timer_watcher;
 
-    /** \brief timer_id to timer map */
-    timers_map_t timers_map;
+    /** \brief the watcher, which continues the messages processing, when the budget is exhausted */
+    ev_idle idle_watcher;
 
     friend struct supervisor_ev_shutdown_t;
 };
@@ -8,11 +8,13 @@
 
 #include "actor_base.h"
 #include "message.h"
+#include <cassert>
 #include <functional>
 #include <memory>
 #include <typeindex>
 #include <typeinfo>
 #include <type_traits>
+#include <vector>
 //#include <iostream>
 
 namespace rotor {
@@ -74,8 +76,17 @@ template <typename A, typename M> struct handler_traits<void (A::*)(M &) noexcep
  * on concrete actor
  */
 struct handler_base_t : public arc_base_t<handler_base_t> {
-    /** \brief pointer to unique message type ( `typeid(Message).name()` ) */
-    const void *message_type;
+    /** \brief plain function, which delivers message to the handler
+     *
+     * It is a devirtualized alternative to `call`: the thunk is stored along
+     * with the handler in the supervisor's recipients table, so the delivery is
+     * a single indirect call without vtable lookup. The message type must match
+     * the handler message type.
+     */
+    using thunk_t = void (*)(handler_base_t &handler, message_base_t &message) noexcept;
+
+    /** \brief unique message type identifier ( `message_t<T>::message_type` ) */
+    message_type_t message_type;
 
     /** \brief pointer to unique handler type ( `typeid(Handler).name()` ) */
     const void *handler_type;
@@ -89,11 +100,16 @@ struct handler_base_t : public arc_base_t<handler_base_t> {
     /** \brief precalculated hash for the handler */
     size_t precalc_hash;
 
+    /** \brief devirtualized message delivery function for the handler */
+    thunk_t thunk;
+
     /** \brief constructs `handler_base_t` from raw pointer to actor, raw
-     * pointer to message type and raw pointer to handler type
+     * pointer to message type, raw pointer to handler type and the thunk
      */
-    explicit handler_base_t(actor_base_t &actor, const void *message_type_, const void *handler_type_)
-        : message_type{message_type_}, handler_type{handler_type_}, actor_ptr{&actor}, raw_actor_ptr{&actor} {
+    explicit handler_base_t(actor_base_t &actor, message_type_t message_type_, const void *handler_type_,
+                            thunk_t thunk_)
+        : message_type{message_type_}, handler_type{handler_type_}, actor_ptr{&actor}, raw_actor_ptr{&actor},
+          thunk{thunk_} {
         auto h1 = reinterpret_cast<std::size_t>(handler_type);
         auto h2 = reinterpret_cast<std::size_t>(&actor);
         precalc_hash = h1 ^ (h2 << 1);
@@ -104,10 +120,10 @@ struct handler_base_t : public arc_base_t<handler_base_t> {
         return handler_type == rhs.handler_type && raw_actor_ptr == rhs.raw_actor_ptr;
     }
 
-    /** \brief attempt to delivery message to he handler
+    /** \brief delivers message to the handler
      *
-     * The message is delivered only if its type matches to the handler message type,
-     * otherwise it is silently ignored
+     * The message type must match the handler message type; that is guaranteed
+     * by the supervisor, which looks up the handlers by (address, message type).
      */
     virtual void call(message_ptr_t &) noexcept = 0;
 
@@ -116,6 +132,12 @@ struct handler_base_t : public arc_base_t<handler_base_t> {
 
 using handler_ptr_t = intrusive_ptr_t<handler_base_t>;
 
+/** \brief immutable list of handlers, which belong to the same supervisor */
+using handlers_batch_t = std::vector<handler_ptr_t>;
+
+/** \brief shared pointer to the immutable batch of handlers */
+using handlers_batch_ptr_t = std::shared_ptr<const handlers_batch_t>;
+
 template <typename Handler, typename Enable = void> struct handler_t;
 
 /** \struct handler_t
@@ -135,14 +157,16 @@ struct handler_t<Handler,
 
     /** \brief constructs handler from actor & pointer-to-member function  */
     explicit handler_t(actor_base_t &actor, Handler &&handler_)
-        : handler_base_t{actor, final_message_t::message_type, handler_type}, handler{handler_} {}
-
-    void call(message_ptr_t &message) noexcept override {
-        if (message->type_index == final_message_t::message_type) {
-            auto final_message = static_cast<final_message_t *>(message.get());
-            auto &final_obj = static_cast<final_actor_t &>(*actor_ptr);
-            (final_obj.*handler)(*final_message);
-        }
+        : handler_base_t{actor, final_message_t::message_type, handler_type, &invoke}, handler{handler_} {}
+
+    void call(message_ptr_t &message) noexcept override { invoke(*this, *message); }
+
+    /** \brief delivers the message to the actor via pointer-to-member function */
+    static void invoke(handler_base_t &self, message_base_t &message) noexcept {
+        assert(message.type_index == final_message_t::message_type);
+        auto &final_handler = static_cast<handler_t &>(self);
+        auto &final_obj = static_cast<final_actor_t &>(*final_handler.actor_ptr);
+        (final_obj.*final_handler.handler)(static_cast<final_message_t &>(message));
     }
 
   private:
@@ -169,14 +193,16 @@ template <typename Handler, typename M> struct handler_t<lambda_holder_t<Handler
 
     /** \brief constructs handler from actor & lambda wrapper */
     explicit handler_t(actor_base_t &actor, handler_backend_t &&handler_)
-        : handler_base_t{actor, final_message_t::message_type, handler_type}, handler{std::forward<handler_backend_t>(
-                                                                                  handler_)} {}
-
-    void call(message_ptr_t &message) noexcept override {
-        if (message->type_index == final_message_t::message_type) {
-            auto final_message = static_cast<final_message_t *>(message.get());
-            handler.fn(*final_message);
-        }
+        : handler_base_t{actor, final_message_t::message_type, handler_type, &invoke},
+          handler{std::forward<handler_backend_t>(handler_)} {}
+
+    void call(message_ptr_t &message) noexcept override { invoke(*this, *message); }
+
+    /** \brief delivers the message to the lambda */
+    static void invoke(handler_base_t &self, message_base_t &message) noexcept {
+        assert(message.type_index == final_message_t::message_type);
+        auto &final_handler = static_cast<handler_t &>(self);
+        final_handler.handler.fn(static_cast<final_message_t &>(message));
     }
 
   private:
@@ -0,0 +1,110 @@
+#pragma once
+
+//
+// Copyright (c) 2019-2020 Ivan Baidakou (basiliscos) (the dot dmol at gmail dot com)
+//
+// Distributed under the MIT Software License
+//
+
+#include "message.h"
+#include "policy.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+
+namespace rotor {
+
+/** \struct mailbox_t
+ *  \brief bounds the amount of messages from other localities, which are not yet
+ *  taken by the locality leader
+ *
+ * The mailbox does not hold messages itself, it just accounts them: the producer
+ * (i.e. the thread, which enqueues a message to the supervisor of other locality)
+ * asks the mailbox to `admit` the message before putting it into the inbound queue,
+ * and the consumer (the locality leader) `release`s the taken messages. When the
+ * mailbox is full, the `overflow_policy_t` is applied.
+ *
+ * The control messages (see {@link payload_control_t}) are always admitted and
+ * never dropped, as the actors lifetime depends on them; however they are
+ * accounted as the regular ones.
+ *
+ * The `drop_oldest` policy does not bound the memory, while the locality leader
+ * is not able to take the messages: as the inbound queue is lock-free, the oldest
+ * messages are dropped when they are taken.
+ *
+ * The `block` policy must not be used, if the producer and consumer localities
+ * might be served by the same thread, as the producer might be the very thread,
+ * which has to process the consumer. The supervisors of thread pool (`rotor::pool`)
+ * and shards (`rotor::shard`) backends fall back to `drop_newest` policy; that is
+ * not detected for the other backends, e.g. `supervisor_asio_t` with the strands
+ * of the same `io_context`, run by a single thread, deadlocks.
+ *
+ * The rejection reply is routed by the producer supervisor, which processes its
+ * messages on the current thread (see `supervisor_t::current_leader`), or,
+ * if there is no such one, it is enqueued to the reply destination supervisor.
+ *
+ */
+struct mailbox_t {
+    /** \brief constructs mailbox of the given (non-zero) capacity */
+    mailbox_t(std::size_t capacity, overflow_policy_t policy) noexcept;
+    mailbox_t(const mailbox_t &) = delete;
+    mailbox_t(mailbox_t &&) = delete;
+
+    /** \brief accounts the message, which is going to be enqueued (thread-safe)
+     *
+     * Returns `false` if the message is dropped or rejected, i.e. it should not
+     * be enqueued; in the case the message is released.
+     *
+     */
+    bool admit(message_ptr_t &message) noexcept;
+
+    /** \brief returns `false` if the message, taken by the consumer, should be
+     * dropped (`drop_oldest` policy) */
+    inline bool keep(const message_base_t &message) noexcept {
+        if (excess.load(std::memory_order_relaxed) == 0 || message.control) {
+            return true;
+        }
+        --excess;
+        ++dropped;
+        return false;
+    }
+
+    /** \brief accounts the `count` messages taken by the consumer, and wakes up
+     * the blocked producers (if any) */
+    void release(std::size_t count) noexcept;
+
+    /** \brief returns the maximum amount of pending messages */
+    inline std::size_t get_capacity() const noexcept { return capacity; }
+
+    /** \brief returns the overflow policy */
+    inline overflow_policy_t get_policy() const noexcept { return policy; }
+
+    /** \brief returns amount of the admitted, but not yet taken messages */
+    inline std::size_t get_depth() const noexcept { return depth.load(std::memory_order_relaxed); }
+
+    /** \brief returns total amount of the dropped messages */
+    inline std::size_t get_dropped() const noexcept { return dropped.load(std::memory_order_relaxed); }
+
+    /** \brief returns total amount of the rejected messages */
+    inline std::size_t get_rejected() const noexcept { return rejected.load(std::memory_order_relaxed); }
+
+  private:
+    bool reserve() noexcept;
+
+    std::size_t capacity;
+    overflow_policy_t policy;
+    std::atomic<std::size_t> depth;
+    std::atomic<std::size_t> excess;
+    std::atomic<std::size_t> dropped;
+    std::atomic<std::size_t> rejected;
+    std::atomic<std::size_t> waiters;
+    std::mutex mutex;
+    std::condition_variable room;
+};
+
+/** \brief owning pointer to mailbox */
+using mailbox_ptr_t = std::unique_ptr<mailbox_t>;
+
+} // namespace rotor
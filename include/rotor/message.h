@@ -8,10 +8,41 @@
 
 #include "arc.hpp"
 #include "address.hpp"
-#include <typeindex>
+#include "message_pool.h"
+#include <atomic>
+#include <cstdint>
+#include <new>
+#include <system_error>
+#include <type_traits>
 
 namespace rotor {
 
+/** \brief dense (small integer) message type identifier
+ *
+ * Each `message_t<T>` gets its own identifier upon program start-up, the
+ * identifiers are started from `1` without gaps, so they can be used as
+ * array indices or as cheap hash keys.
+ *
+ */
+using message_type_t = std::uint32_t;
+
+namespace details {
+
+/** \brief registers new message type and returns its identifier (thread-safe) */
+message_type_t register_message_type() noexcept;
+
+} // namespace details
+
+struct message_base_t;
+
+#if defined(ROTOR_REFCOUNT_HYBRID) && !defined(ROTOR_REFCOUNT_THREADUNSAFE)
+/** \brief messages ref-counter base: non-atomic until the message leaves its locality */
+using message_arc_base_t = hybrid_arc_base_t<message_base_t>;
+#else
+/** \brief messages ref-counter base */
+using message_arc_base_t = arc_base_t<message_base_t>;
+#endif
+
 /** \struct message_base_t
  *  \brief Base class for `rotor` message.
  *
@@ -21,27 +52,130 @@ namespace rotor {
  * The actual message payload meant to be provided by derived classes
  *
  */
-struct message_base_t : public arc_base_t<message_base_t> {
+struct message_base_t : public message_arc_base_t {
     virtual ~message_base_t();
 
+    /** \brief prepares message to be handed over to other thread (locality)
+     *
+     * In the hybrid ref-counting mode (`ROTOR_REFCOUNT_HYBRID`) it switches
+     * message ref-counter, as well as ref-counters of all messages referred
+     * by the message payload, into atomic mode. Otherwise it does nothing.
+     *
+     */
+    virtual void share() noexcept;
+
     /**
-     * \brief unique message type pointer.
+     * \brief unique message type identifier.
      *
-     * The unique message type pointer is used to runtime check message type
-     *  match when the message is delivered to subscribers.
+     * The unique message type identifier is used to find subscribers of
+     * the message type, when the message is delivered.
      *
      */
-    const void *type_index;
+    message_type_t type_index;
 
     /** \brief message destination address */
     address_ptr_t address;
 
+    /** \brief intrusive link, used by {@link mpsc_queue_t} */
+    message_base_t *next = nullptr;
+
+    /** \brief whether the message is linked into some {@link mpsc_queue_t} via `next` */
+    std::atomic_bool linked{false};
+
+    /** \brief whether the message is a control (service) one, see {@link payload_control_t} */
+    bool control;
+
+    /** \brief whether the message is processed before the regular ones, see {@link payload_priority_t} */
+    bool urgent;
+
     /** \brief constructor which takes destination address */
-    message_base_t(const void *type_index_, const address_ptr_t &addr) : type_index{type_index_}, address{addr} {}
+    message_base_t(message_type_t type_index_, const address_ptr_t &addr, bool control_ = false,
+                   bool urgent_ = false)
+        : type_index{type_index_}, address{addr}, control{control_}, urgent{urgent_} {}
+
+    /** \brief returns the reply to the sender of the message, which is rejected
+     * by the destination mailbox (see {@link mailbox_t})
+     *
+     * Only requests have such reply, i.e. the error response; for the other messages
+     * `nullptr` is returned.
+     *
+     */
+    virtual intrusive_ptr_t<message_base_t> reject(const std::error_code &ec) noexcept;
+
+    /** \brief takes message storage from the active {@link message_pool_t} (if any) */
+    static void *operator new(std::size_t size) { return message_pool_t::allocate(size); }
+
+    /** \brief returns message storage back to the owning {@link message_pool_t} */
+    static void operator delete(void *ptr) noexcept { message_pool_t::deallocate(ptr); }
+
+    /** \brief over-aligned messages are not pooled */
+    static void *operator new(std::size_t size, std::align_val_t align) { return ::operator new(size, align); }
+
+    /** \brief over-aligned messages are not pooled */
+    static void operator delete(void *ptr, std::align_val_t align) noexcept { ::operator delete(ptr, align); }
 };
 
 inline message_base_t::~message_base_t() {}
 
+inline intrusive_ptr_t<message_base_t> message_base_t::reject(const std::error_code &) noexcept { return {}; }
+
+#if defined(ROTOR_REFCOUNT_HYBRID) && !defined(ROTOR_REFCOUNT_THREADUNSAFE)
+inline void message_base_t::share() noexcept { message_arc_base_t::share(); }
+#else
+inline void message_base_t::share() noexcept {}
+#endif
+
+/** \struct payload_sharing_t
+ *  \brief shares messages, referred by the payload (see `message_base_t::share`)
+ *
+ * By default payload does not refer any messages; payloads, which do
+ * hold messages, should specialize it.
+ */
+template <typename T, typename = void> struct payload_sharing_t {
+    /** \brief shares messages, referred by the payload */
+    static inline void share(T &) noexcept {}
+};
+
+/** \struct payload_control_t
+ *  \brief marks control (service) payloads, the messages of which are never
+ *  dropped by mailbox overflow policy (see {@link mailbox_t})
+ *
+ * By default payload is not a control one; the `rotor` own service payloads
+ * specialize it.
+ */
+template <typename T, typename = void> struct payload_control_t : std::false_type {};
+
+/** \struct payload_priority_t
+ *  \brief marks urgent payloads, the messages of which are put into the priority
+ *  lane of supervisor queue, i.e. they are processed before the regular messages
+ *
+ * By default only control payloads (see {@link payload_control_t}) are urgent, so
+ * the actors initialization does not wait for the user traffic; the shutdown and
+ * unsubscription payloads are not urgent, so they do not overtake the messages
+ * already queued for the actor. User payloads might be tagged as urgent via
+ * specialization:
+ *
+ * ~~~{.cpp}
+ * template <> struct rotor::payload_priority_t<payload::alarm_t> : std::true_type {};
+ * ~~~
+ *
+ * The order of messages is preserved only within the same lane.
+ *
+ */
+template <typename T, typename = void> struct payload_priority_t : payload_control_t<T> {};
+
+/** \struct payload_rejection_t
+ *  \brief makes the reply to the rejected message (see `message_base_t::reject`)
+ *
+ * By default there is no reply; requests specialize it to reply with error.
+ */
+template <typename T, typename = void> struct payload_rejection_t {
+    /** \brief returns `nullptr`, i.e. there is no reply */
+    static inline intrusive_ptr_t<message_base_t> reject(message_base_t &, const std::error_code &) noexcept {
+        return {};
+    }
+};
+
 /** \struct message_t
  *  \brief the generic message meant to hold user-specific payload
  *  \tparam T payload type
@@ -54,19 +188,31 @@ template <typename T> struct message_t : public message_base_t {
     /** \brief forwards `args` for payload construction */
     template <typename... Args>
     message_t(const address_ptr_t &addr, Args &&... args)
-        : message_base_t{message_type, addr}, payload{std::forward<Args>(args)...} {}
+        : message_base_t{message_type, addr, payload_control_t<T>::value, payload_priority_t<T>::value},
+          payload{std::forward<Args>(args)...} {}
 
     /** \brief user-defined payload */
     T payload;
 
-    /** \brief static type which uniquely identifies payload-type specialized `message_t` */
-    static const void *message_type;
+    /** \brief shares the message as well as messages, referred by the payload */
+    void share() noexcept override {
+        message_base_t::share();
+        payload_sharing_t<T>::share(payload);
+    }
+
+    /** \brief makes the reply to the rejected message, see {@link payload_rejection_t} */
+    intrusive_ptr_t<message_base_t> reject(const std::error_code &ec) noexcept override {
+        return payload_rejection_t<T>::reject(*this, ec);
+    }
+
+    /** \brief dense identifier which uniquely identifies payload-type specialized `message_t` */
+    static const message_type_t message_type;
 };
 
 /** \brief intrusive pointer for message */
 using message_ptr_t = intrusive_ptr_t<message_base_t>;
 
-template <typename T> const void *message_t<T>::message_type = static_cast<const void *>(typeid(message_t<T>).name());
+template <typename T> const message_type_t message_t<T>::message_type = details::register_message_type();
 
 /** \brief constucts message by constructing it's payload; intrusive pointer for the message is returned */
 template <typename M, typename... Args> auto make_message(const address_ptr_t &addr, Args &&... args) -> message_ptr_t {
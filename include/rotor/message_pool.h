@@ -0,0 +1,105 @@
+#pragma once
+
+//
+// Copyright (c) 2019-2020 Ivan Baidakou (basiliscos) (the dot dmol at gmail dot com)
+//
+// Distributed under the MIT Software License
+//
+
+#include "arc.hpp"
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace rotor {
+
+/** \struct message_pool_t
+ *  \brief recycles storage of messages by size classes on behalf of locality leader
+ *
+ * Each locality leader ({@link supervisor_t}) owns a pool, which is activated
+ * for the current thread while the leader processes its messages. All messages,
+ * allocated in the scope of an active pool, take their storage from it, so that
+ * the typical "send-deliver-drop" cycle does not touch global heap at all.
+ *
+ * Every block carries a small header with the owning pool, hence a message
+ * might be released anywhere: if it is released when its own pool is active,
+ * the block is returned into local (non-synchronized) free list; otherwise
+ * (i.e. a message crossed thread boundaries) the block is pushed into lock-free
+ * remote list, which is lazily reclaimed by the owner, once the local free list
+ * of the appropriate size class gets exhausted.
+ *
+ * Every allocated block holds a reference to the pool, i.e. the pool outlives
+ * its supervisor until the last of its messages is released.
+ *
+ * Messages, which do not fit into the largest size class, are allocated
+ * via global heap.
+ *
+ */
+struct message_pool_t : public arc_base_t<message_pool_t> {
+    /** \brief amount of size classes */
+    static constexpr std::size_t classes_count = 5;
+
+    /** \brief the smallest block size (including header) */
+    static constexpr std::size_t min_block_size = 64;
+
+    /** \brief the largest block size (including header), larger blocks are taken from heap */
+    static constexpr std::size_t max_block_size = min_block_size << (classes_count - 1);
+
+    /** \brief amount of memory, which is requested from heap, when a size class needs refill */
+    static constexpr std::size_t chunk_size = 16 * 1024;
+
+    /** \struct scope_t
+     *  \brief RAII-helper, which activates the pool for the current thread
+     *
+     * The previously active pool is restored upon scope destruction, i.e. the
+     * scopes might be nested.
+     */
+    struct scope_t {
+        /** \brief activates the pool (might be `null`) for the current thread */
+        scope_t(message_pool_t *pool) noexcept;
+
+        /** \brief restores previously active pool for the current thread */
+        ~scope_t();
+
+        scope_t(const scope_t &) = delete;
+        scope_t(scope_t &&) = delete;
+
+      private:
+        message_pool_t *prev;
+    };
+
+    message_pool_t() noexcept;
+    message_pool_t(const message_pool_t &) = delete;
+    message_pool_t(message_pool_t &&) = delete;
+    ~message_pool_t();
+
+    /** \brief allocates memory for the message of the specified size
+     *
+     * If there is an active pool for the current thread, the memory is taken from
+     * it, otherwise it is taken from the global heap.
+     */
+    static void *allocate(std::size_t size);
+
+    /** \brief releases memory, previously allocated via `allocate` */
+    static void deallocate(void *ptr) noexcept;
+
+    /** \brief returns pool, active for the current thread, if any */
+    static message_pool_t *current() noexcept;
+
+  private:
+    struct block_t {
+        block_t *next;
+    };
+
+    void *take(std::size_t size_class);
+    void refill(std::size_t size_class);
+
+    block_t *local[classes_count];
+    std::atomic<block_t *> remote[classes_count];
+    std::vector<void *> chunks;
+};
+
+/** \brief intrusive pointer for message pool */
+using message_pool_ptr_t = intrusive_ptr_t<message_pool_t>;
+
+} // namespace rotor
@@ -0,0 +1,167 @@
+#pragma once
+
+//
+// Copyright (c) 2019-2020 Ivan Baidakou (basiliscos) (the dot dmol at gmail dot com)
+//
+// Distributed under the MIT Software License
+//
+
+#include "message.h"
+#include <cassert>
+#include <memory>
+
+namespace rotor {
+
+/** \struct message_queue_t
+ *  \brief growable FIFO ring-buffer of messages (intrusive pointers)
+ *
+ * The capacity of the queue is always power of two; when the queue is full,
+ * the buffer is doubled and the messages are moved into the new one. Hence,
+ * once the queue reached its working size, it does not allocate any longer.
+ *
+ * The messages are moved in and out of the queue, i.e. there is no
+ * reference counter traffic. Unlike the intrusive {@link mpsc_queue_t}, the ring
+ * does not link the messages, so the same message might be put into it several
+ * times without any wrapping (the supervisor queue contract).
+ *
+ * The high water mark is tracked by the locality leader for all its queues (see
+ * `supervisor_t::get_queue_high_water_mark`), not by the queue itself.
+ *
+ * The queue is not thread-safe.
+ *
+ */
+struct message_queue_t {
+    /** \brief constructs the queue, optionally reserving space for `capacity` messages */
+    explicit message_queue_t(std::size_t capacity = 0) : mask{0}, head{0}, tail{0} {
+        if (capacity) {
+            reserve(capacity);
+        }
+    }
+
+    message_queue_t(const message_queue_t &) = delete;
+    message_queue_t(message_queue_t &&) = delete;
+
+    /** \brief appends the message to the end of the queue */
+    inline void emplace_back(message_ptr_t &&message) {
+        if (tail - head == capacity()) {
+            reserve(capacity() ? capacity() * 2 : initial_capacity);
+        }
+        buffer[tail++ & mask] = std::move(message);
+    }
+
+    /** \brief returns reference to the first message of the non-empty queue */
+    inline message_ptr_t &front() noexcept {
+        assert(!empty());
+        return buffer[head & mask];
+    }
+
+    /** \brief moves out the first message of the non-empty queue */
+    inline message_ptr_t pop_front() noexcept {
+        assert(!empty());
+        return std::move(buffer[head++ & mask]);
+    }
+
+    /** \brief returns `true` if there are no messages in the queue */
+    inline bool empty() const noexcept { return head == tail; }
+
+    /** \brief returns amount of messages in the queue */
+    inline std::size_t size() const noexcept { return tail - head; }
+
+    /** \brief returns amount of messages, which can be put without reallocation */
+    inline std::size_t capacity() const noexcept { return buffer ? mask + 1 : 0; }
+
+    /** \brief releases all messages in the queue */
+    inline void clear() noexcept {
+        while (head != tail) {
+            buffer[head++ & mask].reset();
+        }
+    }
+
+    /** \brief ensures that `capacity` (rounded up to power of two) messages can be held
+     * without reallocation */
+    void reserve(std::size_t capacity) {
+        std::size_t new_capacity = initial_capacity;
+        while (new_capacity < capacity) {
+            new_capacity *= 2;
+        }
+        if (new_capacity <= this->capacity()) {
+            return;
+        }
+
+        buffer_t new_buffer(new message_ptr_t[new_capacity]);
+        auto sz = tail - head;
+        for (std::size_t i = 0; i < sz; ++i) {
+            new_buffer[i] = std::move(buffer[(head + i) & mask]);
+        }
+        buffer = std::move(new_buffer);
+        mask = new_capacity - 1;
+        head = 0;
+        tail = sz;
+    }
+
+  private:
+    using buffer_t = std::unique_ptr<message_ptr_t[]>;
+    static const constexpr std::size_t initial_capacity = 16;
+
+    buffer_t buffer;
+    std::size_t mask;
+    std::size_t head;
+    std::size_t tail;
+};
+
+/** \struct message_lanes_t
+ *  \brief two-lane FIFO of messages: the urgent messages (see {@link payload_priority_t})
+ *  are always taken before the regular ones
+ *
+ * As the initialization, subscription and the confirmation messages are urgent,
+ * they do not wait behind the user traffic. The shutdown and unsubscription messages
+ * are regular, i.e. they do not overtake the messages already queued for the actor.
+ *
+ * The size is accounted for both lanes, the capacity and
+ * the reservation are for the regular lane only.
+ *
+ * The lanes are not thread-safe.
+ *
+ */
+struct message_lanes_t {
+    /** \brief constructs the lanes, optionally reserving space for `capacity` regular messages */
+    explicit message_lanes_t(std::size_t capacity = 0) : regular{capacity} {}
+
+    /** \brief appends the message to the end of the appropriate lane */
+    inline void emplace_back(message_ptr_t &&message) {
+        (message->urgent ? urgent : regular).emplace_back(std::move(message));
+    }
+
+    /** \brief returns reference to the first message of the non-empty lanes */
+    inline message_ptr_t &front() noexcept { return urgent.empty() ? regular.front() : urgent.front(); }
+
+    /** \brief moves out the first message of the non-empty lanes */
+    inline message_ptr_t pop_front() noexcept { return urgent.empty() ? regular.pop_front() : urgent.pop_front(); }
+
+    /** \brief returns `true` if there are no messages in the both lanes */
+    inline bool empty() const noexcept { return urgent.empty() && regular.empty(); }
+
+    /** \brief returns amount of messages in the both lanes */
+    inline std::size_t size() const noexcept { return urgent.size() + regular.size(); }
+
+    /** \brief returns amount of regular messages, which can be put without reallocation */
+    inline std::size_t capacity() const noexcept { return regular.capacity(); }
+
+    /** \brief returns amount of messages in the urgent lane */
+    inline std::size_t urgent_size() const noexcept { return urgent.size(); }
+
+    /** \brief releases all messages in the both lanes */
+    inline void clear() noexcept {
+        urgent.clear();
+        regular.clear();
+    }
+
+    /** \brief ensures that `capacity` regular messages can be held without reallocation */
+    inline void reserve(std::size_t capacity) { regular.reserve(capacity); }
+
+  private:
+    message_queue_t urgent;
+    message_queue_t regular;
+};
+
+} // namespace rotor
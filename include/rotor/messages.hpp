@@ -10,12 +10,15 @@
 #include "message.h"
 #include "state.h"
 #include "request.hpp"
+#include <memory>
+#include <vector>
 
 namespace rotor {
 
 struct handler_base_t;
 using actor_ptr_t = intrusive_ptr_t<actor_base_t>;
 using handler_ptr_t = intrusive_ptr_t<handler_base_t>;
+using handlers_batch_ptr_t = std::shared_ptr<const std::vector<handler_ptr_t>>;
 
 namespace payload {
 
@@ -120,14 +123,34 @@ struct shutdown_request_t {
  * be to different event loop), then the delivery of the message is forwarded to
  * that supersior.
  *
+ * All the handlers of the same external supervisor are forwarded in a single
+ * message, i.e. the original message is forwarded once per supervisor.
+ *
  */
 struct handler_call_t {
     /** \brief The original message (intrusive pointer) sent to an address */
     message_ptr_t orig_message;
 
-    /** \brief The handler (intrusive pointer) on some external supervisor,
+    /** \brief The handlers (immutable shared list) on some external supervisor,
      * which can process the original message */
-    handler_ptr_t handler;
+    handlers_batch_ptr_t handlers;
+};
+
+/** \struct cancel_request_t
+ *  \brief Message with this payload is sent to the destination address of the
+ * request, when the request is cancelled by the requester.
+ *
+ * The response to the cancelled request is not expected anymore (it will be
+ * silently dropped), so the destination actor might abort the request
+ * processing early. The request is identified by the original request message.
+ *
+ * The notice is never dropped by the mailbox, but, unlike the other control messages,
+ * it is not urgent, so it is delivered after the request itself.
+ *
+ */
+struct cancel_request_t {
+    /** \brief the cancelled request message */
+    message_ptr_t request;
 };
 
 /** \struct external_subscription_t
@@ -294,8 +317,97 @@ struct discovery_request_t {
     std::string service_name;
 };
 
+/** \struct credit_grant_t
+ *  \brief the consumer permits the producer to send more messages to it
+ *
+ * See {@link credit_sender_t} and {@link credit_receiver_t}.
+ */
+struct credit_grant_t {
+    /** \brief the address of consumer, i.e. the destination of the credited messages */
+    address_ptr_t consumer;
+
+    /** \brief the amount of messages, the producer is allowed to send additionally */
+    std::size_t credits;
+};
+
 } // namespace payload
 
+/** \brief `payload::initialize_actor_t` is a control payload */
+template <> struct payload_control_t<payload::initialize_actor_t> : std::true_type {};
+
+/** \brief `payload::start_actor_t` is a control payload */
+template <> struct payload_control_t<payload::start_actor_t> : std::true_type {};
+
+/** \brief `payload::create_actor_t` is a control payload */
+template <> struct payload_control_t<payload::create_actor_t> : std::true_type {};
+
+/** \brief `payload::shutdown_trigger_t` is a control payload */
+template <> struct payload_control_t<payload::shutdown_trigger_t> : std::true_type {};
+
+/** \brief `payload::shutdown_request_t` is a control payload */
+template <> struct payload_control_t<payload::shutdown_request_t> : std::true_type {};
+
+/** \brief `payload::shutdown_trigger_t` goes via the regular lane, i.e. the messages,
+ * which are already queued for the actor, are delivered before its shutdown */
+template <> struct payload_priority_t<payload::shutdown_trigger_t> : std::false_type {};
+
+/** \brief `payload::shutdown_request_t` goes via the regular lane (as well as its response) */
+template <> struct payload_priority_t<payload::shutdown_request_t> : std::false_type {};
+
+/** \brief `payload::cancel_request_t` is a control payload */
+template <> struct payload_control_t<payload::cancel_request_t> : std::true_type {};
+
+/** \brief `payload::cancel_request_t` goes via the regular lane, i.e. it never
+ * overtakes the (regular) request it cancels */
+template <> struct payload_priority_t<payload::cancel_request_t> : std::false_type {};
+
+/** \brief `payload::external_subscription_t` is a control payload */
+template <> struct payload_control_t<payload::external_subscription_t> : std::true_type {};
+
+/** \brief `payload::subscription_confirmation_t` is a control payload */
+template <> struct payload_control_t<payload::subscription_confirmation_t> : std::true_type {};
+
+/** \brief `payload::external_unsubscription_t` is a control payload */
+template <> struct payload_control_t<payload::external_unsubscription_t> : std::true_type {};
+
+/** \brief `payload::commit_unsubscription_t` is a control payload */
+template <> struct payload_control_t<payload::commit_unsubscription_t> : std::true_type {};
+
+/** \brief `payload::unsubscription_confirmation_t` is a control payload */
+template <> struct payload_control_t<payload::unsubscription_confirmation_t> : std::true_type {};
+
+/** \brief `payload::external_unsubscription_t` goes via the regular lane, i.e. it does not
+ * overtake the messages to the handler */
+template <> struct payload_priority_t<payload::external_unsubscription_t> : std::false_type {};
+
+/** \brief `payload::commit_unsubscription_t` goes via the regular lane */
+template <> struct payload_priority_t<payload::commit_unsubscription_t> : std::false_type {};
+
+/** \brief `payload::unsubscription_confirmation_t` goes via the regular lane */
+template <> struct payload_priority_t<payload::unsubscription_confirmation_t> : std::false_type {};
+
+/** \brief `payload::state_request_t` is a control payload */
+template <> struct payload_control_t<payload::state_request_t> : std::true_type {};
+
+/** \brief `payload::credit_grant_t` is a control payload */
+template <> struct payload_control_t<payload::credit_grant_t> : std::true_type {};
+
+/** \struct payload_sharing_t<payload::handler_call_t>
+ *  \brief the original message is handed over together with the handler call
+ */
+template <> struct payload_sharing_t<payload::handler_call_t> {
+    /** \brief shares the original message */
+    static inline void share(payload::handler_call_t &payload) noexcept { payload.orig_message->share(); }
+};
+
+/** \struct payload_sharing_t<payload::cancel_request_t>
+ *  \brief the cancelled request message is handed over together with the notice
+ */
+template <> struct payload_sharing_t<payload::cancel_request_t> {
+    /** \brief shares the cancelled request message */
+    static inline void share(payload::cancel_request_t &payload) noexcept { payload.request->share(); }
+};
+
 namespace message {
 
 using init_request_t = request_traits_t<payload::initialize_actor_t>::request::message_t;
@@ -316,6 +428,8 @@ using deregistration_notify_t = message_t<payload::deregistration_notify_t>;
 using deregistration_service_t = message_t<payload::deregistration_service_t>;
 using discovery_request_t = request_traits_t<payload::discovery_request_t>::request::message_t;
 using discovery_response_t = request_traits_t<payload::discovery_request_t>::response::message_t;
+using cancel_request_t = message_t<payload::cancel_request_t>;
+using credit_grant_t = message_t<payload::credit_grant_t>;
 
 } // namespace message
 
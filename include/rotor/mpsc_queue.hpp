@@ -0,0 +1,140 @@
+#pragma once
+
+//
+// Copyright (c) 2019-2020 Ivan Baidakou (basiliscos) (the dot dmol at gmail dot com)
+//
+// Distributed under the MIT Software License
+//
+
+#include "message.h"
+#include <atomic>
+
+namespace rotor {
+
+namespace details {
+
+/** \struct relay_t
+ *  \brief the envelope for the message, which is already linked into some {@link mpsc_queue_t} */
+struct relay_t {
+    /** \brief the wrapped message */
+    intrusive_ptr_t<message_base_t> message;
+};
+
+} // namespace details
+
+/** \struct mpsc_queue_t
+ *  \brief intrusive lock-free multiple producers / single consumer queue of messages
+ *
+ * The queue is meant to be used as inbound queue of a supervisor, i.e. any thread
+ * might `push` a message into it, while only the thread of the supervisor
+ * might `pop_all` of them.
+ *
+ * The messages are linked via their own `next` field, i.e. the queue does not
+ * allocate. As the consequence, a message can be linked into a single `mpsc_queue_t`
+ * at a time. The same message might be pushed again before it is consumed (e.g. it
+ * has been `put` or `enqueue`d several times); then it is wrapped into the
+ * envelope, which is linked instead and unwrapped by the consumer.
+ *
+ * As the messages are handed over to the consumer thread, they are
+ * shared (see `message_base_t::share`) upon `push`.
+ *
+ * Internally, the messages are pushed onto lock-free stack, which is atomically
+ * detached by the consumer and reversed, so the original order of messages of
+ * each producer is preserved.
+ *
+ */
+struct mpsc_queue_t {
+    mpsc_queue_t() noexcept : head{nullptr} {}
+    mpsc_queue_t(const mpsc_queue_t &) = delete;
+    mpsc_queue_t(mpsc_queue_t &&) = delete;
+
+    /** \brief releases all not yet consumed messages */
+    ~mpsc_queue_t() {
+        auto message = head.exchange(nullptr, std::memory_order_acquire);
+        while (message) {
+            auto next = message->next;
+            message->linked.store(false, std::memory_order_relaxed);
+            intrusive_ptr_release(message);
+            message = next;
+        }
+    }
+
+    /** \brief appends message into the queue (thread-safe)
+     *
+     * Returns `true` if the queue was empty, i.e. the consumer should be
+     * notified about new messages. Otherwise consumer is already notified
+     * and it will get the message during the next `pop_all` invocation.
+     *
+     */
+    bool push(message_ptr_t &&message) noexcept {
+        message->share();
+        if (message->linked.exchange(true, std::memory_order_acq_rel)) {
+            message = make_message<details::relay_t>(message->address, std::move(message));
+            message->share();
+            message->linked.store(true, std::memory_order_relaxed);
+        }
+        auto ptr = message.detach();
+        auto prev = head.load(std::memory_order_relaxed);
+        do {
+            ptr->next = prev;
+        } while (!head.compare_exchange_weak(prev, ptr, std::memory_order_release, std::memory_order_relaxed));
+        return prev == nullptr;
+    }
+
+    /** \brief moves all available messages into the `queue` in FIFO order
+     *
+     * Must be invoked only from the consumer (supervisor) thread. Returns the
+     * amount of taken messages, i.e. zero if there are no messages in the queue.
+     *
+     */
+    template <typename Queue> std::size_t pop_all(Queue &queue) {
+        return pop_all(queue, [](const message_base_t &) { return true; });
+    }
+
+    /** \brief moves all available messages, for which the `filter` returns `true`,
+     * into the `queue` in FIFO order; the other messages are released
+     *
+     * Returns the amount of taken messages, including the filtered out ones.
+     *
+     */
+    template <typename Queue, typename Filter> std::size_t pop_all(Queue &queue, Filter &&filter) {
+        message_base_t *message = head.exchange(nullptr, std::memory_order_acquire);
+        if (!message) {
+            return 0;
+        }
+
+        message_base_t *reversed = nullptr;
+        while (message) {
+            auto next = message->next;
+            message->next = reversed;
+            reversed = message;
+            message = next;
+        }
+
+        std::size_t count = 0;
+        while (reversed) {
+            auto next = reversed->next;
+            reversed->next = nullptr;
+            // the message might be pushed again since now
+            reversed->linked.store(false, std::memory_order_release);
+            message_ptr_t taken{reversed, false};
+            if (taken->type_index == message_t<details::relay_t>::message_type) {
+                taken = std::move(static_cast<message_t<details::relay_t> &>(*taken).payload.message);
+            }
+            if (filter(*taken)) {
+                queue.emplace_back(std::move(taken));
+            }
+            reversed = next;
+            ++count;
+        }
+        return count;
+    }
+
+    /** \brief returns `true` if there are no messages in the queue (approximation) */
+    bool empty() const noexcept { return head.load(std::memory_order_relaxed) == nullptr; }
+
+  private:
+    std::atomic<message_base_t *> head;
+};
+
+} // namespace rotor
@@ -20,4 +20,41 @@ enum class supervisor_policy_t {
 
 };
 
+/** \brief what to do with the message from other locality, when the mailbox
+ * of the locality leader is full (see {@link mailbox_t}) */
+enum class overflow_policy_t {
+    /** \brief the incoming message is dropped */
+    drop_newest = 1,
+
+    /** \brief the incoming message is accepted, while the oldest pending message
+     * is dropped when the messages are taken by the locality leader */
+    drop_oldest,
+
+    /** \brief the incoming message is dropped; if it is a request, the
+     * `error_code_t::request_rejected` response is sent to its reply address */
+    reject,
+
+    /** \brief the producer thread waits until the mailbox has free room; the thread
+     * pool and shards backends use `drop_newest` instead. It deadlocks, if the producer
+     * and the consumer share the thread, e.g. the asio strands of single-threaded
+     * `io_context` (see {@link mailbox_t}) */
+    block,
+};
+
+/** \brief how the locality leader picks the next message among the supervisors
+ * of its locality */
+enum class scheduling_t {
+    /** \brief all messages are processed in the order they are put, i.e. a busy
+     * supervisor might delay the messages of the others */
+    fifo = 1,
+
+    /** \brief each supervisor has own sub-queue, the sub-queues are served in turn
+     * by one message */
+    round_robin,
+
+    /** \brief each supervisor has own sub-queue, the sub-queues are served in turn
+     * by `supervisor_config_t::weight` messages */
+    weighted,
+};
+
 } // namespace rotor
@@ -0,0 +1,22 @@
+#pragma once
+
+//
+// Copyright (c) 2019-2020 Ivan Baidakou (basiliscos) (the dot dmol at gmail dot com)
+//
+// Distributed under the MIT Software License
+//
+
+/** \file pool.hpp
+ * A convenience header to include rotor support for the work-stealing thread pool
+ */
+
+#include "rotor/pool/supervisor_config_pool.h"
+#include "rotor/pool/supervisor_pool.h"
+#include "rotor/pool/system_context_pool.h"
+
+namespace rotor {
+
+/// namespace for the work-stealing thread pool backend of `rotor`
+namespace pool {}
+
+} // namespace rotor
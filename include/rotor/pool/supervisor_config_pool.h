@@ -0,0 +1,34 @@
+#pragma once
+
+//
+// Copyright (c) 2019-2020 Ivan Baidakou (basiliscos) (the dot dmol at gmail dot com)
+//
+// Distributed under the MIT Software License
+//
+
+#include "rotor/supervisor_config.h"
+
+namespace rotor {
+namespace pool {
+
+/** \struct supervisor_config_pool_t
+ *  \brief thread pool supervisor config, which determines whether the supervisor
+ * is a separately schedulable locality
+ */
+struct supervisor_config_pool_t : public supervisor_config_t {
+    /** \brief whether the supervisor is the leader of its own locality (default),
+     * or it shares the locality of its parent
+     *
+     * Each locality is processed by the single pool thread at a time, the different
+     * localities are processed in parallel.
+     *
+     */
+    bool own_locality;
+
+    /** \brief constructs config from shutdown timeout and the locality flag */
+    supervisor_config_pool_t(const rotor::pt::time_duration &shutdown_timeout, bool own_locality_ = true)
+        : supervisor_config_t{shutdown_timeout}, own_locality{own_locality_} {}
+};
+
+} // namespace pool
+} // namespace rotor
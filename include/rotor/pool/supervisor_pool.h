@@ -0,0 +1,122 @@
+#pragma once
+
+//
+// Copyright (c) 2019-2020 Ivan Baidakou (basiliscos) (the dot dmol at gmail dot com)
+//
+// Distributed under the MIT Software License
+//
+
+#include "rotor/supervisor.h"
+#include "rotor/mpsc_queue.hpp"
+#include "rotor/pool/supervisor_config_pool.h"
+#include "rotor/pool/system_context_pool.h"
+#include <atomic>
+#include <vector>
+
+namespace rotor {
+namespace pool {
+
+/** \struct supervisor_pool_t
+ *  \brief delivers rotor-messages on the work-stealing thread pool
+ *
+ * By default each pool supervisor is the leader of its own locality, which is
+ * the schedulable unit of the pool: when the locality gets messages (or its
+ * timer expires), it is scheduled on the worker thread; the idle workers steal
+ * the scheduled localities from the busy ones. The locality is processed by
+ * the single worker at a time, i.e. its actors are executed sequentially, but
+ * not necessarily on the same thread.
+ *
+ * The supervisor with `own_locality = false` in the config shares the
+ * locality of its parent.
+ *
+ * Messages from other localities are accumulated in the lock-free inbound
+ * queue of the locality leader; only the first message into the empty queue
+ * schedules the locality. When the processing budget (see
+ * `supervisor_config_t::process_budget`) is exhausted, the locality is
+ * re-scheduled, i.e. the other localities of the worker are not starved.
+ *
+ * The `overflow_policy_t::block` mailbox is not supported (`drop_newest` is used instead),
+ * as the blocked producer might be the worker, which has to process the consumer.
+ *
+ */
+struct supervisor_pool_t : public supervisor_t {
+
+    /** \brief constructs new supervisor from parent supervisor and supervisor config
+     *
+     * the `parent` supervisor can be `null`
+     *
+     */
+    supervisor_pool_t(supervisor_pool_t *parent, const supervisor_config_pool_t &config);
+
+    /** \brief creates an actor by forwaring `args` to it
+     *
+     * The newly created actor belogs to the supervisor locality
+     */
+    template <typename Actor, typename... Args>
+    intrusive_ptr_t<Actor> create_actor(const pt::time_duration &timeout, Args &&... args) {
+        return make_actor<Actor>(*this, timeout, std::forward<Args>(args)...);
+    }
+
+    virtual address_ptr_t make_address() noexcept override;
+
+    virtual void start() noexcept override;
+    virtual void shutdown() noexcept override;
+    virtual void enqueue(message_ptr_t message) noexcept override;
+    virtual void shutdown_finish() noexcept override;
+
+    /** \brief returns a reference to the thread pool system context */
+    inline system_context_pool_t &get_pool_context() noexcept { return static_cast<system_context_pool_t &>(*context); }
+
+  protected:
+    friend struct system_context_pool_t;
+
+    /** \brief the scheduling state of the locality */
+    enum class run_state_t { idle, scheduled, running, notified };
+
+    virtual void arm_timer(const pt::time_duration &delay) noexcept override;
+    virtual void disarm_timer() noexcept override;
+    virtual void defer_process() noexcept override;
+
+    /** \brief schedules the locality on the pool, unless it is already scheduled
+     * or being processed (thread-safe)
+     *
+     * If the locality is being processed, it is re-scheduled after that.
+     *
+     */
+    void notify() noexcept;
+
+    /** \brief triggers the expired timers of the locality supervisors, moves the
+     * inbound messages into the queue and processes them
+     *
+     * It is invoked on the locality leader by the pool worker.
+     *
+     */
+    virtual void process() noexcept;
+
+    /** \brief whether the supervisor leads its own locality, copied from config */
+    bool own_locality;
+
+    /** \brief the scheduling state of the locality (leader only) */
+    std::atomic<run_state_t> run_state;
+
+    /** \brief lock-free inbound messages queue, i.e. the structure to hold messages
+     * received from other localities
+     */
+    mpsc_queue_t inbound;
+
+    /** \brief whether the supervisor timer is in the context timers */
+    bool armed;
+
+    /** \brief the position of the supervisor timer in the context timers (if armed) */
+    system_context_pool_t::timers_t::iterator timer_it;
+
+    /** \brief whether there are expired timers in `due` (leader only) */
+    std::atomic_bool has_due;
+
+    /** \brief the supervisors of the locality with expired timers (leader only),
+     * guarded by the context mutex */
+    std::vector<supervisor_ptr_t> due;
+};
+
+} // namespace pool
+} // namespace rotor
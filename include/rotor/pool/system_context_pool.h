@@ -0,0 +1,164 @@
+#pragma once
+
+//
+// Copyright (c) 2019-2020 Ivan Baidakou (basiliscos) (the dot dmol at gmail dot com)
+//
+// Distributed under the MIT Software License
+//
+
+#include "rotor/arc.hpp"
+#include "rotor/pool/supervisor_config_pool.h"
+#include "rotor/system_context.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace rotor {
+namespace pool {
+
+struct supervisor_pool_t;
+
+/** \brief intrusive pointer for thread pool supervisor */
+using supervisor_ptr_t = intrusive_ptr_t<supervisor_pool_t>;
+
+/** \struct system_context_pool_t
+ *  \brief The system context, which owns the worker threads and schedules the
+ * localities (i.e. the locality leaders) on them
+ *
+ * The locality with pending work is a schedulable unit. Each worker takes the
+ * units from the front of its own deque; when it is empty, the worker takes
+ * the units, scheduled outside of the pool threads, and then steals from the
+ * back of the other workers deques. The unit is processed by the single worker
+ * at a time, so the actors of the locality are still executed sequentially.
+ *
+ * The context also holds the timers of the pool supervisors: the idle workers
+ * sleep up to the nearest timer deadline, and the expired timers are handed over
+ * to the timer owner locality.
+ *
+ */
+struct system_context_pool_t : public system_context_t {
+    /** \brief intrusive pointer type for thread pool system context */
+    using ptr_t = rotor::intrusive_ptr_t<system_context_pool_t>;
+
+    /** \brief clock of the timers deadlines */
+    using clock_t = std::chrono::steady_clock;
+
+    /** \brief constructs the context with the given amount of threads (including
+     * the thread, which invokes `run`) */
+    system_context_pool_t(std::size_t threads = std::thread::hardware_concurrency());
+
+    /** \brief creates root supervior. `args` and config are forwared for supervisor constructor */
+    template <typename Supervisor = supervisor_pool_t, typename... Args>
+    auto create_supervisor(const supervisor_config_pool_t &config, Args &&... args) -> intrusive_ptr_t<Supervisor> {
+        if (supervisor) {
+            on_error(make_error_code(error_code_t::supervisor_defined));
+            return intrusive_ptr_t<Supervisor>{};
+        } else {
+            auto typed_sup =
+                system_context_t::create_supervisor<Supervisor>(nullptr, config, std::forward<Args>(args)...);
+            supervisor = typed_sup;
+            return typed_sup;
+        }
+    }
+
+    /** \brief processes the localities on the pool threads until `stop`
+     *
+     * The calling thread is the first worker; the method returns when all the
+     * workers are finished. It is invoked by the root supervisor, when it is
+     * shutted down.
+     *
+     */
+    void run() noexcept;
+
+    /** \brief lets the workers finish (thread-safe) */
+    void stop() noexcept;
+
+    /** \brief returns the amount of worker threads */
+    inline std::size_t get_threads() const noexcept { return workers.size(); }
+
+    /** \brief returns how many times the localities were stolen by idle workers */
+    inline std::size_t get_steals() const noexcept { return steals.load(std::memory_order_relaxed); }
+
+  protected:
+    friend struct supervisor_pool_t;
+
+    /** \brief timer deadlines, ordered by time, to the owning supervisors */
+    using timers_t = std::multimap<clock_t::time_point, supervisor_ptr_t>;
+
+    /** \struct worker_t
+     *  \brief the deque of the localities, scheduled on the worker */
+    struct worker_t {
+        /** \brief guards the deque from the stealing workers */
+        std::mutex mutex;
+
+        /** \brief the scheduled localities */
+        std::deque<supervisor_ptr_t> units;
+    };
+
+    /** \brief puts the locality into the current worker deque, or, if it is invoked
+     * outside of the pool threads, into the injected units (thread-safe) */
+    void schedule(supervisor_ptr_t &&unit) noexcept;
+
+    /** \brief takes the next locality for the worker: own, injected, then stolen */
+    supervisor_ptr_t take(std::size_t index) noexcept;
+
+    /** \brief processes the locality and re-schedules it, if it was notified meanwhile */
+    void process(supervisor_ptr_t &&unit) noexcept;
+
+    /** \brief the worker thread body */
+    void work(std::size_t index) noexcept;
+
+    /** \brief hands the expired timers over to their localities */
+    void fire_timers() noexcept;
+
+    /** \brief (re)arms the supervisor timer (thread-safe) */
+    void arm(supervisor_pool_t &sup, const clock_t::duration &delay) noexcept;
+
+    /** \brief removes the supervisor timer (thread-safe) */
+    void disarm(supervisor_pool_t &sup) noexcept;
+
+    /** \brief root thread pool supervisor */
+    supervisor_ptr_t supervisor;
+
+    /** \brief the workers, indexed by thread */
+    std::vector<std::unique_ptr<worker_t>> workers;
+
+    /** \brief guards the injected units, the timers and the sleeping workers */
+    std::mutex mutex;
+
+    /** \brief wakes up the sleeping workers */
+    std::condition_variable wakeup;
+
+    /** \brief the localities, scheduled outside of the pool threads */
+    std::deque<supervisor_ptr_t> injected;
+
+    /** \brief the armed timers of the pool supervisors */
+    timers_t timers;
+
+    /** \brief the nearest timer deadline (ticks of `clock_t`), checked without the lock */
+    std::atomic<clock_t::rep> deadline;
+
+    /** \brief the amount of scheduled, but not yet taken localities */
+    std::atomic<std::size_t> pending;
+
+    /** \brief the amount of the workers, which are going to sleep or sleep */
+    std::atomic<std::size_t> sleepers;
+
+    /** \brief the amount of stolen localities */
+    std::atomic<std::size_t> steals;
+
+    /** \brief whether the workers should finish */
+    bool stopped;
+};
+
+/** \brief intrusive pointer type for thread pool system context */
+using system_context_ptr_t = typename system_context_pool_t::ptr_t;
+
+} // namespace pool
+} // namespace rotor
@@ -9,6 +9,7 @@
 #include "address.hpp"
 #include "message.h"
 #include "error_code.h"
+#include "timer_wheel.h"
 #include <unordered_map>
 #include <boost/date_time/posix_time/posix_time.hpp>
 
@@ -17,7 +18,7 @@ namespace rotor {
 namespace pt = boost::posix_time;
 
 /** \brief unique (per supervisor) request id type */
-using request_id_t = std::uint32_t;
+using request_id_t = slab_key_t;
 
 /** \struct request_base_t
  *  \brief base class for request payload
@@ -32,6 +33,16 @@ struct request_base_t {
      *
      */
     address_ptr_t reply_to;
+
+    /** \brief the tick of monotonic clock (see {@link timer_wheel_t}), when the request
+     * times out on the requester side
+     *
+     * The deadline is assigned when the request is sent; it can be inherited
+     * by the nested requests (see `request_builder_t::send_within`). It is
+     * `timer_wheel_t::never` for the request, which is not sent via the builder.
+     *
+     */
+    timer_wheel_t::tick_t deadline;
 };
 
 /** \brief optionally wraps request type into intrusive pointer
@@ -87,8 +98,8 @@ template <typename T, typename = void> struct wrapped_request_t : request_base_t
     /** \brief constructs wrapper for user-supplied payload from request-id and
      * and destination reply address */
     template <typename... Args>
-    wrapped_request_t(std::uint32_t id_, const address_ptr_t &reply_to_, Args &&... args)
-        : request_base_t{id_, reply_to_}, request_payload{std::forward<Args>(args)...} {}
+    wrapped_request_t(request_id_t id_, const address_ptr_t &reply_to_, Args &&... args)
+        : request_base_t{id_, reply_to_, timer_wheel_t::never}, request_payload{std::forward<Args>(args)...} {}
 
     /** \brief original, user-supplied payload */
     T request_payload;
@@ -113,14 +124,15 @@ struct wrapped_request_t<T, std::enable_if_t<std::is_base_of_v<arc_base_t<T>, T>
      * The differnt `request-id` and `reply_to` address argruments are supplied
      * to make it possible cheaply forward requests.
      */
-    wrapped_request_t(std::uint32_t id_, const address_ptr_t &reply_to_, const request_t &request_)
-        : request_base_t{id_, reply_to_}, request_payload{request_} {}
+    wrapped_request_t(request_id_t id_, const address_ptr_t &reply_to_, const request_t &request_)
+        : request_base_t{id_, reply_to_, timer_wheel_t::never}, request_payload{request_} {}
 
     /** \brief constructs wrapper for user-supplied payload from request-id and
      * and destination reply address */
     template <typename... Args, typename E = std::enable_if_t<std::is_constructible_v<raw_request_t, Args...>>>
-    wrapped_request_t(std::uint32_t id_, const address_ptr_t &reply_to_, Args &&... args)
-        : request_base_t{id_, reply_to_}, request_payload{new raw_request_t{std::forward<Args>(args)...}} {}
+    wrapped_request_t(request_id_t id_, const address_ptr_t &reply_to_, Args &&... args)
+        : request_base_t{id_, reply_to_, timer_wheel_t::never},
+          request_payload{new raw_request_t{std::forward<Args>(args)...}} {}
 
     /** \brief intrusive pointer to user-supplied payload */
     request_t request_payload;
@@ -270,6 +282,90 @@ template <typename Request> struct wrapped_response_t {
     inline request_id_t request_id() const noexcept { return req->payload.id; }
 };
 
+/** \struct payload_sharing_t<wrapped_response_t<Request>>
+ *  \brief the original request message is handed over together with the response
+ */
+template <typename Request> struct payload_sharing_t<wrapped_response_t<Request>> {
+    /** \brief shares the original request message */
+    static inline void share(wrapped_response_t<Request> &payload) noexcept {
+        if (payload.req) {
+            payload.req->share();
+        }
+    }
+};
+
+/** \struct gathered_responses_t
+ * \brief the aggregate result of scatter-gather request (see {@link gather_builder_t})
+ *
+ * The responses are kept in the order of the requests. If a response has not
+ * arrived in time (or the gather request has been cancelled), the error response
+ * is kept in its place.
+ *
+ */
+template <typename Request> struct gathered_responses_t {
+    /** \brief alias for original user-supplied request type */
+    using request_t = typename request_unwrapper_t<Request>::request_t;
+
+    /** \brief alias for intrusive pointer to response message */
+    using response_message_ptr_t = intrusive_ptr_t<message_t<wrapped_response_t<request_t>>>;
+
+    /** \brief overall error code: `request_timeout` or `request_cancelled` if
+     * some of the responses have not arrived */
+    std::error_code ec;
+
+    /** \brief the response messages, in the order of the requests */
+    std::vector<response_message_ptr_t> responses;
+};
+
+/** \struct payload_sharing_t<gathered_responses_t<Request>>
+ *  \brief the response messages are handed over together with the aggregate
+ */
+template <typename Request> struct payload_sharing_t<gathered_responses_t<Request>> {
+    /** \brief shares the response messages */
+    static inline void share(gathered_responses_t<Request> &payload) noexcept {
+        for (auto &response : payload.responses) {
+            response->share();
+        }
+    }
+};
+
+/** \struct gather_base_t
+ * \brief type-erased state of the pending scatter-gather request
+ *
+ * The scatter-gather request occupies a single entry in the supervisor's requests
+ * map and a single timer. All the requests have the same request id.
+ *
+ */
+struct gather_base_t : arc_base_t<gather_base_t> {
+    virtual ~gather_base_t() = default;
+
+    /** \brief records the response to the `request` message; returns `true` if all
+     * responses have arrived
+     *
+     * The response is taken into account only if the `request` is one of the pending
+     * requests of the gather, i.e. a stale response of another request, which has the
+     * same request id, is ignored.
+     *
+     */
+    virtual bool collect(message_base_t &response, const message_base_t *request) noexcept = 0;
+
+    /** \brief makes the aggregate message, the missing responses are replaced by
+     * error responses with the `ec` code */
+    virtual message_ptr_t complete(const address_ptr_t &reply_to, const std::error_code &ec) noexcept = 0;
+
+    /** \brief the request messages, which are still waiting for the responses */
+    std::vector<message_ptr_t> requests;
+
+    /** \brief the addresses, the requests have been sent to (in the order of requests) */
+    std::vector<address_ptr_t> destinations;
+
+    /** \brief amount of responses, which have not arrived yet */
+    std::size_t pending = 0;
+};
+
+/** \brief intrusive pointer to scatter-gather request state */
+using gather_ptr_t = intrusive_ptr_t<gather_base_t>;
+
 /** \brief free function type, which produces error response to the original request */
 typedef message_ptr_t(error_producer_t)(const address_ptr_t &reply_to, message_base_t &msg,
                                         const std::error_code &ec) noexcept;
@@ -285,6 +381,17 @@ struct request_curry_t {
 
     /** \brief the original request message */
     message_ptr_t request_message;
+
+    /** \brief the state of scatter-gather request (`fn`, `request_message` and `destination`
+     * are not used then) */
+    gather_ptr_t gather;
+
+    /** \brief the address, the request has been sent to (the request message might be
+     * re-targeted further by `actor_base_t::forward_request`) */
+    address_ptr_t destination;
+
+    /** \brief whether the timeout timer is started, i.e. the request has the deadline */
+    bool timed;
 };
 
 /** \struct request_traits_t
@@ -324,6 +431,17 @@ template <typename R> struct request_traits_t {
         using message_ptr_t = intrusive_ptr_t<message_t>;
     };
 
+    /** \struct gather
+     * \brief scatter-gather related types */
+    struct gather {
+
+        /** \brief aggregate payload, which contains all response messages */
+        using wrapped_t = gathered_responses_t<request_t>;
+
+        /** \brief message type for the aggregate */
+        using message_t = rotor::message_t<wrapped_t>;
+    };
+
     /** \brief helper free function to produce error reply to the original request */
     static message_ptr_t make_error_response(const address_ptr_t &reply_to, message_base_t &message,
                                              const std::error_code &ec) noexcept {
@@ -336,6 +454,88 @@ template <typename R> struct request_traits_t {
     }
 };
 
+/** \struct payload_control_t<wrapped_request_t<T>>
+ *  \brief the request is a control one, if its user-supplied payload is
+ */
+template <typename T> struct payload_control_t<wrapped_request_t<T>> : payload_control_t<T> {};
+
+/** \struct payload_control_t<wrapped_response_t<Request>>
+ *  \brief the response is a control one, if its request is
+ */
+template <typename Request>
+struct payload_control_t<wrapped_response_t<Request>>
+    : payload_control_t<typename request_unwrapper_t<Request>::request_t> {};
+
+/** \struct payload_priority_t<wrapped_request_t<T>>
+ *  \brief the request is an urgent one, if its user-supplied payload is
+ */
+template <typename T> struct payload_priority_t<wrapped_request_t<T>> : payload_priority_t<T> {};
+
+/** \struct payload_priority_t<wrapped_response_t<Request>>
+ *  \brief the response is an urgent one, if its request is
+ */
+template <typename Request>
+struct payload_priority_t<wrapped_response_t<Request>>
+    : payload_priority_t<typename request_unwrapper_t<Request>::request_t> {};
+
+/** \struct payload_rejection_t<wrapped_request_t<T>>
+ *  \brief the rejected request is replied with error response
+ */
+template <typename T> struct payload_rejection_t<wrapped_request_t<T>> {
+    /** \brief makes error response to the request message */
+    static inline message_ptr_t reject(message_base_t &message, const std::error_code &ec) noexcept {
+        auto &request = static_cast<message_t<wrapped_request_t<T>> &>(message);
+        return request_traits_t<T>::make_error_response(request.payload.reply_to, message, ec);
+    }
+};
+
+/** \struct gather_t
+ * \brief the state of the pending scatter-gather request of the specific type
+ */
+template <typename T> struct gather_t : gather_base_t {
+    /** \brief request/response types helper */
+    using traits_t = request_traits_t<T>;
+
+    /** \brief alias for the response message type */
+    using response_message_t = typename traits_t::response::message_t;
+
+    /** \brief alias for the aggregate message type */
+    using result_message_t = typename traits_t::gather::message_t;
+
+    bool collect(message_base_t &message, const message_base_t *request) noexcept override {
+        if (!request) {
+            return false;
+        }
+        for (std::size_t i = 0; i < requests.size(); ++i) {
+            // the identity of the request is checked first, i.e. the message is known
+            // to be the response of the proper type only after the match
+            if (requests[i].get() == request) {
+                responses[i].reset(static_cast<response_message_t *>(&message));
+                requests[i].reset();
+                --pending;
+                return pending == 0;
+            }
+        }
+        return false;
+    }
+
+    message_ptr_t complete(const address_ptr_t &reply_to, const std::error_code &ec) noexcept override {
+        for (std::size_t i = 0; i < requests.size(); ++i) {
+            if (requests[i]) {
+                auto error = traits_t::make_error_response(reply_to, *requests[i], ec);
+                responses[i].reset(static_cast<response_message_t *>(error.get()));
+                requests[i].reset();
+            }
+        }
+        auto overall_ec = pending ? ec : make_error_code(error_code_t::success);
+        pending = 0;
+        return message_ptr_t{new result_message_t{reply_to, overall_ec, std::move(responses)}};
+    }
+
+    /** \brief the arrived responses, in the order of requests */
+    std::vector<typename traits_t::response::message_ptr_t> responses;
+};
+
 /** \struct request_builder_t
  * \brief builder pattern implentation for the original request
  */
@@ -351,7 +551,22 @@ template <typename T> struct [[nodiscard]] request_builder_t {
      * The request id of the dispatched request is returned
      *
      */
-    std::uint32_t send(pt::time_duration send) noexcept;
+    request_id_t send(pt::time_duration send) noexcept;
+
+    /** \brief dispatches the request with the deadline of the upstream request
+     *
+     * The request times out at the same tick as the upstream one, i.e. it
+     * does not outlive it, and its timer shares the timer wheel slot
+     * with the upstream timer (if the upstream request is made by the same
+     * supervisor) and does not re-arm the event-loop timer.
+     *
+     * If the upstream request has no deadline (`timer_wheel_t::never`), the request
+     * has none too, i.e. no timer is started for it.
+     *
+     * The request id of the dispatched request is returned
+     *
+     */
+    request_id_t send_within(const request_base_t &upstream) noexcept;
 
   private:
     using traits_t = request_traits_t<T>;
@@ -359,18 +574,53 @@ template <typename T> struct [[nodiscard]] request_builder_t {
     using request_message_ptr_t = typename traits_t::request::message_ptr_t;
     using response_message_t = typename traits_t::response::message_t;
     using response_message_ptr_t = typename traits_t::response::message_ptr_t;
-    using wrapped_res_t = typename traits_t::response::wrapped_t;
+
+    request_id_t dispatch(const pt::time_duration &timeout, timer_wheel_t::tick_t deadline) noexcept;
 
     supervisor_t &sup;
-    actor_base_t &actor;
-    std::uint32_t request_id;
     const address_ptr_t &destination;
     const address_ptr_t &reply_to;
-    bool do_install_handler;
     request_message_ptr_t req;
     address_ptr_t imaginary_address;
+};
+
+/** \struct gather_builder_t
+ * \brief builder pattern implentation for the scatter-gather request
+ *
+ * All the requests are sent under single timeout timer and single request
+ * id. The aggregate message (see {@link gathered_responses_t}) is delivered
+ * to the reply address once, when all the responses have arrived or when
+ * the timeout timer has been triggered.
+ *
+ */
+template <typename T> struct [[nodiscard]] gather_builder_t {
+    /** \brief constructs the builder without any requests */
+    gather_builder_t(supervisor_t &sup_, actor_base_t &actor_, const address_ptr_t &reply_to_);
 
-    void install_handler() noexcept;
+    /** \brief adds the request to the destination address with payload constructed from `args` */
+    template <typename... Args> gather_builder_t &request(const address_ptr_t &destination, Args &&... args);
+
+    /** \brief actually dispatches all the requests and spawns single timeout timer
+     *
+     * The common request id of the dispatched requests is returned
+     *
+     */
+    request_id_t send(pt::time_duration timeout) noexcept;
+
+    /** \brief dispatches all the requests with the deadline of the upstream request
+     * (if any, see `request_builder_t::send_within`) */
+    request_id_t send_within(const request_base_t &upstream) noexcept;
+
+  private:
+    using traits_t = request_traits_t<T>;
+    using request_message_t = typename traits_t::request::message_t;
+
+    request_id_t dispatch(const pt::time_duration &timeout, timer_wheel_t::tick_t deadline) noexcept;
+
+    supervisor_t &sup;
+    const address_ptr_t &reply_to;
+    address_ptr_t imaginary_address;
+    intrusive_ptr_t<gather_t<T>> gather;
 };
 
 } // namespace rotor
@@ -0,0 +1,357 @@
+#pragma once
+
+//
+// Copyright (c) 2019-2020 Ivan Baidakou (basiliscos) (the dot dmol at gmail dot com)
+//
+// Distributed under the MIT Software License
+//
+
+#include "supervisor.h"
+#include <algorithm>
+#include <cassert>
+#include <deque>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace rotor {
+
+/** \brief the way {@link router_t} selects a worker for a request */
+enum class routing_t {
+    /** \brief the workers are selected in turn */
+    round_robin,
+
+    /** \brief the worker with the fewest outstanding requests is selected */
+    least_outstanding,
+
+    /** \brief the worker is selected by the hash of the request via consistent hash ring,
+     * i.e. the requests with the same key are served by the same worker */
+    consistent_hash,
+};
+
+/** \struct router_config_t
+ *  \brief the configuration of {@link router_t}
+ */
+template <typename Request> struct router_config_t {
+    /** \brief user-supplied request payload, as it is held by the request message */
+    using request_t = typename request_wrapper_t<Request>::request_t;
+
+    /** \brief the function, which returns the key hash of the request (for `consistent_hash` routing) */
+    using hasher_t = std::function<std::size_t(const request_t &)>;
+
+    /** \brief the initial worker addresses */
+    std::vector<address_ptr_t> workers;
+
+    /** \brief the worker selection mode */
+    routing_t routing = routing_t::round_robin;
+
+    /** \brief the maximum amount of simultaneous requests, served by a single worker */
+    std::size_t max_outstanding = 1;
+
+    /** \brief the maximum amount of requests waiting for a worker; the requests
+     * above the limit are replied with `error_code_t::request_rejected` */
+    std::size_t queue_limit = 0;
+
+    /** \brief the request key hash function, mandatory for `consistent_hash` routing */
+    hasher_t hasher;
+};
+
+/** \struct router_t
+ *  \brief routes requests to the pool of workers
+ *
+ * The router accepts the requests on its main address and passes each one to
+ * the selected worker (see {@link routing_t}) as the new request, which inherits
+ * the deadline of the original one; the worker's response is moved into
+ * the reply to the original request.
+ *
+ * The amount of outstanding requests of each worker is tracked from the
+ * responses. When no worker is able to serve the request (i.e. all of them
+ * have `max_outstanding` requests), it waits in the bounded queue, and when
+ * the queue is full, the request is rejected. That provides backpressure
+ * for the requesters instead of infinitely growing queue. The queued requests,
+ * whose deadline has passed, are replied with `error_code_t::request_timeout`
+ * without bothering the workers.
+ *
+ * The request payload is copied into the worker request, hence it is
+ * recommended to have it ref-counted (`arc_base_t`) if it is heavy.
+ *
+ * The workers can be added and removed at runtime, e.g. upon discovery
+ * via {@link registry_t}.
+ *
+ */
+template <typename Request> struct router_t : public actor_base_t {
+    /** \brief the router config type */
+    using config_t = router_config_t<Request>;
+
+    /** \brief request message type */
+    using request_message_t = typename request_traits_t<Request>::request::message_t;
+
+    /** \brief response message type */
+    using response_message_t = typename request_traits_t<Request>::response::message_t;
+
+    /** \brief intrusive pointer to request message */
+    using request_ptr_t = intrusive_ptr_t<request_message_t>;
+
+    /** \struct worker_t
+     *  \brief the worker address and the amount of requests it currently serves
+     */
+    struct worker_t {
+        /** \brief worker address */
+        address_ptr_t address;
+
+        /** \brief amount of requests, sent to the worker and not replied yet */
+        std::size_t outstanding;
+
+        /** \brief the unique number of the worker entry, i.e. the same worker address
+         * gets the new one, when it is removed and added again */
+        std::uint64_t generation;
+    };
+
+    /** \brief the list of workers type */
+    using workers_t = std::vector<worker_t>;
+
+    /** \brief amount of points per worker on the consistent hash ring */
+    static const constexpr std::size_t ring_replicas = 64;
+
+    /** \brief constructs router from the config */
+    router_t(supervisor_t &sup, const config_t &config_)
+        : actor_base_t{sup}, routing{config_.routing}, max_outstanding{config_.max_outstanding},
+          queue_limit{config_.queue_limit}, hasher{config_.hasher}, cursor{0}, generations{0} {
+        assert(max_outstanding && "worker should be able to serve at least one request");
+        assert((routing != routing_t::consistent_hash || hasher) && "hasher is mandatory for consistent hash");
+        for (auto &address : config_.workers) {
+            workers.push_back(worker_t{address, 0, ++generations});
+        }
+        rebuild_ring();
+    }
+
+    void init_start() noexcept override {
+        subscribe(&router_t::on_request);
+        subscribe(&router_t::on_response);
+        actor_base_t::init_start();
+    }
+
+    /** \brief rejects the queued requests and cancels the outstanding ones */
+    void shutdown_start() noexcept override {
+        for (auto &it : queue) {
+            reply_with_error(*it.request, make_error_code(error_code_t::request_rejected));
+        }
+        queue.clear();
+        auto requests = std::move(in_flight);
+        for (auto &it : requests) {
+            cancel_request(it.first);
+            reply_with_error(*it.second.request, make_error_code(error_code_t::request_cancelled));
+        }
+        actor_base_t::shutdown_start();
+    }
+
+    /** \brief adds the worker into the pool and dispatches the queued requests to it */
+    void add_worker(const address_ptr_t &address) noexcept {
+        workers.push_back(worker_t{address, 0, ++generations});
+        rebuild_ring();
+        drain();
+    }
+
+    /** \brief removes the worker from the pool, returns `false` if there is no such worker
+     *
+     * The requests already sent to the worker are still waited for, but they are
+     * not accounted any longer, even if the worker is added again.
+     *
+     */
+    bool remove_worker(const address_ptr_t &address) noexcept {
+        auto it = std::find_if(workers.begin(), workers.end(), [&](auto &w) { return w.address == address; });
+        if (it == workers.end()) {
+            return false;
+        }
+        workers.erase(it);
+        rebuild_ring();
+        return true;
+    }
+
+    /** \brief returns the workers together with their outstanding requests */
+    inline const workers_t &get_workers() const noexcept { return workers; }
+
+    /** \brief returns amount of requests waiting for a worker */
+    inline std::size_t get_queue_size() const noexcept { return queue.size(); }
+
+    /** \brief dispatches the request to a worker, queues or rejects it */
+    virtual void on_request(request_message_t &message) noexcept {
+        request_ptr_t request{&message};
+        auto hash = key_hash(message);
+        auto worker = select(hash);
+        if (worker) {
+            dispatch(*worker, std::move(request));
+        } else if (queue.size() < queue_limit) {
+            queue.push_back(queued_t{std::move(request), hash});
+        } else {
+            reply_with_error(message, make_error_code(error_code_t::request_rejected));
+        }
+    }
+
+    /** \brief replies to the original request and dispatches the queued ones */
+    virtual void on_response(response_message_t &message) noexcept {
+        auto it = in_flight.find(message.payload.request_id());
+        if (it == in_flight.end()) {
+            return; // cancelled on shutdown
+        }
+        auto dispatched = std::move(it->second);
+        in_flight.erase(it);
+        auto worker = std::find_if(workers.begin(), workers.end(),
+                                   [&](auto &w) { return w.generation == dispatched.generation; });
+        if (worker != workers.end() && worker->outstanding) {
+            --worker->outstanding;
+        }
+        reply_to(*dispatched.request, message.payload.ec, std::move(message.payload.res));
+        drain();
+    }
+
+  protected:
+    /** \struct queued_t
+     *  \brief the request waiting for a worker
+     */
+    struct queued_t {
+        /** \brief the original request */
+        request_ptr_t request;
+
+        /** \brief the request key hash (for consistent hash routing) */
+        std::uint64_t hash;
+    };
+
+    /** \struct dispatched_t
+     *  \brief the request being served by a worker
+     */
+    struct dispatched_t {
+        /** \brief the original request */
+        request_ptr_t request;
+
+        /** \brief the generation of the worker entry, the request has been sent to */
+        std::uint64_t generation;
+    };
+
+    /** \brief point on consistent hash ring: the hash and the worker index */
+    using ring_point_t = std::pair<std::uint64_t, std::size_t>;
+
+    /** \brief sends the request to the worker */
+    void dispatch(worker_t &worker, request_ptr_t &&original) noexcept {
+        auto &payload = original->payload;
+        if (timer_wheel_t::now() >= payload.deadline) {
+            reply_with_error(*original, make_error_code(error_code_t::request_timeout));
+            return;
+        }
+        ++worker.outstanding;
+        auto id = request<Request>(worker.address, payload.request_payload).send_within(payload);
+        in_flight.emplace(id, dispatched_t{std::move(original), worker.generation});
+    }
+
+    /** \brief dispatches the queued requests to the workers, which are able to serve them */
+    void drain() noexcept {
+        auto it = queue.begin();
+        while (it != queue.end()) {
+            auto worker = select(it->hash);
+            if (worker) {
+                auto request = std::move(it->request);
+                it = queue.erase(it);
+                dispatch(*worker, std::move(request));
+            } else if (routing == routing_t::consistent_hash) {
+                // the other requests might be mapped to the other (free) workers
+                ++it;
+            } else {
+                break;
+            }
+        }
+    }
+
+    /** \brief returns the worker to serve the request with the key hash, or `nullptr`
+     * if the suitable worker is busy */
+    worker_t *select(std::uint64_t hash) noexcept {
+        auto count = workers.size();
+        if (!count) {
+            return nullptr;
+        }
+        if (routing == routing_t::consistent_hash) {
+            auto it = std::lower_bound(ring.begin(), ring.end(), ring_point_t{hash, 0});
+            auto &worker = workers[(it == ring.end() ? ring.front() : *it).second];
+            return worker.outstanding < max_outstanding ? &worker : nullptr;
+        }
+        worker_t *result = nullptr;
+        std::size_t index = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            auto candidate = (cursor + i) % count;
+            auto &worker = workers[candidate];
+            if (worker.outstanding < max_outstanding &&
+                (!result || worker.outstanding < result->outstanding)) {
+                result = &worker;
+                index = candidate;
+                if (routing == routing_t::round_robin || !worker.outstanding) {
+                    break;
+                }
+            }
+        }
+        if (result) {
+            cursor = index + 1;
+        }
+        return result;
+    }
+
+    /** \brief returns the key hash of the request for the consistent hash ring */
+    std::uint64_t key_hash(request_message_t &message) const noexcept {
+        if (routing != routing_t::consistent_hash) {
+            return 0;
+        }
+        return mix(hasher(message.payload.request_payload));
+    }
+
+    /** \brief re-creates the consistent hash ring from the current workers */
+    void rebuild_ring() noexcept {
+        ring.clear();
+        if (routing != routing_t::consistent_hash) {
+            return;
+        }
+        for (std::size_t i = 0; i < workers.size(); ++i) {
+            auto base = reinterpret_cast<std::uintptr_t>(workers[i].address.get());
+            for (std::size_t j = 0; j < ring_replicas; ++j) {
+                ring.emplace_back(mix(base + j * 0x9E3779B97F4A7C15ull), i);
+            }
+        }
+        std::sort(ring.begin(), ring.end());
+    }
+
+    /** \brief spreads the bits of the value (splitmix64 finalizer) */
+    static inline std::uint64_t mix(std::uint64_t value) noexcept {
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+        return value ^ (value >> 31);
+    }
+
+    /** \brief the worker selection mode */
+    routing_t routing;
+
+    /** \brief the maximum amount of simultaneous requests per worker */
+    std::size_t max_outstanding;
+
+    /** \brief the maximum amount of queued requests */
+    std::size_t queue_limit;
+
+    /** \brief the request key hash function */
+    typename config_t::hasher_t hasher;
+
+    /** \brief the index of worker to start the selection from */
+    std::size_t cursor;
+
+    /** \brief the last assigned worker entry generation */
+    std::uint64_t generations;
+
+    /** \brief the pool of workers */
+    workers_t workers;
+
+    /** \brief the consistent hash ring, sorted by hash */
+    std::vector<ring_point_t> ring;
+
+    /** \brief the requests waiting for a worker */
+    std::deque<queued_t> queue;
+
+    /** \brief the original requests by the ids of the worker requests */
+    std::unordered_map<request_id_t, dispatched_t> in_flight;
+};
+
+} // namespace rotor
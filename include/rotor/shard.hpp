@@ -0,0 +1,22 @@
+#pragma once
+
+//
+// Copyright (c) 2019-2020 Ivan Baidakou (basiliscos) (the dot dmol at gmail dot com)
+//
+// Distributed under the MIT Software License
+//
+
+/** \file shard.hpp
+ * A convenience header to include rotor support for thread-per-core shards
+ */
+
+#include "rotor/shard/supervisor_config_shard.h"
+#include "rotor/shard/supervisor_shard.h"
+#include "rotor/shard/system_context_shard.h"
+
+namespace rotor {
+
+/// namespace for the thread-per-core (shared-nothing) backend of `rotor`
+namespace shard {}
+
+} // namespace rotor
@@ -0,0 +1,28 @@
+#pragma once
+
+//
+// Copyright (c) 2019-2020 Ivan Baidakou (basiliscos) (the dot dmol at gmail dot com)
+//
+// Distributed under the MIT Software License
+//
+
+#include "rotor/supervisor_config.h"
+
+namespace rotor {
+namespace shard {
+
+/** \struct supervisor_config_shard_t
+ *  \brief shard supervisor config, which holds the shard index of the root supervisor
+ */
+struct supervisor_config_shard_t : public supervisor_config_t {
+    /** \brief the index of the shard (thread) of the root supervisor; the child
+     * supervisors always belong to the shard of their parent */
+    std::size_t shard;
+
+    /** \brief constructs config from shutdown timeout and the shard index */
+    supervisor_config_shard_t(const rotor::pt::time_duration &shutdown_timeout, std::size_t shard_ = 0)
+        : supervisor_config_t{shutdown_timeout}, shard{shard_} {}
+};
+
+} // namespace shard
+} // namespace rotor
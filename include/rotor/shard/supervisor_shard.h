@@ -0,0 +1,90 @@
+#pragma once
+
+//
+// Copyright (c) 2019-2020 Ivan Baidakou (basiliscos) (the dot dmol at gmail dot com)
+//
+// Distributed under the MIT Software License
+//
+
+#include "rotor/supervisor.h"
+#include "rotor/mpsc_queue.hpp"
+#include "rotor/shard/supervisor_config_shard.h"
+#include "rotor/shard/system_context_shard.h"
+
+namespace rotor {
+namespace shard {
+
+/** \struct supervisor_shard_t
+ *  \brief delivers rotor-messages within the thread-per-core shard
+ *
+ * The root supervisor of the shard is the locality leader of the whole shard,
+ * i.e. the child supervisors share its locality and its thread. Nothing of the
+ * shard is shared with the other shards: the messages to the other shards
+ * go via the dedicated SPSC rings, see {@link system_context_shard_t}.
+ *
+ * The `overflow_policy_t::block` mailbox is not supported (`drop_newest` is used instead),
+ * as the blocked producer might be the shard thread itself.
+ *
+ */
+struct supervisor_shard_t : public supervisor_t {
+
+    /** \brief constructs new supervisor from parent supervisor and supervisor config
+     *
+     * the `parent` supervisor can be `null`
+     *
+     */
+    supervisor_shard_t(supervisor_shard_t *parent, const supervisor_config_shard_t &config);
+
+    /** \brief creates an actor by forwaring `args` to it
+     *
+     * The newly created actor belogs to the supervisor shard
+     */
+    template <typename Actor, typename... Args>
+    intrusive_ptr_t<Actor> create_actor(const pt::time_duration &timeout, Args &&... args) {
+        return make_actor<Actor>(*this, timeout, std::forward<Args>(args)...);
+    }
+
+    virtual address_ptr_t make_address() noexcept override;
+
+    virtual void start() noexcept override;
+    virtual void shutdown() noexcept override;
+    virtual void enqueue(message_ptr_t message) noexcept override;
+    virtual void shutdown_finish() noexcept override;
+
+    /** \brief returns the index of the supervisor shard */
+    inline std::size_t get_shard() const noexcept { return shard; }
+
+    /** \brief returns a reference to the shard system context */
+    inline system_context_shard_t &get_shard_context() noexcept {
+        return static_cast<system_context_shard_t &>(*context);
+    }
+
+  protected:
+    friend struct system_context_shard_t;
+
+    virtual void arm_timer(const pt::time_duration &delay) noexcept override;
+    virtual void disarm_timer() noexcept override;
+
+    /** \brief moves the messages from the other shards into the queue, triggers the
+     * expired timers and processes the messages; returns `true` if there was some work
+     *
+     * It is invoked on the shard root supervisor by the shard thread.
+     *
+     */
+    bool poll() noexcept;
+
+    /** \brief the index of the supervisor shard */
+    std::size_t shard;
+
+    /** \brief lock-free inbound messages queue for the messages from non-shard threads */
+    mpsc_queue_t inbound;
+
+    /** \brief whether the supervisor timer is in the shard timers */
+    bool armed;
+
+    /** \brief the position of the supervisor timer in the shard timers (if armed) */
+    system_context_shard_t::timers_t::iterator timer_it;
+};
+
+} // namespace shard
+} // namespace rotor
@@ -0,0 +1,180 @@
+#pragma once
+
+//
+// Copyright (c) 2019-2020 Ivan Baidakou (basiliscos) (the dot dmol at gmail dot com)
+//
+// Distributed under the MIT Software License
+//
+
+#include "rotor/arc.hpp"
+#include "rotor/shard/supervisor_config_shard.h"
+#include "rotor/spsc_ring.hpp"
+#include "rotor/system_context.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace rotor {
+namespace shard {
+
+struct supervisor_shard_t;
+
+/** \brief intrusive pointer for shard supervisor */
+using supervisor_ptr_t = intrusive_ptr_t<supervisor_shard_t>;
+
+/** \struct system_context_shard_t
+ *  \brief The shared-nothing system context: each shard is a (pinned) thread
+ * with its own root supervisor, i.e. its own locality
+ *
+ * Every ordered pair of shards is connected by the dedicated {@link spsc_ring_t},
+ * so the message from one shard to the other is a single store into the ring,
+ * without locks and without the event-loop wake-up. When the ring is full,
+ * the messages are kept in the backlog of the sending shard, and moved into the
+ * ring as soon as the receiver makes some room, so the order is preserved.
+ *
+ * The shard threads poll their incoming rings. After `idle_spins` idle polls the
+ * shard thread parks until a message or its nearest timer; in that mode the
+ * sender additionally checks whether the receiver is parked. With `never_park`
+ * the threads poll all the time, and the sender does nothing but the store.
+ *
+ * The messages from outside of the shard threads (i.e. before `run`, or from
+ * the other threads) are delivered via the lock-free inbound queue of the shard.
+ *
+ */
+struct system_context_shard_t : public system_context_t {
+    /** \brief intrusive pointer type for shard system context */
+    using ptr_t = rotor::intrusive_ptr_t<system_context_shard_t>;
+
+    /** \brief clock of the timers deadlines */
+    using clock_t = std::chrono::steady_clock;
+
+    /** \brief `idle_spins` value, which disables the parking of idle shards */
+    static const constexpr std::size_t never_park = std::numeric_limits<std::size_t>::max();
+
+    /** \brief constructs the context with `shards` threads, connected by the rings of
+     * `ring_capacity` messages; the shard thread is pinned to the core with the same
+     * index (modulo the amount of cores), if `pin_threads` is set */
+    system_context_shard_t(std::size_t shards, std::size_t ring_capacity = 1024, std::size_t idle_spins = 10000,
+                           bool pin_threads = true);
+
+    /** \brief creates root supervior of the shard, defined by `config.shard`. `args`
+     * and config are forwared for supervisor constructor */
+    template <typename Supervisor = supervisor_shard_t, typename... Args>
+    auto create_supervisor(const supervisor_config_shard_t &config, Args &&... args) -> intrusive_ptr_t<Supervisor> {
+        if (config.shard >= shards.size() || shards[config.shard]->supervisor) {
+            on_error(make_error_code(error_code_t::supervisor_defined));
+            return intrusive_ptr_t<Supervisor>{};
+        } else {
+            auto typed_sup =
+                system_context_t::create_supervisor<Supervisor>(nullptr, config, std::forward<Args>(args)...);
+            shards[config.shard]->supervisor = typed_sup;
+            return typed_sup;
+        }
+    }
+
+    /** \brief runs the shard threads until `stop`, i.e. until all root supervisors
+     * are shutted down */
+    void run() noexcept;
+
+    /** \brief lets the shard threads finish (thread-safe) */
+    void stop() noexcept;
+
+    /** \brief returns the amount of shards */
+    inline std::size_t get_shards() const noexcept { return shards.size(); }
+
+    /** \brief returns root supervisor of the shard */
+    supervisor_ptr_t get_supervisor(std::size_t shard) noexcept;
+
+    /** \brief returns how many times the messages were put into the backlog, as the ring was full */
+    inline std::size_t get_backlogged() const noexcept { return backlogged.load(std::memory_order_relaxed); }
+
+    /** \brief returns how many messages were dropped, as the target shard has no root supervisor */
+    inline std::size_t get_dropped() const noexcept { return dropped.load(std::memory_order_relaxed); }
+
+  protected:
+    friend struct supervisor_shard_t;
+
+    /** \brief timer deadlines of the shard, ordered by time, to the owning supervisors */
+    using timers_t = std::multimap<clock_t::time_point, supervisor_ptr_t>;
+
+    /** \struct shard_t
+     *  \brief the state of the single shard */
+    struct shard_t {
+        /** \brief root supervisor of the shard */
+        supervisor_ptr_t supervisor;
+
+        /** \brief incoming rings, indexed by the sender shard (written by the senders) */
+        std::vector<std::unique_ptr<spsc_ring_t>> rings;
+
+        /** \brief outgoing messages, which do not fit into the ring, indexed by the receiver
+         * shard (the shard thread only) */
+        std::vector<std::deque<message_ptr_t>> backlogs;
+
+        /** \brief the armed timers of the shard supervisors (the shard thread only) */
+        timers_t timers;
+
+        /** \brief whether the shard thread is going to park or parked */
+        std::atomic_bool parked{false};
+
+        /** \brief guards the wake-up signal */
+        std::mutex mutex;
+
+        /** \brief wakes up the parked shard thread */
+        std::condition_variable wakeup;
+
+        /** \brief whether the shard has been woken up */
+        bool signalled = false;
+    };
+
+    /** \brief delivers the message from the current thread to the shard */
+    void send(std::size_t target, message_ptr_t &&message) noexcept;
+
+    /** \brief wakes up the shard, if it is parked */
+    void wake(std::size_t target) noexcept;
+
+    /** \brief drains incoming rings and inbound queue, fires the expired timers, processes
+     * the messages and flushes the backlogs; returns `true` if there was some work */
+    bool poll(std::size_t index) noexcept;
+
+    /** \brief parks the idle shard thread until it is woken up or its nearest timer */
+    void park(std::size_t index) noexcept;
+
+    /** \brief the shard thread body */
+    void work(std::size_t index) noexcept;
+
+    /** \brief invoked upon the root supervisor shutdown; the last one stops the context */
+    void on_shard_finished() noexcept;
+
+    /** \brief the shards, indexed by thread */
+    std::vector<std::unique_ptr<shard_t>> shards;
+
+    /** \brief the amount of idle polls before the parking */
+    std::size_t idle_spins;
+
+    /** \brief whether the shard threads are pinned to the cores */
+    bool pin_threads;
+
+    /** \brief the amount of root supervisors, which are not yet shutted down */
+    std::atomic<std::size_t> running;
+
+    /** \brief whether the shard threads should finish */
+    std::atomic_bool stopped;
+
+    /** \brief the amount of backlogged messages */
+    std::atomic<std::size_t> backlogged;
+
+    /** \brief the amount of messages, sent to the shards without root supervisor */
+    std::atomic<std::size_t> dropped;
+};
+
+/** \brief intrusive pointer type for shard system context */
+using system_context_ptr_t = typename system_context_shard_t::ptr_t;
+
+} // namespace shard
+} // namespace rotor
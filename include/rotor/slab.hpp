@@ -0,0 +1,120 @@
+#pragma once
+
+//
+// Copyright (c) 2019-2020 Ivan Baidakou (basiliscos) (the dot dmol at gmail dot com)
+//
+// Distributed under the MIT Software License
+//
+
+#include <cassert>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace rotor {
+
+/** \brief the key of an element in {@link slab_t} */
+using slab_key_t = std::uint64_t;
+
+/** \struct slab_t
+ *  \brief generation-tagged slab, i.e. vector of slots with free list
+ *
+ * The key of an element consists of slot index (lower `IndexBits` bits) and
+ * the slot generation (the rest bits), which is incremented each time the slot
+ * is released. So, a stale key (i.e. the key of an already erased element) is
+ * not found, even if the slot is reused for other element; however, the generation
+ * wraps around after `2 ^ (64 - IndexBits) - 1` reuses of the same slot. With the
+ * default 32 generation bits that does not happen in practice, even if a single
+ * slot is reused all the time (e.g. sequential requests).
+ *
+ * The key is never zero, so zero might be used as "no key" mark.
+ *
+ * Insertion, lookup and removal are O(1); the slots are not shrunk, i.e. once
+ * the slab reached its working size, it does not allocate.
+ *
+ */
+template <typename T, unsigned IndexBits = 32> struct slab_t {
+    static_assert(IndexBits > 0 && IndexBits <= 32 + 31, "no room for slot index or generation");
+
+    /** \brief amount of lower key bits, which denote slot index */
+    static const constexpr unsigned index_bits = IndexBits;
+
+    /** \brief mask for slot index in key */
+    static const constexpr slab_key_t index_mask = (slab_key_t{1} << index_bits) - 1;
+
+    slab_t() noexcept : free_list{npos}, count{0} {}
+    slab_t(const slab_t &) = delete;
+    slab_t(slab_t &&) = delete;
+
+    /** \brief returns the slot index of the key */
+    static inline std::uint32_t index_of(slab_key_t key) noexcept {
+        return static_cast<std::uint32_t>(key & index_mask);
+    }
+
+    /** \brief constructs new element from `args` and returns its key */
+    template <typename... Args> slab_key_t emplace(Args &&... args) {
+        std::uint32_t index;
+        if (free_list != npos) {
+            index = free_list;
+            free_list = slots[index].next;
+        } else {
+            index = static_cast<std::uint32_t>(slots.size());
+            assert(index < npos && index <= index_mask && "too many elements in slab");
+            slots.emplace_back();
+        }
+        auto &slot = slots[index];
+        slot.value.emplace(std::forward<Args>(args)...);
+        ++count;
+        return (slab_key_t{slot.generation} << index_bits) | index;
+    }
+
+    /** \brief returns pointer to the element or `nullptr` if the key is stale or unknown */
+    inline T *find(slab_key_t key) noexcept {
+        auto index = index_of(key);
+        if (index >= slots.size()) {
+            return nullptr;
+        }
+        auto &slot = slots[index];
+        if (!slot.value || slot.generation != (key >> index_bits)) {
+            return nullptr;
+        }
+        return &*slot.value;
+    }
+
+    /** \brief destroys the element; returns `false` if the key is stale or unknown */
+    bool erase(slab_key_t key) noexcept {
+        if (!find(key)) {
+            return false;
+        }
+        auto index = index_of(key);
+        auto &slot = slots[index];
+        slot.value.reset();
+        slot.generation = slot.generation == max_generation ? 1 : slot.generation + 1;
+        slot.next = free_list;
+        free_list = index;
+        --count;
+        return true;
+    }
+
+    /** \brief returns amount of elements */
+    inline std::size_t size() const noexcept { return count; }
+
+    /** \brief returns `true` if there are no elements */
+    inline bool empty() const noexcept { return count == 0; }
+
+  private:
+    static const constexpr std::uint32_t npos = ~std::uint32_t{0};
+    static const constexpr slab_key_t max_generation = (~slab_key_t{0}) >> index_bits;
+
+    struct slot_t {
+        std::optional<T> value;
+        slab_key_t generation = 1;
+        std::uint32_t next = npos;
+    };
+
+    std::vector<slot_t> slots;
+    std::uint32_t free_list;
+    std::size_t count;
+};
+
+} // namespace rotor
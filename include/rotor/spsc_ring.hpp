@@ -0,0 +1,115 @@
+#pragma once
+
+//
+// Copyright (c) 2019-2020 Ivan Baidakou (basiliscos) (the dot dmol at gmail dot com)
+//
+// Distributed under the MIT Software License
+//
+
+#include "message.h"
+#include <atomic>
+#include <memory>
+
+namespace rotor {
+
+/** \struct spsc_ring_t
+ *  \brief bounded wait-free single producer / single consumer ring of messages
+ *
+ * The ring connects exactly two threads: only one thread might `push`, and
+ * only one (other) thread might `pop_all`. Both operations never block or
+ * retry; `push` is a slot write and a single release store of the tail
+ * index, unless the ring seems to be full, when the producer re-reads the
+ * consumer position.
+ *
+ * The capacity is rounded up to the power of two. The producer and the consumer
+ * indices are kept on different cache lines, each side caches the index of
+ * the other side to avoid the cache line ping-pong.
+ *
+ * As the messages are handed over to the consumer thread, they are
+ * shared (see `message_base_t::share`) upon `push`.
+ *
+ */
+struct spsc_ring_t {
+    /** \brief constructs the ring, which can hold at least `capacity` messages */
+    explicit spsc_ring_t(std::size_t capacity) noexcept : head{0}, cached_tail{0}, tail{0}, cached_head{0} {
+        std::size_t size = 2;
+        while (size < capacity) {
+            size *= 2;
+        }
+        mask = size - 1;
+        slots.reset(new message_base_t *[size]);
+    }
+
+    spsc_ring_t(const spsc_ring_t &) = delete;
+    spsc_ring_t(spsc_ring_t &&) = delete;
+
+    /** \brief releases all not yet consumed messages */
+    ~spsc_ring_t() {
+        auto last = tail.load(std::memory_order_acquire);
+        for (auto i = head.load(std::memory_order_relaxed); i != last; ++i) {
+            intrusive_ptr_release(slots[i & mask]);
+        }
+    }
+
+    /** \brief moves the message into the ring (producer only)
+     *
+     * Returns `false` if the ring is full; the message is left intact then.
+     *
+     */
+    bool push(message_ptr_t &message) noexcept {
+        auto position = tail.load(std::memory_order_relaxed);
+        if (position - cached_head > mask) {
+            cached_head = head.load(std::memory_order_acquire);
+            if (position - cached_head > mask) {
+                return false;
+            }
+        }
+        message->share();
+        slots[position & mask] = message.detach();
+        tail.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** \brief moves all available messages into the `queue` in FIFO order (consumer only)
+     *
+     * Returns the amount of taken messages.
+     *
+     */
+    template <typename Queue> std::size_t pop_all(Queue &queue) {
+        auto position = head.load(std::memory_order_relaxed);
+        if (position == cached_tail) {
+            cached_tail = tail.load(std::memory_order_acquire);
+            if (position == cached_tail) {
+                return 0;
+            }
+        }
+        auto last = cached_tail;
+        for (auto i = position; i != last; ++i) {
+            queue.emplace_back(message_ptr_t{slots[i & mask], false});
+        }
+        head.store(last, std::memory_order_release);
+        return last - position;
+    }
+
+    /** \brief returns `true` if there are no messages in the ring (approximation) */
+    bool empty() const noexcept {
+        return head.load(std::memory_order_relaxed) == tail.load(std::memory_order_acquire);
+    }
+
+    /** \brief returns the maximum amount of messages in the ring */
+    std::size_t capacity() const noexcept { return mask + 1; }
+
+  private:
+    std::unique_ptr<message_base_t *[]> slots;
+    std::size_t mask;
+
+    /* consumer side */
+    alignas(64) std::atomic<std::size_t> head;
+    std::size_t cached_tail;
+
+    /* producer side */
+    alignas(64) std::atomic<std::size_t> tail;
+    std::size_t cached_head;
+};
+
+} // namespace rotor
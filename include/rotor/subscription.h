@@ -8,8 +8,7 @@
 
 #include "handler.hpp"
 #include "message.h"
-#include <typeindex>
-#include <map>
+#include <memory>
 #include <vector>
 
 namespace rotor {
@@ -17,8 +16,20 @@ namespace rotor {
 /** \struct subscription_t
  *  \brief Holds and classifies message handlers on behalf of supervisor
  *
- * The handlers are classified by message type and by the source supervisor, i.e.
- * whether the hander's supervisor is external or not.
+ * The handlers are classified by destination address, by message type and by the
+ * source supervisor, i.e. whether the hander's supervisor is external or not.
+ *
+ * The (address, message type) pairs are kept in the flat open-addressing
+ * hash table (linear probing, backward-shift deletion); as message types are
+ * dense integers, the keys are compared and hashed cheaply, so the recipients
+ * of a message are found via single probe sequence over contiguous memory.
+ * The recipients list of each pair is allocated separately, i.e. it is
+ * not moved when the table grows.
+ *
+ * The handlers of external supervisors are additionally grouped per supervisor
+ * into immutable batches, so a message is forwarded once to each external
+ * supervisor. A batch is copied on (un)subscription, as it might be still
+ * referenced by a forwarded message.
  *
  */
 struct subscription_t {
@@ -29,32 +40,82 @@ struct subscription_t {
     struct classified_handlers_t {
         /** \brief intrusive pointer to the handler */
         handler_ptr_t handler;
+        /** \brief devirtualized delivery function of the handler (copied from it) */
+        handler_base_t::thunk_t thunk;
         /** \brief true if the hanlder is local */
         bool mine;
     };
     /** \brief list of classified handlers */
     using list_t = std::vector<classified_handlers_t>;
 
+    /** \brief handlers batches of external supervisors, one batch per supervisor */
+    using foreign_list_t = std::vector<handlers_batch_ptr_t>;
+
     /** \brief alias for message type */
-    using slot_t = const void *;
+    using slot_t = message_type_t;
+
+    /** \struct entry_t
+     *  \brief recipients of the message type on the address
+     */
+    struct entry_t {
+        /** \brief the destination address */
+        address_ptr_t address;
+        /** \brief all handlers, subscribed to the (address, message type) pair */
+        list_t recipients;
+        /** \brief the handlers of external supervisors, grouped by supervisor */
+        foreign_list_t foreign;
+    };
 
     /** \brief constructor which takes the source @{link supervisor_t}  reference */
     subscription_t(supervisor_t &sup);
 
-    /** \brief records the subscription for the handler */
-    void subscribe(handler_ptr_t handler);
+    subscription_t(const subscription_t &) = delete;
+    subscription_t(subscription_t &&) = delete;
+
+    /** \brief records the subscription for the handler on the address */
+    void subscribe(const address_ptr_t &addr, handler_ptr_t handler);
 
-    /** \brief removes the recorded subscriptios and returns amount of left subscriptions */
-    std::size_t unsubscribe(handler_ptr_t handler);
+    /** \brief removes the recorded subscription of the handler on the address */
+    void unsubscribe(const address_ptr_t &addr, const handler_ptr_t &handler) noexcept;
 
-    /** \brief optioally returns classified list of subscribers to the message type */
-    list_t *get_recipients(const slot_t &slot) noexcept;
+    /** \brief optioally returns recipients of the message type on the address */
+    entry_t *get_entry(const address_t &addr, const slot_t &slot) noexcept;
+
+    /** \brief optioally returns recipients of the message */
+    inline entry_t *get_entry(const message_base_t &message) noexcept {
+        return get_entry(*message.address, message.type_index);
+    }
+
+    /** \brief optioally returns classified list of subscribers to the message type on the address */
+    inline list_t *get_recipients(const address_t &addr, const slot_t &slot) noexcept {
+        auto entry = get_entry(addr, slot);
+        return entry ? &entry->recipients : nullptr;
+    }
+
+    /** \brief optioally returns classified list of subscribers to the message */
+    inline list_t *get_recipients(const message_base_t &message) noexcept {
+        return get_recipients(*message.address, message.type_index);
+    }
+
+    /** \brief returns amount of subscribed (address, message type) pairs */
+    inline std::size_t size() const noexcept { return count; }
 
   private:
-    using map_t = std::map<slot_t, list_t>;
+    using entry_ptr_t = std::unique_ptr<entry_t>;
+
+    struct bucket_t {
+        const address_t *address;
+        slot_t slot;
+        entry_ptr_t entry;
+    };
+    using buckets_t = std::vector<bucket_t>;
+
+    std::size_t find(const address_t *addr, slot_t slot) const noexcept;
+    void grow();
 
     supervisor_t &supervisor;
-    map_t map;
+    buckets_t buckets;
+    std::size_t count;
 };
 
 } // namespace rotor
@@ -8,10 +8,15 @@
 
 #include "actor_base.h"
 #include "handler.hpp"
+#include "mailbox.h"
 #include "message.h"
 #include "messages.hpp"
+#include "message_queue.hpp"
+#include "mpsc_queue.hpp"
+#include "slab.hpp"
 #include "subscription.h"
 #include "system_context.h"
+#include "timer_wheel.h"
 #include "supervisor_config.h"
 #include "address_mapping.h"
 
@@ -70,10 +75,13 @@ intrusive_ptr_t<Actor> make_actor(Supervisor &sup, Args... args);
 struct supervisor_t : public actor_base_t {
 
     /** \brief timer identifier type in the scope of the supervisor */
-    using timer_id_t = std::uint32_t;
+    using timer_id_t = slab_key_t;
 
     /** \brief constructs new supervisor with optional parent supervisor */
     supervisor_t(supervisor_t *sup, const supervisor_config_t &config);
+
+    /** \brief withdraws the supervisor sub-queue from the locality leader turns */
+    ~supervisor_t();
     supervisor_t(const supervisor_t &) = delete;
     supervisor_t(supervisor_t &&) = delete;
 
@@ -83,7 +91,8 @@ struct supervisor_t : public actor_base_t {
      *
      * The locality leaders queue `queue` of messages is processed.
      *
-     * -# It takes message from the queue
+     * -# It takes message from the queue; the urgent messages (e.g. the actors
+     * initialization ones, see {@link payload_priority_t}) are taken first
      * -# If the message destination address belongs to the foreing the supervisor,
      * then it is forwarded to it immediately.
      * -# Otherwise, the message is local, i.e. either for the supervisor or one
@@ -93,6 +102,15 @@ struct supervisor_t : public actor_base_t {
      * the context  of current supervisor; in the latter case in the context
      * of other supervsior. In the both cases `deliver_local` method is used.
      *
+     * The {@link message_pool_t} of the locality leader is active during the
+     * processing, i.e. all messages created in the scope are recycled. The locality
+     * leader is also the current one for the thread (see `current_leader`).
+
+     * The processing stops, when the budget of the locality leader (see
+     * `supervisor_config_t::process_budget` and `process_time_budget`) is exhausted;
+     * then the next invocation is scheduled via `defer_process`. At least one message
+     * is processed per invocation.
+     *
      * It is expected, that derived classes should invoke `do_process` message,
      * whenever it is known that there are messages for processing. The invocation
      * should be performed in safe thread/loop context.
@@ -102,6 +120,10 @@ struct supervisor_t : public actor_base_t {
      */
     virtual void do_process() noexcept;
 
+    /** \brief returns the locality leader, which processes its messages (`do_process`)
+     * on the current thread, or `nullptr` */
+    static supervisor_t *current_leader() noexcept;
+
     /** \brief delivers an message for self of one of child-actors  (non-supervisors)
      *
      * Supervisor iterates on subscriptions (handlers) on the message destination adddress:
@@ -175,11 +197,15 @@ struct supervisor_t : public actor_base_t {
      * othewise, if it is no longer needed, it should be cancelled via
      * `cancel_timer` method
      *
+     * By default the timer is scheduled in the supervisor's {@link timer_wheel_t},
+     * and the single event-loop timer is (re)armed via `arm_timer` for the nearest
+     * deadline.
+     *
      */
-    virtual void start_timer(const pt::time_duration &send, timer_id_t timer_id) noexcept = 0;
+    virtual void start_timer(const pt::time_duration &send, timer_id_t timer_id) noexcept;
 
     /** \brief cancels previously started timer */
-    virtual void cancel_timer(timer_id_t timer_id) noexcept = 0;
+    virtual void cancel_timer(timer_id_t timer_id) noexcept;
 
     /** \brief triggers an action associated with the timer
      *
@@ -188,6 +214,15 @@ struct supervisor_t : public actor_base_t {
      */
     virtual void on_timer_trigger(timer_id_t timer_id);
 
+    /** \brief advances timer wheel and triggers all expired timers
+     *
+     * Should be invoked by the event-loop timer, armed via `arm_timer`, in
+     * the supervisor's thread/loop context. The event-loop timer is re-armed,
+     * if there are timers left.
+     *
+     */
+    void trigger_timers() noexcept;
+
     /** \brief thread-safe version of `do_process`
      *
      * Starts supervisor to processing messages queue in safe thread/loop
@@ -219,13 +254,47 @@ struct supervisor_t : public actor_base_t {
     /** \brief returns pointer to parent supervisor, may be NULL */
     inline supervisor_t *get_parent_supervisor() noexcept { return parent; }
 
+    /** \brief returns the maximum amount of messages, simultaneously held by the locality leader queue
+     * and the sub-queues of the supervisors in its locality
+     *
+     * The value can be used to tune `supervisor_config_t::queue_reserve`.
+     *
+     */
+    inline std::size_t get_queue_high_water_mark() const noexcept { return locality_leader->queue_peak; }
+
+    /** \brief returns amount of messages in the locality leader queue (and the sub-queues of
+     * the supervisors in its locality), i.e. taken, but not yet processed */
+    std::size_t get_queue_size() const noexcept;
+
+    /** \brief returns the mailbox of the locality leader, or `nullptr` if it is unbounded
+     *
+     * The mailbox accounts the messages from other localities, which are not yet taken
+     * into the leader queue, see `supervisor_config_t::mailbox_capacity`.
+     *
+     */
+    inline const mailbox_t *get_mailbox() const noexcept { return locality_leader->mailbox.get(); }
+
     /** \brief puts a message into internal supevisor queue for further processing
      *
      * This is thread-unsafe method. The `enqueue` method should be used to put
      * a new message from external context in thread-safe way.
      *
+     * Unless the locality leader uses `scheduling_t::fifo`, the regular message
+     * is put into the sub-queue of its destination supervisor (see `schedule`).
+     *
      */
-    inline void put(message_ptr_t message) { locality_leader->queue.emplace_back(std::move(message)); }
+    inline void put(message_ptr_t message) {
+        auto &leader = *locality_leader;
+        if (leader.scheduling == scheduling_t::fifo || message->urgent) {
+            leader.queue.emplace_back(std::move(message));
+        } else {
+            leader.schedule(std::move(message));
+        }
+        auto size = leader.queue.size() + leader.held;
+        if (size > leader.queue_peak) {
+            leader.queue_peak = size;
+        }
+    }
 
     /**
      * \brief subscribes an handler to an address.
@@ -240,8 +309,7 @@ struct supervisor_t : public actor_base_t {
      */
     inline void subscribe_actor(const address_ptr_t &addr, const handler_ptr_t &handler) {
         if (&addr->supervisor == &supervisor) {
-            auto subs_info = subscription_map.try_emplace(addr, *this);
-            subs_info.first->second.subscribe(handler);
+            subscription_map.subscribe(addr, handler);
             send<payload::subscription_confirmation_t>(handler->actor_ptr->get_address(), addr, handler);
         } else {
             send<payload::external_subscription_t>(addr->supervisor.address, addr, handler);
@@ -283,6 +351,30 @@ struct supervisor_t : public actor_base_t {
         return request_builder_t<T>(*this, actor, dest_addr, reply_to, std::forward<Args>(args)...);
     }
 
+    /** \brief convenient method for scatter-gather request building
+     *
+     * The requests are sent only after invoking `send(timeout)`
+     *
+     */
+    template <typename T> gather_builder_t<T> do_gather(actor_base_t &actor, const address_ptr_t &reply_to) noexcept {
+        return gather_builder_t<T>(*this, actor, reply_to);
+    }
+
+    /** \brief cancels pending request, made by one of supervisor's actors
+     *
+     * See {@link actor_base_t::cancel_request}.
+     *
+     */
+    bool do_cancel_request(request_id_t request_id) noexcept;
+
+    /** \brief re-targets the request message to the destination, if nobody else
+     * can observe the message
+     *
+     * See {@link actor_base_t::forward_request}.
+     *
+     */
+    bool do_forward_request(message_base_t &request, const address_ptr_t &destination) noexcept;
+
     /** \brief child actror housekeeping strcuture */
     struct actor_state_t {
         /** \brief intrusive pointer to actor */
@@ -298,21 +390,107 @@ struct supervisor_t : public actor_base_t {
     /** \brief creates new address with respect to supervisor locality mark */
     virtual address_ptr_t instantiate_address(const void *locality) noexcept;
 
-    /** \brief structure to hold messages (intrusive pointers) */
-    using queue_t = std::deque<message_ptr_t>;
+    /** \brief structure to hold messages (intrusive pointers), urgent ones first */
+    using queue_t = message_lanes_t;
 
-    /** \brief address-to-subscription map type */
-    using subscription_map_t = std::unordered_map<address_ptr_t, subscription_t>;
+    /** \brief (address, message type)-to-handlers map type */
+    using subscription_map_t = subscription_t;
 
     /** \brief (local) address-to-child_actor map type */
     using actors_map_t = std::unordered_map<address_ptr_t, actor_state_t>;
 
-    /** \brief timer to response with timeout procuder type */
-    using request_map_t = std::unordered_map<timer_id_t, request_curry_t>;
+    /** \brief request id (slab key) to response with timeout procuder type */
+    using request_map_t = slab_t<request_curry_t>;
+
+    /** \brief returns the address, where the responses of type `T` to the actor's requests are
+     * delivered first (i.e. before the timeout check and re-targeting to the actual reply address)
+     *
+     * The address and its handler is created once per actor and response type.
+     *
+     */
+    template <typename T> address_ptr_t get_imaginary_address(actor_base_t &actor) noexcept;
+
+    /** \brief delivers the response to the pending request
+     *
+     * The response to the regular request is re-targeted to the original reply address
+     * and put into the queue; the caller passes a copy if the response is shared. The
+     * response to scatter-gather request is recorded, and once all responses have arrived,
+     * the aggregate message is sent. The response is silently dropped if the request is
+     * not pending anymore (i.e. timed out or cancelled).
+     *
+     */
+    void deliver_response(message_base_t &response, request_id_t request_id, const message_base_t *request) noexcept;
 
     /** \brief removes actor from supervisor. It is assumed, that actor it shutted down. */
     virtual void remove_actor(actor_base_t &actor) noexcept;
 
+    /** \brief applies the mailbox overflow policy to the message from other locality,
+     * which is going to be enqueued; returns `false` if the message is dropped or rejected
+     *
+     * Should be invoked by `enqueue` implementations before handing the message over.
+     *
+     */
+    inline bool admit(message_ptr_t &message) noexcept {
+        auto &box = locality_leader->mailbox;
+        return !box || box->admit(message);
+    }
+
+    /** \brief moves the messages from other localities into the leader queue, releasing
+     * them from the mailbox (if any) */
+    void take_inbound(mpsc_queue_t &inbound) noexcept;
+
+    /** \brief releases the single message from other locality from the mailbox (if any);
+     * returns `false` if the message should be dropped */
+    inline bool take_inbound(const message_base_t &message) noexcept {
+        auto &box = locality_leader->mailbox;
+        if (!box) {
+            return true;
+        }
+        box->release(1);
+        return box->keep(message);
+    }
+
+    /** \brief (re)starts the single event-loop timer, which should invoke `trigger_timers`
+     * after the `delay`
+     *
+     * The previously armed event-loop timer (if any) should be discarded. The default
+     * implementation does nothing, i.e. loop-less supervisor is expected to invoke
+     * `trigger_timers` on its own.
+     *
+     */
+    virtual void arm_timer(const pt::time_duration &delay) noexcept;
+
+    /** \brief stops the event-loop timer, as there are no timers left */
+    virtual void disarm_timer() noexcept;
+
+    /** \brief puts the regular message into the sub-queue of its destination supervisor
+     * (or of the locality leader, if the destination is in other locality), and makes
+     * the sub-queue ready for processing
+     *
+     * It is invoked on the locality leader only.
+     *
+     */
+    void schedule(message_ptr_t &&message) noexcept;
+
+    /** \brief returns the next message to process: the urgent messages go first, then
+     * the ready sub-queues are served in turn
+     *
+     * It is invoked on the locality leader only; the queue should not be empty.
+     *
+     */
+    message_ptr_t take_next() noexcept;
+
+    /** \brief schedules the next `do_process` invocation, as the processing budget of
+     * the locality leader is exhausted, while there are unprocessed messages
+     *
+     * It is invoked on the locality leader only. The event-loop supervisors should
+     * let the loop serve the other events (I/O, timers) first. The default
+     * implementation does nothing, i.e. the loop-less supervisor is expected to
+     * invoke `do_process` again, while the queue is not empty.
+     *
+     */
+    virtual void defer_process() noexcept;
+
     /** \brief non-owning pointer to parent supervisor, `NULL` for root supervisor */
     supervisor_t *parent;
 
@@ -322,12 +500,12 @@ struct supervisor_t : public actor_base_t {
     /** \brief root supervisor for the locality */
     supervisor_t *locality_leader;
 
-    /** \brief queue of unprocessed messages */
+    /** \brief queue of unprocessed messages (the urgent and the regular lanes) */
     queue_t queue;
 
     /** \brief local and external subscriptions for the addresses generated by the supervisor
      *
-     * key: address, value: {@link subscription_t}
+     * key: (address, message type), value: list of handlers, see {@link subscription_t}
      *
      */
     subscription_map_t subscription_map;
@@ -335,10 +513,16 @@ struct supervisor_t : public actor_base_t {
     /** \brief local address to local actor (intrusive pointer) mapping */
     actors_map_t actors_map;
 
-    /** \brief counter for request/timer ids */
-    timer_id_t last_req_id;
+    /** \brief scheduled timers of the supervisor */
+    timer_wheel_t timers;
+
+    /** \brief the tick for which the event-loop timer is armed */
+    timer_wheel_t::tick_t armed_tick;
 
-    /** \brief timer to response with timeout procuder */
+    /** \brief temporal storage of the expired timer ids */
+    std::vector<timer_id_t> expired_timers;
+
+    /** \brief pending requests, the key is the request (and its timer) id */
     request_map_t request_map;
 
     /** \brief shutdown timeout value (copied from config) */
@@ -350,7 +534,52 @@ struct supervisor_t : public actor_base_t {
     /** \brief per-actor and per-message request tracking support */
     address_mapping_t address_mapping;
 
+    /** \brief messages storage recycler, owned by locality leader only */
+    message_pool_ptr_t message_pool;
+
+    /** \brief initial capacity of locality leader queue (copied from config) */
+    std::size_t queue_reserve;
+
+    /** \brief bounds the messages from other localities, owned by locality leader only */
+    mailbox_ptr_t mailbox;
+
+    /** \brief maximum amount of messages per `do_process` invocation (copied from config) */
+    std::size_t process_budget;
+
+    /** \brief maximum time of `do_process` invocation (copied from config) */
+    std::chrono::microseconds process_time_budget;
+
+    /** \brief how the locality leader picks the messages (copied from config) */
+    scheduling_t scheduling;
+
+    /** \brief amount of messages processed in turn for the supervisor (copied from config) */
+    std::size_t weight;
+
+    /** \brief amount of messages left to be processed in the current turn */
+    std::size_t quantum;
+
+    /** \brief whether the supervisor sub-queue is in the locality leader `ready` list */
+    bool scheduled;
+
+    /** \brief the supervisors with non-empty sub-queues in the order of their turns,
+     * owned by the locality leader only
+     *
+     * The pointers are non-owning (the leader is in its own list too), the supervisor
+     * withdraws itself upon destruction.
+     *
+     */
+    std::deque<supervisor_t *> ready;
+
+    /** \brief amount of messages in the sub-queues of the other supervisors of the
+     * locality, owned by the locality leader only */
+    std::size_t held;
+
+    /** \brief maximum amount of messages in the queue and in the sub-queues simultaneously,
+     * owned by the locality leader only */
+    std::size_t queue_peak;
+
     template <typename T> friend struct request_builder_t;
+    template <typename T> friend struct gather_builder_t;
     friend struct supervisor_behavior_t;
 };
 
@@ -442,53 +671,108 @@ intrusive_ptr_t<Actor> make_actor(Supervisor &sup, const pt::time_duration &time
     return actor;
 }
 
-template <typename T>
-template <typename... Args>
-request_builder_t<T>::request_builder_t(supervisor_t &sup_, actor_base_t &actor_, const address_ptr_t &destination_,
-                                        const address_ptr_t &reply_to_, Args &&... args)
-    : sup{sup_}, actor{actor_}, request_id{++sup.last_req_id}, destination{destination_}, reply_to{reply_to_},
-      do_install_handler{false} {
-    auto addr = sup.address_mapping.get_addr(actor_, response_message_t::message_type);
-    if (addr) {
-        imaginary_address = addr;
-    } else {
+template <typename T> address_ptr_t supervisor_t::get_imaginary_address(actor_base_t &actor) noexcept {
+    using response_message_t = typename request_traits_t<T>::response::message_t;
+    auto addr = address_mapping.get_addr(actor, response_message_t::message_type);
+    if (!addr) {
         // subscribe to imaginary address instead of real one because of
         // 1. faster dispatching
         // 2. need to distinguish between "timeout guarded responses" and "responses to own requests"
-        imaginary_address = sup.make_address();
-        do_install_handler = true;
+        addr = make_address();
+        auto handler = lambda<response_message_t>([supervisor = this](response_message_t &msg) {
+            auto request = static_cast<message_base_t *>(msg.payload.req.get());
+            if (msg.use_count() == 1) {
+                supervisor->deliver_response(msg, msg.payload.request_id(), request);
+            } else {
+                // the other owners of the response should not see it re-targeted
+                auto copy = make_message<typename response_message_t::payload_t>(msg.address, msg.payload);
+                supervisor->deliver_response(*copy, msg.payload.request_id(), request);
+            }
+        });
+        auto handler_ptr = subscribe(handler, addr);
+        address_mapping.set(actor, response_message_t::message_type, handler_ptr, addr);
     }
-    req.reset(new request_message_t{destination, request_id, imaginary_address, std::forward<Args>(args)...});
+    return addr;
 }
 
-template <typename T> std::uint32_t request_builder_t<T>::send(pt::time_duration timeout) noexcept {
-    if (do_install_handler) {
-        install_handler();
-    }
+template <typename T>
+template <typename... Args>
+request_builder_t<T>::request_builder_t(supervisor_t &sup_, actor_base_t &actor_, const address_ptr_t &destination_,
+                                        const address_ptr_t &reply_to_, Args &&... args)
+    : sup{sup_}, destination{destination_}, reply_to{reply_to_},
+      imaginary_address{sup.template get_imaginary_address<T>(actor_)} {
+    // the request id is assigned on send
+    req.reset(new request_message_t{destination, request_id_t{0}, imaginary_address, std::forward<Args>(args)...});
+}
+
+template <typename T> request_id_t request_builder_t<T>::send(pt::time_duration timeout) noexcept {
+    return dispatch(timeout, timer_wheel_t::deadline(timer_wheel_t::now(), timeout));
+}
+
+template <typename T> request_id_t request_builder_t<T>::send_within(const request_base_t &upstream) noexcept {
+    return dispatch(timer_wheel_t::timeout(timer_wheel_t::now(), upstream.deadline), upstream.deadline);
+}
+
+template <typename T>
+request_id_t request_builder_t<T>::dispatch(const pt::time_duration &timeout,
+                                             timer_wheel_t::tick_t deadline) noexcept {
     auto fn = &request_traits_t<T>::make_error_response;
-    sup.request_map.emplace(request_id, request_curry_t{fn, reply_to, req});
+    auto timed = deadline != timer_wheel_t::never;
+    auto request_id = sup.request_map.emplace(request_curry_t{fn, reply_to, req, nullptr, destination, timed});
+    req->payload.id = request_id;
+    req->payload.deadline = deadline;
     sup.put(req);
-    sup.start_timer(timeout, request_id);
+    if (timed) {
+        sup.start_timer(timeout, request_id);
+    }
     return request_id;
 }
 
-template <typename T> void request_builder_t<T>::install_handler() noexcept {
-    auto handler = lambda<response_message_t>([supervisor = &sup](response_message_t &msg) {
-        auto request_id = msg.payload.request_id();
-        auto it = supervisor->request_map.find(request_id);
-        if (it != supervisor->request_map.end()) {
-            supervisor->cancel_timer(request_id);
-            auto &orig_addr = it->second.reply_to;
-            supervisor->template send<wrapped_res_t>(orig_addr, msg.payload);
-            supervisor->request_map.erase(it);
-        }
-        // if a response to request has arrived and no timer can be found
-        // that means that either timeout timer already triggered
-        // and error-message already delivered or response is not expected.
-        // just silently drop it anyway
-    });
-    auto handler_ptr = sup.subscribe(handler, imaginary_address);
-    sup.address_mapping.set(actor, response_message_t::message_type, handler_ptr, imaginary_address);
+template <typename T>
+gather_builder_t<T>::gather_builder_t(supervisor_t &sup_, actor_base_t &actor_, const address_ptr_t &reply_to_)
+    : sup{sup_}, reply_to{reply_to_}, imaginary_address{sup.template get_imaginary_address<T>(actor_)},
+      gather{new gather_t<T>()} {}
+
+template <typename T>
+template <typename... Args>
+gather_builder_t<T> &gather_builder_t<T>::request(const address_ptr_t &destination, Args &&... args) {
+    auto req = new request_message_t{destination, request_id_t{0}, imaginary_address, std::forward<Args>(args)...};
+    gather->requests.emplace_back(req);
+    gather->destinations.emplace_back(destination);
+    return *this;
+}
+
+template <typename T> request_id_t gather_builder_t<T>::send(pt::time_duration timeout) noexcept {
+    return dispatch(timeout, timer_wheel_t::deadline(timer_wheel_t::now(), timeout));
+}
+
+template <typename T> request_id_t gather_builder_t<T>::send_within(const request_base_t &upstream) noexcept {
+    return dispatch(timer_wheel_t::timeout(timer_wheel_t::now(), upstream.deadline), upstream.deadline);
+}
+
+template <typename T>
+request_id_t gather_builder_t<T>::dispatch(const pt::time_duration &timeout, timer_wheel_t::tick_t deadline) noexcept {
+    auto count = gather->requests.size();
+    gather->responses.resize(count);
+    gather->pending = count;
+    auto timed = deadline != timer_wheel_t::never;
+    auto curry = request_curry_t{nullptr, reply_to, message_ptr_t{}, gather, address_ptr_t{}, timed};
+    auto request_id = sup.request_map.emplace(std::move(curry));
+    if (!count) {
+        sup.put(gather->complete(reply_to, make_error_code(error_code_t::success)));
+        sup.request_map.erase(request_id);
+        return request_id;
+    }
+    for (auto &req : gather->requests) {
+        auto &payload = static_cast<request_message_t &>(*req).payload;
+        payload.id = request_id;
+        payload.deadline = deadline;
+        sup.put(req);
+    }
+    if (timed) {
+        sup.start_timer(timeout, request_id);
+    }
+    return request_id;
 }
 
 /** \brief makes an reqest to the destination address with the message constructed from `args`
@@ -516,6 +800,12 @@ actor_base_t::request_via(const address_ptr_t &dest_addr, const address_ptr_t &r
     return supervisor.do_request<request_t>(*this, dest_addr, reply_addr, std::forward<Args>(args)...);
 }
 
+/** \brief returns scatter-gather request builder, the aggregate will be delivered to the actor's main address */
+template <typename Request> gather_builder_t<typename request_wrapper_t<Request>::request_t> actor_base_t::gather() {
+    using request_t = typename request_wrapper_t<Request>::request_t;
+    return supervisor.do_gather<request_t>(*this, address);
+}
+
 template <typename Request, typename... Args> void actor_base_t::reply_to(Request &message, Args &&... args) {
     using payload_t = typename Request::payload_t::request_t;
     using traits_t = request_traits_t<payload_t>;
@@ -524,6 +814,13 @@ template <typename Request, typename... Args> void actor_base_t::reply_to(Reques
     send<response_t>(message.payload.reply_to, request_ptr_t{&message}, std::forward<Args>(args)...);
 }
 
+template <typename Request> bool actor_base_t::forward_request(Request &message, const address_ptr_t &destination) {
+    using payload_t = typename Request::payload_t::request_t;
+    static_assert(std::is_same_v<Request, typename request_traits_t<payload_t>::request::message_t>,
+                  "request message is expected");
+    return supervisor.do_forward_request(message, destination);
+}
+
 template <typename Request, typename... Args>
 void actor_base_t::reply_with_error(Request &message, const std::error_code &ec) {
     using payload_t = typename Request::payload_t::request_t;
@@ -22,6 +22,36 @@ struct supervisor_config_t {
 
     /** \brief how to behave if child-actor fails */
     supervisor_policy_t policy = supervisor_policy_t::shutdown_self;
+
+    /** \brief whether locality leader should recycle messages storage via {@link message_pool_t} */
+    bool message_pool = true;
+
+    /** \brief amount of messages the locality leader queue holds without reallocation,
+     * see {@link message_queue_t} */
+    std::size_t queue_reserve = 0;
+
+    /** \brief maximum amount of messages from other localities, which are not yet taken
+     * by the locality leader; zero means unbounded mailbox (see {@link mailbox_t}) */
+    std::size_t mailbox_capacity = 0;
+
+    /** \brief what to do with the message from other locality, when the mailbox is full */
+    overflow_policy_t overflow_policy = overflow_policy_t::drop_newest;
+
+    /** \brief maximum amount of messages, processed by the locality leader per single
+     * `do_process` invocation; zero means unlimited */
+    std::size_t process_budget = 0;
+
+    /** \brief maximum time, spent by the locality leader in single `do_process`
+     * invocation; zero means unlimited */
+    pt::time_duration process_time_budget = pt::time_duration{};
+
+    /** \brief how the locality leader schedules the messages of the supervisors,
+     * which share the locality (see {@link scheduling_t}) */
+    scheduling_t scheduling = scheduling_t::fifo;
+
+    /** \brief amount of messages for the supervisor, processed in its turn
+     * (`scheduling_t::weighted`) */
+    std::size_t weight = 1;
 };
 
 } // namespace rotor
@@ -0,0 +1,129 @@
+#pragma once
+
+//
+// Copyright (c) 2019-2020 Ivan Baidakou (basiliscos) (the dot dmol at gmail dot com)
+//
+// Distributed under the MIT Software License
+//
+
+#include "slab.hpp"
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace rotor {
+
+namespace pt = boost::posix_time;
+
+/** \struct timer_wheel_t
+ *  \brief hashed hierarchical timer wheel
+ *
+ * The time is measured in ticks (milliseconds of monotonic clock). The wheel has
+ * `levels` levels of `slots` slots each; the level of a timer is determined by
+ * the highest differing digit (in base of `slots`) between the deadline and the
+ * current tick, i.e. the timers of the lower level slot are always due earlier.
+ * When the current tick reaches the start of higher level slot, its timers are
+ * cascaded down to lower levels. The timers, which are too far from the current
+ * tick, are kept in the overflow list and re-inserted on the top level wrap.
+ *
+ * Start and cancel are O(1); the timers are kept in the intrusive doubly-linked
+ * lists within a single vector of nodes, which is not shrunk, i.e. once the wheel
+ * reached its working size, it does not allocate.
+ *
+ * The timer ids are expected to be {@link slab_key_t} keys (e.g. request ids):
+ * the node of a timer is located directly by the slot index of its id, and the
+ * full id is kept in the node to tell apart stale ids. Hence, the ids of the
+ * simultaneously scheduled timers must have different slot indices.
+ *
+ * The wheel does not invoke any callbacks: the expired timer ids are just
+ * collected by `advance`. The earliest deadline is returned by `next_deadline`,
+ * which is used by supervisors to arm the single native (event loop) timer.
+ *
+ */
+struct timer_wheel_t {
+    /** \brief timer identifier type */
+    using timer_id_t = slab_key_t;
+
+    /** \brief absolute time in milliseconds of monotonic clock */
+    using tick_t = std::uint64_t;
+
+    /** \brief the tick, which is never reached */
+    static const constexpr tick_t never = std::numeric_limits<tick_t>::max();
+
+    timer_wheel_t() noexcept;
+    timer_wheel_t(const timer_wheel_t &) = delete;
+    timer_wheel_t(timer_wheel_t &&) = delete;
+
+    /** \brief returns the current tick of monotonic clock */
+    static tick_t now() noexcept;
+
+    /** \brief returns the deadline tick for the timeout, starting from `now` */
+    static tick_t deadline(tick_t now, const pt::time_duration &timeout) noexcept;
+
+    /** \brief returns the timeout, for which `deadline(now, timeout)` is the `deadline`
+     * tick, or zero if it is not possible (i.e. the deadline is too close or already passed);
+     * the timeout of `never` deadline is infinite */
+    static pt::time_duration timeout(tick_t now, tick_t deadline) noexcept;
+
+    /** \brief schedules the timer to expire at the `deadline` tick */
+    void start(timer_id_t timer_id, tick_t deadline);
+
+    /** \brief cancels the timer; returns `false` if there is no such timer */
+    bool cancel(timer_id_t timer_id) noexcept;
+
+    /** \brief moves the wheel up to `now` tick and appends the expired timers into `expired` */
+    void advance(tick_t now, std::vector<timer_id_t> &expired);
+
+    /** \brief returns the earliest tick, when `advance` has something to do (i.e.
+     * expire or cascade timers), or `never` if there are no timers */
+    tick_t next_tick() const noexcept;
+
+    /** \brief returns the earliest deadline, or `never` if there are no timers
+     *
+     * The timers of overflow list are not looked through, i.e. the tick of
+     * the overflow list re-insertion is returned for them.
+     *
+     */
+    tick_t next_deadline() const noexcept;
+
+    /** \brief returns amount of scheduled timers */
+    inline std::size_t size() const noexcept { return count; }
+
+    /** \brief returns `true` if there are no scheduled timers */
+    inline bool empty() const noexcept { return count == 0; }
+
+  private:
+    using index_t = std::uint32_t;
+    static const constexpr index_t npos = std::numeric_limits<index_t>::max();
+    static const constexpr unsigned bits = 6;
+    static const constexpr unsigned slots = 1 << bits;
+    static const constexpr unsigned levels = 4;
+    static const constexpr unsigned overflow_level = levels;
+    static const constexpr std::uint8_t idle_level = 0xFF;
+
+    struct node_t {
+        timer_id_t timer_id;
+        tick_t deadline;
+        index_t prev;
+        index_t next;
+        std::uint8_t level = idle_level;
+        std::uint8_t slot;
+    };
+
+    void link(index_t index, tick_t deadline, std::vector<timer_id_t> *expired);
+    void unlink(index_t index) noexcept;
+    void cascade(unsigned level, unsigned slot, std::vector<timer_id_t> &expired);
+    void expire(tick_t tick, std::vector<timer_id_t> &expired);
+    void release(index_t index, std::vector<timer_id_t> &expired) noexcept;
+    index_t &head(unsigned level, unsigned slot) noexcept;
+
+    tick_t current;
+    std::vector<node_t> nodes;
+    index_t heads[levels][slots];
+    std::uint64_t occupied[levels];
+    index_t overflow;
+    std::size_t count;
+};
+
+} // namespace rotor
@@ -11,8 +11,6 @@
 #include "rotor/wx/system_context_wx.h"
 #include <wx/event.h>
 #include <wx/timer.h>
-#include <memory>
-#include <unordered_map>
 
 namespace rotor {
 namespace wx {
@@ -47,16 +45,16 @@ struct supervisor_wx_t : public supervisor_t {
         /** \brief alias for intrusive pointer for the supervisor */
         using supervisor_ptr_t = intrusive_ptr_t<supervisor_wx_t>;
 
-        /** \brief timer identity */
-        timer_id_t timer_id;
+        /** \brief non-owning reference to the supervisor */
+        supervisor_wx_t &sup;
 
-        /** \brief intrusive pointer to the supervisor */
-        supervisor_ptr_t sup;
+        /** \brief intrusive pointer to the supervisor, which is held while the timer is running */
+        supervisor_ptr_t self;
 
         /** \brief constructs timer from wx supervisor */
-        timer_t(timer_id_t timer_id, supervisor_ptr_t &&sup_);
+        timer_t(supervisor_wx_t &sup_);
 
-        /** \brief invokes `shutdown_timer_trigger` method if shutdown timer triggers*/
+        /** \brief invokes `trigger_timers` method of the supervisor */
         virtual void Notify() noexcept override;
     };
 
@@ -79,25 +77,23 @@ struct supervisor_wx_t : public supervisor_t {
     virtual void start() noexcept override;
     virtual void shutdown() noexcept override;
     virtual void enqueue(message_ptr_t message) noexcept override;
-    virtual void start_timer(const pt::time_duration &send, timer_id_t timer_id) noexcept override;
-    virtual void cancel_timer(timer_id_t timer_id) noexcept override;
-    virtual void on_timer_trigger(timer_id_t timer_id) noexcept override;
 
     /** \brief returns pointer to the wx system context */
     inline system_context_wx_t *get_context() noexcept { return static_cast<system_context_wx_t *>(context); }
 
   protected:
-    /** \brief unique pointer to timer */
-    using timer_ptr_t = std::unique_ptr<timer_t>;
-
-    /** \brief timer id to timer pointer mapping type */
-    using timers_map_t = std::unordered_map<timer_id_t, timer_ptr_t>;
+    virtual void arm_timer(const pt::time_duration &delay) noexcept override;
+    virtual void disarm_timer() noexcept override;
+    virtual void defer_process() noexcept override;
 
     /** \brief non-owning pointer to the wx application (copied from config) */
     wxEvtHandler *handler;
 
-    /** \brief timer id to timer pointer mapping */
-    timers_map_t timers_map;
+    /** \brief the single timer, which wakes the supervisor up for its nearest timer deadline */
+    timer_t timer;
+
+    /** \brief whether the `do_process` invocation is already scheduled via `CallAfter` */
+    bool process_deferred;
 };
 
 } // namespace wx
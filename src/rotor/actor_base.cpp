@@ -37,6 +37,8 @@ void actor_base_t::do_initialize(system_context_t *) noexcept {
 
 void actor_base_t::do_shutdown() noexcept { send<payload::shutdown_trigger_t>(supervisor.get_address(), address); }
 
+bool actor_base_t::cancel_request(request_id_t request_id) noexcept { return supervisor.do_cancel_request(request_id); }
+
 address_ptr_t actor_base_t::create_address() noexcept { return supervisor.make_address(); }
 
 void actor_base_t::on_initialize(message::init_request_t &msg) noexcept {
@@ -10,13 +10,13 @@
 
 using namespace rotor;
 
-void address_mapping_t::set(actor_base_t &actor, const void *message, const handler_ptr_t &handler,
+void address_mapping_t::set(actor_base_t &actor, message_type_t message, const handler_ptr_t &handler,
                             const address_ptr_t &dest_addr) noexcept {
     auto &point_map = actor_map[static_cast<const void *>(&actor)];
     point_map.try_emplace(message, point_t{handler, dest_addr});
 }
 
-address_ptr_t address_mapping_t::get_addr(actor_base_t &actor, const void *message) noexcept {
+address_ptr_t address_mapping_t::get_addr(actor_base_t &actor, message_type_t message) noexcept {
     auto it_points = actor_map.find(static_cast<const void *>(&actor));
     if (it_points == actor_map.end()) {
         return address_ptr_t();
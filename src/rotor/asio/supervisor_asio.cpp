@@ -10,7 +10,7 @@
 using namespace rotor::asio;
 
 supervisor_asio_t::supervisor_asio_t(supervisor_t *sup, const supervisor_config_asio_t &config_)
-    : supervisor_t{sup, config_}, strand{config_.strand} {}
+    : supervisor_t{sup, config_}, timer{config_.strand->context()}, strand{config_.strand}, process_deferred{false} {}
 
 rotor::address_ptr_t supervisor_asio_t::make_address() noexcept { return instantiate_address(strand.get()); }
 
@@ -18,56 +18,76 @@ void supervisor_asio_t::start() noexcept { create_forwarder (&supervisor_asio_t:
 
 void supervisor_asio_t::shutdown() noexcept { create_forwarder (&supervisor_asio_t::do_shutdown)(); }
 
-void supervisor_asio_t::start_timer(const rotor::pt::time_duration &timeout, std::uint32_t timer_id) noexcept {
-    auto timer = std::make_unique<timer_t>(timer_id, get_asio_context().get_io_context());
-    timer->expires_from_now(timeout);
+void supervisor_asio_t::arm_timer(const rotor::pt::time_duration &delay) noexcept {
+    // re-arming discards the pending wait, its handler will get `operation_aborted`
+    boost::system::error_code ec;
+    timer.expires_from_now(delay, ec);
+    if (ec) {
+        return get_asio_context().on_error(ec);
+    }
 
     intrusive_ptr_t<supervisor_asio_t> self(this);
-    timer->async_wait([self = std::move(self), timer_id = timer_id](const boost::system::error_code &ec) {
+    timer.async_wait([self = std::move(self)](const boost::system::error_code &ec) {
         auto &strand = self->get_strand();
-        if (ec) {
-            asio::defer(strand, [self = std::move(self), timer_id = timer_id, ec = ec]() {
+        if (ec == asio::error::operation_aborted) {
+            return;
+        } else if (ec) {
+            asio::defer(strand, [self = std::move(self), ec = ec]() {
                 auto &sup = *self;
-                sup.timers_map.erase(timer_id);
-                sup.on_timer_error(timer_id, ec);
+                sup.on_timer_error(ec);
                 sup.do_process();
             });
         } else {
-            asio::defer(strand, [self = std::move(self), timer_id = timer_id]() {
+            asio::defer(strand, [self = std::move(self)]() {
                 auto &sup = *self;
-                sup.on_timer_trigger(timer_id);
-                sup.timers_map.erase(timer_id);
+                sup.trigger_timers();
                 sup.do_process();
             });
         }
     });
-    timers_map.emplace(timer_id, std::move(timer));
 }
 
-void supervisor_asio_t::cancel_timer(std::uint32_t timer_id) noexcept {
-    auto &timer = timers_map.at(timer_id);
+void supervisor_asio_t::disarm_timer() noexcept {
     boost::system::error_code ec;
-    timer->cancel(ec);
+    timer.cancel(ec);
     if (ec) {
         get_asio_context().on_error(ec);
     }
-    timers_map.erase(timer_id);
 }
 
-void supervisor_asio_t::on_timer_error(std::uint32_t, const boost::system::error_code &ec) noexcept {
+void supervisor_asio_t::defer_process() noexcept {
+    // the pending invocation will process the rest too
+    if (process_deferred) {
+        return;
+    }
+    process_deferred = true;
+    intrusive_ptr_t<supervisor_asio_t> self(this);
+    // post (not defer), so that the ready handlers are invoked first
+    asio::post(get_strand(), [self = std::move(self)]() {
+        auto &sup = *self;
+        sup.process_deferred = false;
+        sup.do_process();
+    });
+}
+
+void supervisor_asio_t::on_timer_error(const boost::system::error_code &ec) noexcept {
     if (ec != asio::error::operation_aborted) {
         get_asio_context().on_error(ec);
     }
 }
 
 void supervisor_asio_t::enqueue(rotor::message_ptr_t message) noexcept {
-    auto actor_ptr = supervisor_ptr_t(this);
-    // std::cout << "deferring on " << this << ", stopped : " << strand.get_io_context().stopped() << "\n";
-    asio::defer(get_strand(), [actor = std::move(actor_ptr), message = std::move(message)]() mutable {
-        auto &sup = *actor;
-        // std::cout << "deferred processing on" << &sup << "\n";
-        // sup.enqueue(std::move(message));
-        sup.put(std::move(message));
-        sup.do_process();
-    });
+    auto leader = static_cast<supervisor_asio_t *>(locality_leader);
+    if (!admit(message)) {
+        return;
+    }
+    // only the first message into empty inbound queue schedules the drain
+    if (leader->inbound.push(std::move(message))) {
+        auto actor_ptr = supervisor_ptr_t(leader);
+        asio::defer(leader->get_strand(), [actor = std::move(actor_ptr)]() {
+            auto &sup = *actor;
+            sup.take_inbound(sup.inbound);
+            sup.do_process();
+        });
+    }
 }
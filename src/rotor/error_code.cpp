@@ -23,6 +23,10 @@ std::string error_code_category::message(int c) const {
         return "service name is already registered";
     case error_code_t::unknown_service:
         return "the requested service name is not registered";
+    case error_code_t::request_cancelled:
+        return "request has been cancelled";
+    case error_code_t::request_rejected:
+        return "request has been rejected, as the destination is overloaded";
     default:
         return "unknown";
     }
@@ -17,61 +17,57 @@ void supervisor_ev_t::async_cb(struct ev_loop *, ev_async *w, int revents) noexc
     sup->on_async();
 }
 
-static void timer_cb(struct ev_loop *, ev_timer *w, int revents) noexcept {
+void supervisor_ev_t::timer_cb(struct ev_loop *, ev_timer *w, int revents) noexcept {
     assert(revents & EV_TIMER);
     (void)revents;
     auto *sup = static_cast<supervisor_ev_t *>(w->data);
-    auto timer = static_cast<supervisor_ev_t::timer_t *>(w);
-    sup->on_timer_trigger(timer->timer_id);
+    sup->trigger_timers();
     sup->do_process();
+    // the reference has been acquired in `arm_timer`
+    intrusive_ptr_release(sup);
+}
+
+void supervisor_ev_t::idle_cb(struct ev_loop *, ev_idle *w, int revents) noexcept {
+    assert(revents & EV_IDLE);
+    (void)revents;
+    auto *sup = static_cast<supervisor_ev_t *>(w->data);
+    ev_idle_stop(sup->loop, w);
+    sup->do_process();
+    // the reference has been acquired in `defer_process`
+    intrusive_ptr_release(sup);
 }
 
 supervisor_ev_t::supervisor_ev_t(supervisor_ev_t *parent_, const supervisor_config_ev_t &config_)
     : supervisor_t{parent_, config_}, loop{config_.loop}, loop_ownership{config_.loop_ownership}, pending{false} {
     ev_async_init(&async_watcher, async_cb);
+    ev_timer_init(&timer_watcher, timer_cb, 0., 0.);
+    ev_idle_init(&idle_watcher, idle_cb);
 
     async_watcher.data = this;
+    timer_watcher.data = this;
+    idle_watcher.data = this;
 
     ev_async_start(loop, &async_watcher);
 }
 
 void supervisor_ev_t::enqueue(rotor::message_ptr_t message) noexcept {
-    bool ok{false};
-    try {
-        auto leader = static_cast<supervisor_ev_t *>(locality_leader);
-        auto &inbound = leader->inbound;
-        std::lock_guard<std::mutex> lock(leader->inbound_mutex);
-        if (!leader->pending) {
-            // async events are "compressed" by EV. Need to do only once
-            intrusive_ptr_add_ref(this);
-        }
-        inbound.emplace_back(std::move(message));
-        ok = true;
-    } catch (const std::system_error &err) {
-        context->on_error(err.code());
+    auto leader = static_cast<supervisor_ev_t *>(locality_leader);
+    if (!admit(message)) {
+        return;
     }
-
-    if (ok) {
-        ev_async_send(loop, &async_watcher);
+    // only the producer, which found the queue empty, might need to wake up the leader
+    if (leader->inbound.push(std::move(message)) && !leader->pending.exchange(true)) {
+        // async events are "compressed" by EV. Need to do only once
+        intrusive_ptr_add_ref(leader);
+        ev_async_send(leader->loop, &leader->async_watcher);
     }
 }
 
 void supervisor_ev_t::start() noexcept {
-    bool ok{false};
-    try {
-        auto leader = static_cast<supervisor_ev_t *>(locality_leader);
-        std::lock_guard<std::mutex> lock(leader->inbound_mutex);
-        if (!leader->pending) {
-            leader->pending = true;
-            intrusive_ptr_add_ref(leader);
-        }
-        ok = true;
-    } catch (const std::system_error &err) {
-        context->on_error(err.code());
-    }
-
-    if (ok) {
-        ev_async_send(loop, &async_watcher);
+    auto leader = static_cast<supervisor_ev_t *>(locality_leader);
+    if (!leader->pending.exchange(true)) {
+        intrusive_ptr_add_ref(leader);
+        ev_async_send(leader->loop, &leader->async_watcher);
     }
 }
 
@@ -84,51 +80,40 @@ void supervisor_ev_t::shutdown() noexcept {
     supervisor.enqueue(make_message<payload::shutdown_trigger_t>(supervisor.get_address(), address));
 }
 
-void supervisor_ev_t::start_timer(const rotor::pt::time_duration &timeout, timer_id_t timer_id) noexcept {
-    auto timer = std::make_unique<timer_t>();
-    auto timer_ptr = timer.get();
-    ev_tstamp ev_timeout = static_cast<ev_tstamp>(timeout.total_nanoseconds()) / 1000000000;
-    ev_timer_init(timer_ptr, timer_cb, ev_timeout, 0);
-    timer_ptr->timer_id = timer_id;
-    timer_ptr->data = this;
-
-    ev_timer_start(loop, timer_ptr);
-    intrusive_ptr_add_ref(this);
-    timers_map.emplace(timer_id, std::move(timer));
+void supervisor_ev_t::arm_timer(const rotor::pt::time_duration &delay) noexcept {
+    // the supervisor is kept alive while the watcher is active
+    if (ev_is_active(&timer_watcher)) {
+        ev_timer_stop(loop, &timer_watcher);
+    } else {
+        intrusive_ptr_add_ref(this);
+    }
+    ev_tstamp ev_timeout = static_cast<ev_tstamp>(delay.total_nanoseconds()) / 1000000000;
+    ev_timer_set(&timer_watcher, ev_timeout, 0.);
+    ev_timer_start(loop, &timer_watcher);
 }
 
-void supervisor_ev_t::cancel_timer(timer_id_t timer_id) noexcept {
-    auto &timer = timers_map.at(timer_id);
-    ev_timer_stop(loop, timer.get());
-    timers_map.erase(timer_id);
-    intrusive_ptr_release(this);
+void supervisor_ev_t::disarm_timer() noexcept {
+    if (ev_is_active(&timer_watcher)) {
+        ev_timer_stop(loop, &timer_watcher);
+        intrusive_ptr_release(this);
+    }
 }
 
-void supervisor_ev_t::on_timer_trigger(timer_id_t timer_id) noexcept {
-    intrusive_ptr_release(this);
-    timers_map.erase(timer_id);
-    supervisor_t::on_timer_trigger(timer_id);
+void supervisor_ev_t::defer_process() noexcept {
+    // the supervisor is kept alive while the watcher is active
+    if (!ev_is_active(&idle_watcher)) {
+        intrusive_ptr_add_ref(this);
+        ev_idle_start(loop, &idle_watcher);
+    }
 }
 
 void supervisor_ev_t::on_async() noexcept {
-    bool ok{false};
-    try {
-        auto leader = static_cast<supervisor_ev_t *>(locality_leader);
-        auto &inbound = leader->inbound;
-        auto &queue = leader->queue;
-        std::lock_guard<std::mutex> lock(leader->inbound_mutex);
-        std::move(inbound.begin(), inbound.end(), std::back_inserter(queue));
-        inbound.clear();
-        leader->pending = false;
-        intrusive_ptr_release(leader);
-        ok = true;
-    } catch (const std::system_error &err) {
-        context->on_error(err.code());
-    }
-
-    if (ok) {
-        do_process();
-    }
+    auto leader = static_cast<supervisor_ev_t *>(locality_leader);
+    // reset the flag before draining, so that messages pushed after the drain will notify again
+    leader->pending.store(false);
+    take_inbound(leader->inbound);
+    intrusive_ptr_release(leader);
+    do_process();
 }
 
 supervisor_ev_t::~supervisor_ev_t() {
@@ -0,0 +1,76 @@
+//
+// Copyright (c) 2019-2020 Ivan Baidakou (basiliscos) (the dot dmol at gmail dot com)
+//
+// Distributed under the MIT Software License
+//
+
+#include "rotor/mailbox.h"
+#include "rotor/supervisor.h"
+#include <assert.h>
+
+using namespace rotor;
+
+mailbox_t::mailbox_t(std::size_t capacity_, overflow_policy_t policy_) noexcept
+    : capacity{capacity_}, policy{policy_}, depth{0}, excess{0}, dropped{0}, rejected{0}, waiters{0} {
+    assert(capacity && "mailbox capacity should be positive");
+}
+
+bool mailbox_t::reserve() noexcept {
+    if (depth.fetch_add(1) < capacity) {
+        return true;
+    }
+    depth.fetch_sub(1);
+    return false;
+}
+
+bool mailbox_t::admit(message_ptr_t &message) noexcept {
+    if (message->control) {
+        ++depth;
+        return true;
+    }
+    switch (policy) {
+    case overflow_policy_t::drop_oldest:
+        if (depth.fetch_add(1) >= capacity) {
+            ++excess;
+        }
+        return true;
+    case overflow_policy_t::block:
+        while (!reserve()) {
+            std::unique_lock<std::mutex> lock(mutex);
+            ++waiters;
+            room.wait(lock, [&]() { return depth.load() < capacity; });
+            --waiters;
+        }
+        return true;
+    case overflow_policy_t::reject:
+        if (reserve()) {
+            return true;
+        }
+        if (auto reply = message->reject(make_error_code(error_code_t::request_rejected)); reply) {
+            // the producer supervisor (if any) routes the reply, as any other message of
+            // its own, i.e. the producer thread does not enqueue it to other localities
+            if (auto producer = supervisor_t::current_leader(); producer) {
+                producer->put(std::move(reply));
+            } else {
+                reply->address->supervisor.enqueue(std::move(reply));
+            }
+        }
+        ++rejected;
+        break;
+    default:
+        if (reserve()) {
+            return true;
+        }
+        ++dropped;
+    }
+    message.reset();
+    return false;
+}
+
+void mailbox_t::release(std::size_t count) noexcept {
+    depth.fetch_sub(count);
+    if (waiters.load()) {
+        std::lock_guard<std::mutex> lock(mutex);
+        room.notify_all();
+    }
+}
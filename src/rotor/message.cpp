@@ -0,0 +1,16 @@
+//
+// Copyright (c) 2019-2020 Ivan Baidakou (basiliscos) (the dot dmol at gmail dot com)
+//
+// Distributed under the MIT Software License
+//
+
+#include "rotor/message.h"
+#include <atomic>
+
+namespace {
+
+std::atomic<rotor::message_type_t> last_message_type{0};
+
+} // namespace
+
+rotor::message_type_t rotor::details::register_message_type() noexcept { return ++last_message_type; }
@@ -0,0 +1,113 @@
+//
+// Copyright (c) 2019-2020 Ivan Baidakou (basiliscos) (the dot dmol at gmail dot com)
+//
+// Distributed under the MIT Software License
+//
+
+#include "rotor/message_pool.h"
+#include <new>
+
+using namespace rotor;
+
+namespace {
+
+struct alignas(alignof(std::max_align_t)) header_t {
+    message_pool_t *pool;
+    std::size_t size_class;
+};
+
+thread_local message_pool_t *active_pool = nullptr;
+
+} // namespace
+
+message_pool_t::scope_t::scope_t(message_pool_t *pool) noexcept : prev{active_pool} { active_pool = pool; }
+
+message_pool_t::scope_t::~scope_t() { active_pool = prev; }
+
+message_pool_t::message_pool_t() noexcept {
+    for (std::size_t i = 0; i < classes_count; ++i) {
+        local[i] = nullptr;
+        remote[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+message_pool_t::~message_pool_t() {
+    for (auto chunk : chunks) {
+        ::operator delete(chunk);
+    }
+}
+
+message_pool_t *message_pool_t::current() noexcept { return active_pool; }
+
+void *message_pool_t::allocate(std::size_t size) {
+    auto full_size = size + sizeof(header_t);
+    auto pool = active_pool;
+    header_t *header;
+    if (pool && full_size <= max_block_size) {
+        std::size_t size_class = 0;
+        while ((min_block_size << size_class) < full_size) {
+            ++size_class;
+        }
+        header = static_cast<header_t *>(pool->take(size_class));
+        header->size_class = size_class;
+        intrusive_ptr_add_ref(pool);
+    } else {
+        header = static_cast<header_t *>(::operator new(full_size));
+        pool = nullptr;
+    }
+    header->pool = pool;
+    return header + 1;
+}
+
+void message_pool_t::deallocate(void *ptr) noexcept {
+    if (!ptr) {
+        return;
+    }
+    auto header = static_cast<header_t *>(ptr) - 1;
+    auto pool = header->pool;
+    if (!pool) {
+        ::operator delete(header);
+        return;
+    }
+
+    auto size_class = header->size_class;
+    auto block = reinterpret_cast<block_t *>(header);
+    if (pool == active_pool) {
+        block->next = pool->local[size_class];
+        pool->local[size_class] = block;
+    } else {
+        auto &head = pool->remote[size_class];
+        block->next = head.load(std::memory_order_relaxed);
+        while (!head.compare_exchange_weak(block->next, block, std::memory_order_release, std::memory_order_relaxed))
+            ;
+    }
+    intrusive_ptr_release(pool);
+}
+
+void *message_pool_t::take(std::size_t size_class) {
+    auto &head = local[size_class];
+    if (!head) {
+        head = remote[size_class].exchange(nullptr, std::memory_order_acquire);
+    }
+    if (!head) {
+        refill(size_class);
+    }
+    auto block = head;
+    head = block->next;
+    return block;
+}
+
+void message_pool_t::refill(std::size_t size_class) {
+    auto block_size = min_block_size << size_class;
+    chunks.reserve(chunks.size() + 1);
+    auto chunk = static_cast<char *>(::operator new(chunk_size));
+    chunks.push_back(chunk);
+
+    block_t *head = nullptr;
+    for (auto i = chunk_size / block_size; i > 0; --i) {
+        auto block = reinterpret_cast<block_t *>(chunk + (i - 1) * block_size);
+        block->next = head;
+        head = block;
+    }
+    local[size_class] = head;
+}
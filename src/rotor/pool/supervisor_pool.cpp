@@ -0,0 +1,96 @@
+//
+// Copyright (c) 2019-2020 Ivan Baidakou (basiliscos) (the dot dmol at gmail dot com)
+//
+// Distributed under the MIT Software License
+//
+
+#include "rotor/pool/supervisor_pool.h"
+#include <chrono>
+
+using namespace rotor::pool;
+
+supervisor_pool_t::supervisor_pool_t(supervisor_pool_t *parent_, const supervisor_config_pool_t &config_)
+    : supervisor_t{parent_, config_}, own_locality{config_.own_locality || !parent_}, run_state{run_state_t::idle},
+      armed{false}, has_due{false} {
+    // the blocked producer might be the worker, which has to process the supervisor
+    if (mailbox && mailbox->get_policy() == overflow_policy_t::block) {
+        mailbox.reset(new mailbox_t(config_.mailbox_capacity, overflow_policy_t::drop_newest));
+    }
+}
+
+rotor::address_ptr_t supervisor_pool_t::make_address() noexcept {
+    if (!own_locality) {
+        return instantiate_address(parent->get_address()->locality);
+    }
+    return instantiate_address(this);
+}
+
+void supervisor_pool_t::start() noexcept { static_cast<supervisor_pool_t *>(locality_leader)->notify(); }
+
+void supervisor_pool_t::shutdown() noexcept {
+    supervisor.enqueue(make_message<payload::shutdown_trigger_t>(supervisor.get_address(), address));
+}
+
+void supervisor_pool_t::enqueue(rotor::message_ptr_t message) noexcept {
+    auto leader = static_cast<supervisor_pool_t *>(locality_leader);
+    if (!admit(message)) {
+        return;
+    }
+    // only the producer, which found the queue empty, might need to schedule the locality
+    if (leader->inbound.push(std::move(message))) {
+        leader->notify();
+    }
+}
+
+void supervisor_pool_t::shutdown_finish() noexcept {
+    supervisor_t::shutdown_finish();
+    if (!parent) {
+        get_pool_context().stop();
+    }
+}
+
+void supervisor_pool_t::arm_timer(const rotor::pt::time_duration &delay) noexcept {
+    get_pool_context().arm(*this, std::chrono::microseconds{delay.total_microseconds()});
+}
+
+void supervisor_pool_t::disarm_timer() noexcept { get_pool_context().disarm(*this); }
+
+void supervisor_pool_t::defer_process() noexcept {
+    // the locality is being processed, so it is just re-scheduled after that
+    notify();
+}
+
+void supervisor_pool_t::notify() noexcept {
+    auto state = run_state.load();
+    while (true) {
+        if (state == run_state_t::idle) {
+            if (run_state.compare_exchange_weak(state, run_state_t::scheduled)) {
+                get_pool_context().schedule(supervisor_ptr_t{this});
+                return;
+            }
+        } else if (state == run_state_t::running) {
+            if (run_state.compare_exchange_weak(state, run_state_t::notified)) {
+                return;
+            }
+        } else {
+            // already scheduled or will be re-scheduled
+            return;
+        }
+    }
+}
+
+void supervisor_pool_t::process() noexcept {
+    if (has_due.load()) {
+        std::vector<supervisor_ptr_t> expired;
+        {
+            std::lock_guard<std::mutex> lock(get_pool_context().mutex);
+            expired.swap(due);
+            has_due.store(false);
+        }
+        for (auto &sup : expired) {
+            sup->trigger_timers();
+        }
+    }
+    take_inbound(inbound);
+    do_process();
+}
@@ -0,0 +1,198 @@
+//
+// Copyright (c) 2019-2020 Ivan Baidakou (basiliscos) (the dot dmol at gmail dot com)
+//
+// Distributed under the MIT Software License
+//
+
+#include "rotor/pool/system_context_pool.h"
+#include "rotor/pool/supervisor_pool.h"
+#include <limits>
+
+using namespace rotor::pool;
+
+namespace {
+
+const auto never = std::numeric_limits<system_context_pool_t::clock_t::rep>::max();
+
+/* the pool and the worker index of the current thread, if it is a pool thread */
+struct current_worker_t {
+    system_context_pool_t *context;
+    std::size_t index;
+};
+
+thread_local current_worker_t current = {nullptr, 0};
+
+} // namespace
+
+system_context_pool_t::system_context_pool_t(std::size_t threads)
+    : deadline{never}, pending{0}, sleepers{0}, steals{0}, stopped{false} {
+    threads = std::max(threads, std::size_t{1});
+    for (std::size_t i = 0; i < threads; ++i) {
+        workers.emplace_back(new worker_t());
+    }
+}
+
+void system_context_pool_t::run() noexcept {
+    std::vector<std::thread> threads;
+    for (std::size_t i = 1; i < workers.size(); ++i) {
+        threads.emplace_back([this, i]() { work(i); });
+    }
+    work(0);
+    for (auto &thread : threads) {
+        thread.join();
+    }
+}
+
+void system_context_pool_t::stop() noexcept {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopped = true;
+    wakeup.notify_all();
+}
+
+void system_context_pool_t::schedule(supervisor_ptr_t &&unit) noexcept {
+    if (current.context == this) {
+        auto &worker = *workers[current.index];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.units.emplace_back(std::move(unit));
+    } else {
+        std::lock_guard<std::mutex> lock(mutex);
+        injected.emplace_back(std::move(unit));
+    }
+    // the sleeper checks `pending` after it has been counted, so it either
+    // sees the unit or it is woken up
+    pending.fetch_add(1);
+    if (sleepers.load()) {
+        std::lock_guard<std::mutex> lock(mutex);
+        wakeup.notify_one();
+    }
+}
+
+supervisor_ptr_t system_context_pool_t::take(std::size_t index) noexcept {
+    supervisor_ptr_t unit;
+    {
+        auto &worker = *workers[index];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        if (!worker.units.empty()) {
+            unit = std::move(worker.units.front());
+            worker.units.pop_front();
+        }
+    }
+    if (!unit) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!injected.empty()) {
+            unit = std::move(injected.front());
+            injected.pop_front();
+        }
+    }
+    // the victims are the other workers, starting from the neighbour; the
+    // stolen unit is the "coldest" one
+    for (std::size_t i = 1; !unit && i < workers.size(); ++i) {
+        auto &victim = *workers[(index + i) % workers.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.units.empty()) {
+            unit = std::move(victim.units.back());
+            victim.units.pop_back();
+            steals.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    if (unit) {
+        pending.fetch_sub(1);
+    }
+    return unit;
+}
+
+void system_context_pool_t::process(supervisor_ptr_t &&unit) noexcept {
+    using state_t = supervisor_pool_t::run_state_t;
+    auto &sup = *unit;
+    sup.run_state.store(state_t::running);
+    sup.process();
+    auto state = state_t::running;
+    if (!sup.run_state.compare_exchange_strong(state, state_t::idle)) {
+        // notified during processing (new messages, timers or exhausted budget)
+        sup.run_state.store(state_t::scheduled);
+        schedule(std::move(unit));
+    }
+}
+
+void system_context_pool_t::work(std::size_t index) noexcept {
+    current = current_worker_t{this, index};
+    while (true) {
+        if (deadline.load() <= clock_t::now().time_since_epoch().count()) {
+            fire_timers();
+        }
+        if (auto unit = take(index)) {
+            process(std::move(unit));
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(mutex);
+        if (stopped) {
+            break;
+        }
+        sleepers.fetch_add(1);
+        // the new nearest timer deadline wakes up the sleeper too
+        auto seen = deadline.load();
+        auto ready = [this, seen]() { return stopped || pending.load() > 0 || deadline.load() != seen; };
+        if (timers.empty()) {
+            wakeup.wait(lock, ready);
+        } else {
+            // the timer might be removed, while the worker waits for it
+            auto until = timers.begin()->first;
+            wakeup.wait_until(lock, until, ready);
+        }
+        sleepers.fetch_sub(1);
+    }
+    current = current_worker_t{nullptr, 0};
+}
+
+void system_context_pool_t::fire_timers() noexcept {
+    std::vector<supervisor_ptr_t> leaders;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto now = clock_t::now();
+        while (!timers.empty() && timers.begin()->first <= now) {
+            auto sup = std::move(timers.begin()->second);
+            timers.erase(timers.begin());
+            sup->armed = false;
+            auto leader = static_cast<supervisor_pool_t *>(sup->locality_leader);
+            leader->due.emplace_back(std::move(sup));
+            leader->has_due.store(true);
+            leaders.emplace_back(leader);
+        }
+        deadline.store(timers.empty() ? never : timers.begin()->first.time_since_epoch().count());
+    }
+    for (auto &leader : leaders) {
+        leader->notify();
+    }
+}
+
+void system_context_pool_t::arm(supervisor_pool_t &sup, const clock_t::duration &delay) noexcept {
+    supervisor_ptr_t self;
+    std::lock_guard<std::mutex> lock(mutex);
+    if (sup.armed) {
+        // the reference is re-used by the new timer
+        self = std::move(sup.timer_it->second);
+        timers.erase(sup.timer_it);
+    } else {
+        self.reset(&sup);
+    }
+    auto at = clock_t::now() + delay;
+    sup.timer_it = timers.emplace(at, std::move(self));
+    sup.armed = true;
+    auto nearest = timers.begin()->first.time_since_epoch().count();
+    if (deadline.exchange(nearest) != nearest) {
+        // the sleeping workers should wait for the new deadline
+        wakeup.notify_one();
+    }
+}
+
+void system_context_pool_t::disarm(supervisor_pool_t &sup) noexcept {
+    // the timer reference is released outside of the lock
+    supervisor_ptr_t self;
+    std::lock_guard<std::mutex> lock(mutex);
+    if (sup.armed) {
+        sup.armed = false;
+        self = std::move(sup.timer_it->second);
+        timers.erase(sup.timer_it);
+        deadline.store(timers.empty() ? never : timers.begin()->first.time_since_epoch().count());
+    }
+}
@@ -0,0 +1,110 @@
+//
+// Copyright (c) 2019-2020 Ivan Baidakou (basiliscos) (the dot dmol at gmail dot com)
+//
+// Distributed under the MIT Software License
+//
+
+#include "rotor/shard/supervisor_shard.h"
+
+using namespace rotor::shard;
+
+supervisor_shard_t::supervisor_shard_t(supervisor_shard_t *parent_, const supervisor_config_shard_t &config_)
+    : supervisor_t{parent_, config_}, shard{parent_ ? parent_->shard : config_.shard}, armed{false} {
+    // the blocked producer might be the very shard thread, or the one the shard waits for
+    if (mailbox && mailbox->get_policy() == overflow_policy_t::block) {
+        mailbox.reset(new mailbox_t(config_.mailbox_capacity, overflow_policy_t::drop_newest));
+    }
+}
+
+rotor::address_ptr_t supervisor_shard_t::make_address() noexcept {
+    // the whole shard is the single locality
+    if (parent) {
+        return instantiate_address(parent->get_address()->locality);
+    }
+    return instantiate_address(this);
+}
+
+void supervisor_shard_t::start() noexcept { get_shard_context().wake(shard); }
+
+void supervisor_shard_t::shutdown() noexcept {
+    supervisor.enqueue(make_message<payload::shutdown_trigger_t>(supervisor.get_address(), address));
+}
+
+void supervisor_shard_t::enqueue(rotor::message_ptr_t message) noexcept {
+    if (!admit(message)) {
+        return;
+    }
+    get_shard_context().send(shard, std::move(message));
+}
+
+void supervisor_shard_t::shutdown_finish() noexcept {
+    supervisor_t::shutdown_finish();
+    if (!parent) {
+        get_shard_context().on_shard_finished();
+    }
+}
+
+void supervisor_shard_t::arm_timer(const rotor::pt::time_duration &delay) noexcept {
+    auto &timers = get_shard_context().shards[shard]->timers;
+    supervisor_ptr_t self;
+    if (armed) {
+        // the reference is re-used by the new timer
+        self = std::move(timer_it->second);
+        timers.erase(timer_it);
+    } else {
+        self.reset(this);
+    }
+    auto at = system_context_shard_t::clock_t::now() + std::chrono::microseconds{delay.total_microseconds()};
+    timer_it = timers.emplace(at, std::move(self));
+    armed = true;
+}
+
+void supervisor_shard_t::disarm_timer() noexcept {
+    if (armed) {
+        armed = false;
+        auto self = std::move(timer_it->second);
+        get_shard_context().shards[shard]->timers.erase(timer_it);
+    }
+}
+
+bool supervisor_shard_t::poll() noexcept {
+    auto &slot = *get_shard_context().shards[shard];
+    bool busy = false;
+
+    // the messages from the other shards are released from the mailbox one by one
+    struct sink_t {
+        supervisor_shard_t &sup;
+        void emplace_back(message_ptr_t &&message) noexcept {
+            if (sup.take_inbound(*message)) {
+                sup.put(std::move(message));
+            }
+        }
+    } sink{*this};
+    for (auto &ring : slot.rings) {
+        if (ring && ring->pop_all(sink)) {
+            busy = true;
+        }
+    }
+    if (!inbound.empty()) {
+        take_inbound(inbound);
+        busy = true;
+    }
+
+    auto &timers = slot.timers;
+    if (!timers.empty()) {
+        auto now = system_context_shard_t::clock_t::now();
+        while (!timers.empty() && timers.begin()->first <= now) {
+            auto sup = std::move(timers.begin()->second);
+            timers.erase(timers.begin());
+            sup->armed = false;
+            sup->trigger_timers();
+            busy = true;
+        }
+    }
+
+    if (!queue.empty() || !ready.empty()) {
+        do_process();
+        busy = true;
+    }
+    return busy;
+}
@@ -0,0 +1,188 @@
+//
+// Copyright (c) 2019-2020 Ivan Baidakou (basiliscos) (the dot dmol at gmail dot com)
+//
+// Distributed under the MIT Software License
+//
+
+#include "rotor/shard/system_context_shard.h"
+#include "rotor/shard/supervisor_shard.h"
+#include <thread>
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+using namespace rotor::shard;
+
+namespace {
+
+/* the shards context and the shard index of the current thread, if it is a shard thread */
+struct current_shard_t {
+    system_context_shard_t *context;
+    std::size_t index;
+};
+
+thread_local current_shard_t current = {nullptr, 0};
+
+void pin(std::size_t index) noexcept {
+#if defined(__linux__)
+    auto cores = std::thread::hardware_concurrency();
+    if (!cores) {
+        return;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(index % cores, &set);
+    // best effort, i.e. the restricted affinity of the process is not an error
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void)index;
+#endif
+}
+
+} // namespace
+
+system_context_shard_t::system_context_shard_t(std::size_t shards_count, std::size_t ring_capacity,
+                                               std::size_t idle_spins_, bool pin_threads_)
+    : idle_spins{idle_spins_}, pin_threads{pin_threads_}, running{0}, stopped{false}, backlogged{0}, dropped{0} {
+    for (std::size_t i = 0; i < shards_count; ++i) {
+        auto shard = new shard_t();
+        shard->rings.resize(shards_count);
+        shard->backlogs.resize(shards_count);
+        for (std::size_t sender = 0; sender < shards_count; ++sender) {
+            if (sender != i) {
+                shard->rings[sender].reset(new spsc_ring_t(ring_capacity));
+            }
+        }
+        shards.emplace_back(shard);
+    }
+}
+
+supervisor_ptr_t system_context_shard_t::get_supervisor(std::size_t shard) noexcept {
+    return shards[shard]->supervisor;
+}
+
+void system_context_shard_t::run() noexcept {
+    std::size_t roots = 0;
+    for (auto &shard : shards) {
+        roots += shard->supervisor ? 1 : 0;
+    }
+    running.store(roots);
+    if (!roots) {
+        return;
+    }
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < shards.size(); ++i) {
+        threads.emplace_back([this, i]() { work(i); });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+}
+
+void system_context_shard_t::stop() noexcept {
+    stopped.store(true);
+    for (auto &shard : shards) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        shard->signalled = true;
+        shard->wakeup.notify_one();
+    }
+}
+
+void system_context_shard_t::on_shard_finished() noexcept {
+    if (running.fetch_sub(1) == 1) {
+        stop();
+    }
+}
+
+void system_context_shard_t::send(std::size_t target, message_ptr_t &&message) noexcept {
+    // nobody will ever poll the shard without root supervisor
+    if (target >= shards.size() || !shards[target]->supervisor) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    if (current.context == this && current.index != target) {
+        // the backlog is not empty only if the ring has been full; the order is preserved
+        auto &backlog = shards[current.index]->backlogs[target];
+        if (!backlog.empty() || !shards[target]->rings[current.index]->push(message)) {
+            backlogged.fetch_add(1, std::memory_order_relaxed);
+            backlog.emplace_back(std::move(message));
+            return;
+        }
+    } else {
+        shards[target]->supervisor->inbound.push(std::move(message));
+    }
+    if (idle_spins != never_park) {
+        wake(target);
+    }
+}
+
+void system_context_shard_t::wake(std::size_t target) noexcept {
+    auto &shard = *shards[target];
+    // pairs with the fence in `park`: either the receiver sees the message, or the
+    // sender sees the flag
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (shard.parked.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.signalled = true;
+        shard.wakeup.notify_one();
+    }
+}
+
+bool system_context_shard_t::poll(std::size_t index) noexcept {
+    auto &shard = *shards[index];
+    bool busy = shard.supervisor && shard.supervisor->poll();
+    for (std::size_t target = 0; target < shards.size(); ++target) {
+        auto &backlog = shard.backlogs[target];
+        if (backlog.empty()) {
+            continue;
+        }
+        auto &ring = *shards[target]->rings[index];
+        while (!backlog.empty() && ring.push(backlog.front())) {
+            backlog.pop_front();
+        }
+        wake(target);
+        busy = true;
+    }
+    return busy;
+}
+
+void system_context_shard_t::park(std::size_t index) noexcept {
+    auto &shard = *shards[index];
+    shard.parked.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    // the messages, sent before the flag has been seen by the senders
+    if (poll(index)) {
+        shard.parked.store(false, std::memory_order_relaxed);
+        return;
+    }
+    std::unique_lock<std::mutex> lock(shard.mutex);
+    auto ready = [&]() { return shard.signalled || stopped.load(); };
+    if (shard.timers.empty()) {
+        shard.wakeup.wait(lock, ready);
+    } else {
+        auto until = shard.timers.begin()->first;
+        shard.wakeup.wait_until(lock, until, ready);
+    }
+    shard.signalled = false;
+    shard.parked.store(false, std::memory_order_relaxed);
+}
+
+void system_context_shard_t::work(std::size_t index) noexcept {
+    current = current_shard_t{this, index};
+    if (pin_threads) {
+        pin(index);
+    }
+    std::size_t idle = 0;
+    while (!stopped.load(std::memory_order_relaxed)) {
+        if (poll(index)) {
+            idle = 0;
+        } else if (idle_spins == never_park || ++idle < idle_spins) {
+            std::this_thread::yield();
+        } else {
+            park(index);
+            idle = 0;
+        }
+    }
+    current = current_shard_t{nullptr, 0};
+}
@@ -7,26 +7,97 @@
 #include "rotor/actor_base.h"
 #include "rotor/subscription.h"
 #include "rotor/supervisor.h"
+#include <assert.h>
+#include <cstdint>
 
 using namespace rotor;
 
-subscription_t::subscription_t(supervisor_t &sup) : supervisor{sup} {}
+namespace {
 
-void subscription_t::subscribe(handler_ptr_t handler) {
-    bool mine = &handler->actor_ptr->get_supervisor() == &supervisor;
-    map[handler->message_type].emplace_back(classified_handlers_t{std::move(handler), mine});
+const std::size_t initial_capacity = 16;
+
+inline supervisor_t &owner(const handler_ptr_t &handler) noexcept { return handler->actor_ptr->get_supervisor(); }
+
+inline std::size_t hash(const address_t *addr, subscription_t::slot_t slot) noexcept {
+    auto h = (reinterpret_cast<std::uintptr_t>(addr) >> 3) + static_cast<std::uintptr_t>(slot);
+    h *= static_cast<std::uintptr_t>(0x9E3779B97F4A7C15ull);
+    return static_cast<std::size_t>(h ^ (h >> 29));
+}
+
+} // namespace
+
+subscription_t::subscription_t(supervisor_t &sup) : supervisor{sup}, count{0} {}
+
+std::size_t subscription_t::find(const address_t *addr, slot_t slot) const noexcept {
+    auto mask = buckets.size() - 1;
+    auto i = hash(addr, slot) & mask;
+    while (true) {
+        auto &bucket = buckets[i];
+        if (!bucket.entry || (bucket.address == addr && bucket.slot == slot)) {
+            return i;
+        }
+        i = (i + 1) & mask;
+    }
 }
 
-subscription_t::list_t *subscription_t::get_recipients(const subscription_t::slot_t &slot) noexcept {
-    auto it = map.find(slot);
-    if (it != map.end()) {
-        return &it->second;
+void subscription_t::grow() {
+    buckets_t prev(buckets.empty() ? initial_capacity : buckets.size() * 2);
+    std::swap(prev, buckets);
+    for (auto &bucket : prev) {
+        if (bucket.entry) {
+            buckets[find(bucket.address, bucket.slot)] = std::move(bucket);
+        }
     }
-    return nullptr;
 }
 
-std::size_t subscription_t::unsubscribe(handler_ptr_t handler) {
-    auto &list = map.at(handler->message_type);
+void subscription_t::subscribe(const address_ptr_t &addr, handler_ptr_t handler) {
+    // keep load factor below 1/2
+    if ((count + 1) * 2 > buckets.size()) {
+        grow();
+    }
+    auto &bucket = buckets[find(addr.get(), handler->message_type)];
+    if (!bucket.entry) {
+        bucket.address = addr.get();
+        bucket.slot = handler->message_type;
+        bucket.entry.reset(new entry_t{addr, {}, {}});
+        ++count;
+    }
+    auto &entry = *bucket.entry;
+    auto &handler_sup = owner(handler);
+    bool mine = &handler_sup == &supervisor;
+    if (!mine) {
+        auto it = entry.foreign.begin();
+        while (it != entry.foreign.end() && &owner((*it)->front()) != &handler_sup) {
+            ++it;
+        }
+        if (it == entry.foreign.end()) {
+            entry.foreign.emplace_back(std::make_shared<handlers_batch_t>(handlers_batch_t{handler}));
+        } else {
+            auto batch = std::make_shared<handlers_batch_t>(**it);
+            batch->emplace_back(handler);
+            *it = std::move(batch);
+        }
+    }
+    auto thunk = handler->thunk;
+    entry.recipients.emplace_back(classified_handlers_t{std::move(handler), thunk, mine});
+}
+
+subscription_t::entry_t *subscription_t::get_entry(const address_t &addr, const slot_t &slot) noexcept {
+    if (!count) {
+        return nullptr;
+    }
+    auto &bucket = buckets[find(&addr, slot)];
+    return bucket.entry.get();
+}
+
+void subscription_t::unsubscribe(const address_ptr_t &addr, const handler_ptr_t &handler) noexcept {
+    assert(count && "no subscription found");
+    auto mask = buckets.size() - 1;
+    auto i = find(addr.get(), handler->message_type);
+    assert(buckets[i].entry && "no subscription found");
+
+    auto &entry = *buckets[i].entry;
+    auto &list = entry.recipients;
     auto it = list.begin();
     while (it != list.end()) {
         if (*it->handler == *handler) {
@@ -35,8 +106,48 @@ std::size_t subscription_t::unsubscribe(handler_ptr_t handler) {
             ++it;
         }
     }
-    if (list.empty()) {
-        map.erase(handler->message_type);
+
+    auto &handler_sup = owner(handler);
+    if (&handler_sup != &supervisor) {
+        auto batch_it = entry.foreign.begin();
+        while (batch_it != entry.foreign.end() && &owner((*batch_it)->front()) != &handler_sup) {
+            ++batch_it;
+        }
+        if (batch_it != entry.foreign.end()) {
+            auto batch = std::make_shared<handlers_batch_t>();
+            for (auto &h : **batch_it) {
+                if (!(*h == *handler)) {
+                    batch->emplace_back(h);
+                }
+            }
+            if (batch->empty()) {
+                entry.foreign.erase(batch_it);
+            } else {
+                *batch_it = std::move(batch);
+            }
+        }
+    }
+
+    if (!list.empty()) {
+        return;
+    }
+
+    // backward-shift deletion: move the following displaced buckets into the gap
+    buckets[i].entry.reset();
+    --count;
+    auto j = i;
+    while (true) {
+        j = (j + 1) & mask;
+        auto &bucket = buckets[j];
+        if (!bucket.entry) {
+            break;
+        }
+        auto home = hash(bucket.address, bucket.slot) & mask;
+        // the bucket can be moved to the gap only if its home is not within (i, j]
+        bool in_place = (i <= j) ? (i < home && home <= j) : (i < home || home <= j);
+        if (!in_place) {
+            buckets[i] = std::move(bucket);
+            i = j;
+        }
     }
-    return map.size();
 }
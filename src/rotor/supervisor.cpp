@@ -5,15 +5,47 @@
 //
 
 #include "rotor/supervisor.h"
+#include <algorithm>
 #include <assert.h>
 // #include <iostream>
-// #include <boost/core/demangle.hpp>
 
 using namespace rotor;
 
+namespace {
+
+thread_local supervisor_t *processing_leader = nullptr;
+
+/* makes the locality leader the current one for the thread */
+struct processing_scope_t {
+    supervisor_t *prev;
+    processing_scope_t(supervisor_t *leader) noexcept : prev{processing_leader} { processing_leader = leader; }
+    ~processing_scope_t() { processing_leader = prev; }
+};
+
+} // namespace
+
 supervisor_t::supervisor_t(supervisor_t *sup, const supervisor_config_t &config)
-    : actor_base_t(*this), parent{sup}, last_req_id{1}, shutdown_timeout{config.shutdown_timeout}, policy{
-                                                                                                       config.policy} {}
+    : actor_base_t(*this), parent{sup}, locality_leader{nullptr}, subscription_map{*this},
+      armed_tick{timer_wheel_t::never}, shutdown_timeout{config.shutdown_timeout}, policy{config.policy},
+      message_pool{config.message_pool ? new message_pool_t() : nullptr}, queue_reserve{config.queue_reserve},
+      mailbox{config.mailbox_capacity ? new mailbox_t(config.mailbox_capacity, config.overflow_policy) : nullptr},
+      process_budget{config.process_budget}, process_time_budget{config.process_time_budget.total_microseconds()},
+      scheduling{config.scheduling}, weight{config.weight}, quantum{0}, scheduled{false}, held{0}, queue_peak{0} {
+    assert(weight && "supervisor weight should be positive");
+}
+
+supervisor_t::~supervisor_t() {
+    if (locality_leader == this) {
+        // the supervisors of the locality might outlive their leader
+        for (auto owner : ready) {
+            owner->scheduled = false;
+        }
+    } else if (scheduled) {
+        auto &turns = locality_leader->ready;
+        turns.erase(std::find(turns.begin(), turns.end(), this));
+        locality_leader->held -= queue.size();
+    }
+}
 
 address_ptr_t supervisor_t::make_address() noexcept {
     auto root_sup = this;
@@ -37,6 +69,12 @@ void supervisor_t::do_initialize(system_context_t *ctx) noexcept {
 
     bool use_other = parent && parent->address->same_locality(*address);
     locality_leader = use_other ? parent->locality_leader : this;
+    if (use_other) {
+        message_pool.reset();
+        mailbox.reset();
+    } else if (queue_reserve) {
+        queue.reserve(queue_reserve);
+    }
 
     actor_base_t::do_initialize(ctx);
     subscribe(&supervisor_t::on_call);
@@ -67,16 +105,28 @@ void supervisor_t::on_initialize_confirm(message::init_response_t &msg) noexcept
 }
 
 void supervisor_t::do_process() noexcept {
-    auto effective_queue = &locality_leader->queue;
-    while (effective_queue->size()) {
-        auto message = effective_queue->front();
+    using clock_t = std::chrono::steady_clock;
+    auto &leader = *locality_leader;
+    message_pool_t::scope_t pool_scope{leader.message_pool.get()};
+    processing_scope_t processing_scope{&leader};
+    auto &effective_queue = leader.queue;
+    auto budget = leader.process_budget;
+    auto time_budget = leader.process_time_budget;
+    auto started = time_budget.count() ? clock_t::now() : clock_t::time_point{};
+    std::size_t processed = 0;
+    while (!effective_queue.empty() || !leader.ready.empty()) {
+        if (processed && ((budget && processed >= budget) ||
+                          (time_budget.count() && clock_t::now() - started >= time_budget))) {
+            leader.defer_process();
+            return;
+        }
+        ++processed;
+        auto message = leader.take_next();
         auto &dest = message->address;
-        effective_queue->pop_front();
         auto &dest_sup = dest->supervisor;
         auto internal = &dest_sup == this;
         /*
-         std::cout << "msg [" << (internal ? "i" : "e") << "] :" << boost::core::demangle((const char*)
-             message->type_index) << "\n";
+         std::cout << "msg [" << (internal ? "i" : "e") << "] : type " << message->type_index << "\n";
         */
         if (internal) { /* subscriptions are handled by me */
             deliver_local(std::move(message));
@@ -88,21 +138,96 @@ void supervisor_t::do_process() noexcept {
     }
 }
 
+supervisor_t *supervisor_t::current_leader() noexcept { return processing_leader; }
+
+message_ptr_t supervisor_t::take_next() noexcept {
+    if (ready.empty() || queue.urgent_size()) {
+        return queue.pop_front();
+    }
+    auto owner = ready.front();
+    ready.pop_front();
+    auto message = owner->queue.pop_front();
+    if (owner != this) {
+        --held;
+    }
+    if (owner->queue.empty()) {
+        owner->scheduled = false;
+    } else {
+        if (!--owner->quantum) {
+            owner->quantum = scheduling == scheduling_t::weighted ? owner->weight : 1;
+            ready.emplace_back(owner);
+        } else {
+            ready.emplace_front(owner);
+        }
+    }
+    return message;
+}
+
+void supervisor_t::schedule(message_ptr_t &&message) noexcept {
+    auto &dest = message->address->supervisor;
+    auto &owner = dest.locality_leader == this ? dest : *this;
+    owner.queue.emplace_back(std::move(message));
+    if (&owner != this) {
+        ++held;
+    }
+    if (!owner.scheduled) {
+        owner.scheduled = true;
+        owner.quantum = scheduling == scheduling_t::weighted ? owner.weight : 1;
+        ready.emplace_back(&owner);
+    }
+}
+
+std::size_t supervisor_t::get_queue_size() const noexcept {
+    auto &leader = *locality_leader;
+    return leader.queue.size() + leader.held;
+}
+
+namespace {
+/* puts the messages taken from other localities as if they were sent locally */
+struct leader_sink_t {
+    supervisor_t &leader;
+    inline void emplace_back(message_ptr_t &&message) noexcept { leader.put(std::move(message)); }
+};
+} // namespace
+
+void supervisor_t::take_inbound(mpsc_queue_t &inbound) noexcept {
+    auto &leader = *locality_leader;
+    auto &box = leader.mailbox;
+    leader_sink_t sink{leader};
+    if (!box) {
+        inbound.pop_all(sink);
+        return;
+    }
+    auto count = inbound.pop_all(sink, [&](const message_base_t &message) { return box->keep(message); });
+    if (count) {
+        box->release(count);
+    }
+}
+
 void supervisor_t::deliver_local(message_ptr_t &&message) noexcept {
-    auto it_subscriptions = subscription_map.find(message->address);
-    if (it_subscriptions != subscription_map.end()) {
-        auto &subscription = it_subscriptions->second;
-        auto recipients = subscription.get_recipients(message->type_index);
-        if (recipients) {
-            for (auto &it : *recipients) {
-                if (it.mine) {
-                    it.handler->call(message);
-                } else {
-                    auto &sup = it.handler->actor_ptr->get_supervisor();
-                    auto wrapped_message = make_message<payload::handler_call_t>(sup.address, message, it.handler);
-                    sup.enqueue(std::move(wrapped_message));
-                }
+    auto entry = subscription_map.get_entry(*message);
+    if (!entry) {
+        return;
+    }
+    // the handlers are invoked in the subscription order; the batch of external
+    // supervisor is forwarded at the place of its first handler
+    for (auto &it : entry->recipients) {
+        if (it.mine) {
+            it.thunk(*it.handler, *message);
+            continue;
+        }
+        for (auto &batch : entry->foreign) {
+            if (batch->front() != it.handler) {
+                continue;
             }
+            auto &sup = it.handler->actor_ptr->get_supervisor();
+            auto wrapped_message = make_message<payload::handler_call_t>(sup.address, message, batch);
+            // the envelope is classified as the original message, i.e. it goes into
+            // the same lane and is not dropped by the mailbox, if it is a control one
+            wrapped_message->control = message->control;
+            wrapped_message->urgent = message->urgent;
+            sup.enqueue(std::move(wrapped_message));
+            break;
         }
     }
 }
@@ -178,9 +303,10 @@ void supervisor_t::on_commit_unsubscription(message_t<payload::commit_unsubscrip
 }
 
 void supervisor_t::on_call(message_t<payload::handler_call_t> &message) noexcept {
-    auto &handler = message.payload.handler;
-    auto &orig_message = message.payload.orig_message;
-    handler->call(orig_message);
+    auto &orig_message = *message.payload.orig_message;
+    for (auto &handler : *message.payload.handlers) {
+        handler->thunk(*handler, orig_message);
+    }
 }
 
 void supervisor_t::on_state_request(message::state_request_t &message) noexcept {
@@ -200,11 +326,7 @@ void supervisor_t::on_state_request(message::state_request_t &message) noexcept
 }
 
 void supervisor_t::commit_unsubscription(const address_ptr_t &addr, const handler_ptr_t &handler) noexcept {
-    auto &subscriptions = subscription_map.at(addr);
-    auto left = subscriptions.unsubscribe(handler);
-    if (!left) {
-        subscription_map.erase(addr);
-    }
+    subscription_map.unsubscribe(addr, handler);
 }
 
 void supervisor_t::remove_actor(actor_base_t &actor) noexcept {
@@ -217,14 +339,154 @@ void supervisor_t::remove_actor(actor_base_t &actor) noexcept {
 
 void supervisor_t::shutdown_finish() noexcept { address_mapping.destructive_get(*this); }
 
+void supervisor_t::start_timer(const pt::time_duration &timeout, timer_id_t timer_id) noexcept {
+    auto now = timer_wheel_t::now();
+    auto deadline = timer_wheel_t::deadline(now, timeout);
+    timers.start(timer_id, deadline);
+    // the armed tick is the earliest deadline, i.e. no need to look up the wheel
+    if (deadline < armed_tick) {
+        armed_tick = deadline;
+        arm_timer(pt::milliseconds(static_cast<long>(deadline - now)));
+    }
+}
+
+void supervisor_t::cancel_timer(timer_id_t timer_id) noexcept {
+    timers.cancel(timer_id);
+    // if there are other timers, the armed one will just re-arm on wake up
+    if (timers.empty() && armed_tick != timer_wheel_t::never) {
+        armed_tick = timer_wheel_t::never;
+        disarm_timer();
+    }
+}
+
+void supervisor_t::arm_timer(const pt::time_duration &) noexcept {}
+
+void supervisor_t::disarm_timer() noexcept {}
+
+void supervisor_t::defer_process() noexcept {}
+
+void supervisor_t::trigger_timers() noexcept {
+    armed_tick = timer_wheel_t::never;
+    auto now = timer_wheel_t::now();
+    timers.advance(now, expired_timers);
+    for (std::size_t i = 0; i < expired_timers.size(); ++i) {
+        on_timer_trigger(expired_timers[i]);
+    }
+    expired_timers.clear();
+
+    auto next = timers.next_deadline();
+    if (next < armed_tick) {
+        armed_tick = next;
+        arm_timer(pt::milliseconds(static_cast<long>(next > now ? next - now : 0)));
+    }
+}
+
+void supervisor_t::deliver_response(message_base_t &response, request_id_t request_id,
+                                    const message_base_t *request) noexcept {
+    auto request_curry = request_map.find(request_id);
+    if (!request_curry) {
+        // if a response to request has arrived and no timer can be found
+        // that means that either timeout timer already triggered
+        // and error-message already delivered or response is not expected.
+        // just silently drop it anyway
+        return;
+    }
+    if (request_curry->gather) {
+        auto &gather = *request_curry->gather;
+        if (gather.collect(response, request)) {
+            if (request_curry->timed) {
+                cancel_timer(request_id);
+            }
+            auto result = gather.complete(request_curry->reply_to, make_error_code(error_code_t::success));
+            request_map.erase(request_id);
+            put(std::move(result));
+        }
+        return;
+    }
+    // the request message comparison guards against the reused slab slot
+    if (request_curry->request_message.get() != request) {
+        return;
+    }
+    if (request_curry->timed) {
+        cancel_timer(request_id);
+    }
+    // the response is re-targeted to the original reply address and put into the
+    // queue as is, i.e. without copying it into new message. That is safe, because
+    // the imaginary address has the single (supervisor's own) subscriber, and the
+    // shared response is copied by the subscriber
+    message_ptr_t message{&response};
+    message->address = std::move(request_curry->reply_to);
+    request_map.erase(request_id);
+    put(std::move(message));
+}
+
+bool supervisor_t::do_cancel_request(request_id_t request_id) noexcept {
+    auto request_curry = request_map.find(request_id);
+    if (!request_curry) {
+        return false;
+    }
+    if (request_curry->timed) {
+        cancel_timer(request_id);
+    }
+    auto ec = make_error_code(error_code_t::request_cancelled);
+    if (request_curry->gather) {
+        auto gather = std::move(request_curry->gather);
+        for (std::size_t i = 0; i < gather->requests.size(); ++i) {
+            auto &request = gather->requests[i];
+            if (request) {
+                send<payload::cancel_request_t>(gather->destinations[i], request);
+            }
+        }
+        put(gather->complete(request_curry->reply_to, ec));
+        request_map.erase(request_id);
+        return true;
+    }
+    // the request message address is not read, as the message might be forwarded
+    // (and re-targeted) by other thread meanwhile
+    auto request = std::move(request_curry->request_message);
+    auto destination = std::move(request_curry->destination);
+    auto cancel_message = request_curry->fn(request_curry->reply_to, *request, std::move(ec));
+    request_map.erase(request_id);
+    put(std::move(cancel_message));
+    send<payload::cancel_request_t>(destination, std::move(request));
+    return true;
+}
+
+bool supervisor_t::do_forward_request(message_base_t &request, const address_ptr_t &destination) noexcept {
+    // the only expected owners are the current delivery and the requester's record,
+    // which does not look into the message address
+    if (request.use_count() > 2) {
+        return false;
+    }
+    // the other handlers of the message (if any) share the delivery, i.e. they would
+    // see the re-targeted message; the subscriptions are inspected only within the
+    // locality of the address, where they are not modified concurrently
+    auto &owner = request.address->supervisor;
+    if (!owner.address->same_locality(*address)) {
+        return false;
+    }
+    auto entry = owner.subscription_map.get_entry(request);
+    if (!entry || entry->recipients.size() != 1 || !entry->foreign.empty()) {
+        return false;
+    }
+    message_ptr_t message{&request};
+    message->address = destination;
+    put(std::move(message));
+    return true;
+}
+
 void supervisor_t::on_timer_trigger(timer_id_t timer_id) {
-    auto it = request_map.find(timer_id);
-    if (it != request_map.end()) {
-        auto &request_curry = it->second;
-        message_ptr_t &request = request_curry.request_message;
+    auto request_curry = request_map.find(timer_id);
+    if (request_curry) {
         auto ec = make_error_code(error_code_t::request_timeout);
-        auto timeout_message = request_curry.fn(request_curry.reply_to, *request, std::move(ec));
+        message_ptr_t timeout_message;
+        if (request_curry->gather) {
+            timeout_message = request_curry->gather->complete(request_curry->reply_to, ec);
+        } else {
+            message_ptr_t &request = request_curry->request_message;
+            timeout_message = request_curry->fn(request_curry->reply_to, *request, std::move(ec));
+        }
         put(std::move(timeout_message));
-        request_map.erase(it);
+        request_map.erase(timer_id);
     }
 }
@@ -0,0 +1,259 @@
+//
+// Copyright (c) 2019-2020 Ivan Baidakou (basiliscos) (the dot dmol at gmail dot com)
+//
+// Distributed under the MIT Software License
+//
+
+#include "rotor/timer_wheel.h"
+#include <assert.h>
+#include <chrono>
+
+using namespace rotor;
+
+namespace {
+
+/* returns mask of the bits above the position */
+inline std::uint64_t above(unsigned position) noexcept {
+    return position >= 63 ? 0 : (~std::uint64_t{0}) << (position + 1);
+}
+
+inline unsigned lowest_bit(std::uint64_t value) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_ctzll(value));
+#else
+    unsigned r = 0;
+    while (!(value & 1)) {
+        value >>= 1;
+        ++r;
+    }
+    return r;
+#endif
+}
+
+} // namespace
+
+timer_wheel_t::timer_wheel_t() noexcept : current{now()}, overflow{npos}, count{0} {
+    for (unsigned level = 0; level < levels; ++level) {
+        occupied[level] = 0;
+        for (unsigned slot = 0; slot < slots; ++slot) {
+            heads[level][slot] = npos;
+        }
+    }
+}
+
+timer_wheel_t::tick_t timer_wheel_t::now() noexcept {
+    using namespace std::chrono;
+    return static_cast<tick_t>(duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count());
+}
+
+timer_wheel_t::tick_t timer_wheel_t::deadline(tick_t now, const pt::time_duration &timeout) noexcept {
+    // round up, and take into account that `now` is already partially elapsed,
+    // i.e. the timer never fires earlier than the timeout
+    auto us = timeout.total_microseconds();
+    auto ms = us > 0 ? static_cast<tick_t>((us + 999) / 1000) : tick_t{0};
+    return now + ms + 1;
+}
+
+pt::time_duration timer_wheel_t::timeout(tick_t now, tick_t deadline) noexcept {
+    if (deadline == never) {
+        return pt::time_duration(pt::pos_infin);
+    }
+    auto ms = deadline > now + 1 ? deadline - now - 1 : tick_t{0};
+    return pt::milliseconds(static_cast<long>(ms));
+}
+
+timer_wheel_t::index_t &timer_wheel_t::head(unsigned level, unsigned slot) noexcept {
+    return level == overflow_level ? overflow : heads[level][slot];
+}
+
+void timer_wheel_t::start(timer_id_t timer_id, tick_t deadline) {
+    auto index = slab_t<node_t>::index_of(timer_id);
+    if (index >= nodes.size()) {
+        nodes.resize(index + 1);
+    }
+    assert(nodes[index].level == idle_level && "timer with the same slot index is already started");
+    nodes[index].timer_id = timer_id;
+    ++count;
+    link(index, deadline > current ? deadline : current + 1, nullptr);
+}
+
+bool timer_wheel_t::cancel(timer_id_t timer_id) noexcept {
+    auto index = slab_t<node_t>::index_of(timer_id);
+    if (index >= nodes.size()) {
+        return false;
+    }
+    auto &node = nodes[index];
+    if (node.level == idle_level || node.timer_id != timer_id) {
+        return false;
+    }
+    unlink(index);
+    node.level = idle_level;
+    --count;
+    return true;
+}
+
+void timer_wheel_t::release(index_t index, std::vector<timer_id_t> &expired) noexcept {
+    auto &node = nodes[index];
+    expired.push_back(node.timer_id);
+    node.level = idle_level;
+    --count;
+}
+
+void timer_wheel_t::link(index_t index, tick_t deadline, std::vector<timer_id_t> *expired) {
+    auto &node = nodes[index];
+    node.deadline = deadline;
+    if (deadline <= current) {
+        assert(expired);
+        release(index, *expired);
+        return;
+    }
+
+    // the level is the highest differing digit between the deadline and the current tick
+    auto diff = deadline ^ current;
+    unsigned level = 0;
+    unsigned slot = 0;
+    if (diff >> (bits * levels)) {
+        level = overflow_level;
+    } else {
+        while (diff >> (bits * (level + 1))) {
+            ++level;
+        }
+        slot = static_cast<unsigned>(deadline >> (bits * level)) & (slots - 1);
+        occupied[level] |= std::uint64_t{1} << slot;
+    }
+
+    auto &first = head(level, slot);
+    node.level = static_cast<std::uint8_t>(level);
+    node.slot = static_cast<std::uint8_t>(slot);
+    node.prev = npos;
+    node.next = first;
+    if (first != npos) {
+        nodes[first].prev = index;
+    }
+    first = index;
+}
+
+void timer_wheel_t::unlink(index_t index) noexcept {
+    auto &node = nodes[index];
+    auto &first = head(node.level, node.slot);
+    if (node.prev == npos) {
+        first = node.next;
+    } else {
+        nodes[node.prev].next = node.next;
+    }
+    if (node.next != npos) {
+        nodes[node.next].prev = node.prev;
+    }
+    if (first == npos && node.level != overflow_level) {
+        occupied[node.level] &= ~(std::uint64_t{1} << node.slot);
+    }
+}
+
+void timer_wheel_t::cascade(unsigned level, unsigned slot, std::vector<timer_id_t> &expired) {
+    auto &first = head(level, slot);
+    auto index = first;
+    first = npos;
+    if (level != overflow_level) {
+        occupied[level] &= ~(std::uint64_t{1} << slot);
+    }
+    while (index != npos) {
+        auto next = nodes[index].next;
+        link(index, nodes[index].deadline, &expired);
+        index = next;
+    }
+}
+
+void timer_wheel_t::expire(tick_t tick, std::vector<timer_id_t> &expired) {
+    auto slot = static_cast<unsigned>(tick) & (slots - 1);
+    auto &first = heads[0][slot];
+    auto index = first;
+    first = npos;
+    occupied[0] &= ~(std::uint64_t{1} << slot);
+    while (index != npos) {
+        assert(nodes[index].deadline == tick);
+        auto next = nodes[index].next;
+        release(index, expired);
+        index = next;
+    }
+}
+
+timer_wheel_t::tick_t timer_wheel_t::next_tick() const noexcept {
+    if (!count) {
+        return never;
+    }
+    tick_t result = never;
+    for (unsigned level = 0; level < levels; ++level) {
+        auto shift = bits * level;
+        auto position = static_cast<unsigned>(current >> shift) & (slots - 1);
+        auto mask = occupied[level] & above(position);
+        if (mask) {
+            auto upper = (current >> (shift + bits)) << (shift + bits);
+            auto tick = upper | (static_cast<tick_t>(lowest_bit(mask)) << shift);
+            if (tick < result) {
+                result = tick;
+            }
+        }
+    }
+    if (overflow != npos) {
+        auto shift = bits * levels;
+        auto tick = ((current >> shift) + 1) << shift;
+        if (tick < result) {
+            result = tick;
+        }
+    }
+    return result;
+}
+
+timer_wheel_t::tick_t timer_wheel_t::next_deadline() const noexcept {
+    if (!count) {
+        return never;
+    }
+    tick_t result = never;
+    for (unsigned level = 0; level < levels; ++level) {
+        auto shift = bits * level;
+        auto position = static_cast<unsigned>(current >> shift) & (slots - 1);
+        auto mask = occupied[level] & above(position);
+        if (mask) {
+            // the first non-empty slot of the level holds the earliest timers of the level
+            auto index = heads[level][lowest_bit(mask)];
+            while (index != npos) {
+                auto &node = nodes[index];
+                if (node.deadline < result) {
+                    result = node.deadline;
+                }
+                index = node.next;
+            }
+        }
+    }
+    if (overflow != npos) {
+        auto shift = bits * levels;
+        auto tick = ((current >> shift) + 1) << shift;
+        if (tick < result) {
+            result = tick;
+        }
+    }
+    return result;
+}
+
+void timer_wheel_t::advance(tick_t now, std::vector<timer_id_t> &expired) {
+    while (count) {
+        auto tick = next_tick();
+        if (tick > now) {
+            break;
+        }
+        current = tick;
+        if (overflow != npos && !(current & ((tick_t{1} << (bits * levels)) - 1))) {
+            cascade(overflow_level, 0, expired);
+        }
+        for (unsigned level = levels - 1; level > 0; --level) {
+            auto shift = bits * level;
+            if (!(current & ((tick_t{1} << shift) - 1))) {
+                cascade(level, static_cast<unsigned>(current >> shift) & (slots - 1), expired);
+            }
+        }
+        expire(current, expired);
+    }
+    if (now > current) {
+        current = now;
+    }
+}
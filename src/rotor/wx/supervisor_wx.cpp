@@ -10,13 +10,17 @@
 using namespace rotor::wx;
 using namespace rotor;
 
-supervisor_wx_t::timer_t::timer_t(timer_id_t timer_id_, supervisor_ptr_t &&sup_)
-    : timer_id{timer_id_}, sup{std::move(sup_)} {}
+supervisor_wx_t::timer_t::timer_t(supervisor_wx_t &sup_) : sup{sup_} {}
 
-void supervisor_wx_t::timer_t::Notify() noexcept { sup->on_timer_trigger(timer_id); }
+void supervisor_wx_t::timer_t::Notify() noexcept {
+    // keep the supervisor alive during the processing
+    auto holder = std::move(self);
+    sup.trigger_timers();
+    sup.do_process();
+}
 
 supervisor_wx_t::supervisor_wx_t(supervisor_wx_t *sup, const supervisor_config_wx_t &config_)
-    : supervisor_t{sup, config_}, handler{config_.handler} {}
+    : supervisor_t{sup, config_}, handler{config_.handler}, timer{*this}, process_deferred{false} {}
 
 void supervisor_wx_t::start() noexcept {
     supervisor_ptr_t self{this};
@@ -36,30 +40,42 @@ void supervisor_wx_t::shutdown() noexcept {
 }
 
 void supervisor_wx_t::enqueue(message_ptr_t message) noexcept {
+    if (!admit(message)) {
+        return;
+    }
+    message->share();
     supervisor_ptr_t self{this};
     handler->CallAfter([self = std::move(self), message = std::move(message)]() {
         auto &sup = *self;
+        if (!sup.take_inbound(*message)) {
+            return;
+        }
         sup.put(std::move(message));
         sup.do_process();
     });
 }
 
-void supervisor_wx_t::start_timer(const rotor::pt::time_duration &timeout, timer_id_t timer_id) noexcept {
-    auto self = timer_t::supervisor_ptr_t(this);
-    auto timer = std::make_unique<timer_t>(timer_id, std::move(self));
-    auto timeout_ms = static_cast<int>(timeout.total_milliseconds());
-    timer->StartOnce(timeout_ms);
-    timers_map.emplace(timer_id, std::move(timer));
+void supervisor_wx_t::arm_timer(const rotor::pt::time_duration &delay) noexcept {
+    timer.self.reset(this);
+    auto timeout_ms = static_cast<int>(delay.total_milliseconds());
+    timer.StartOnce(timeout_ms > 0 ? timeout_ms : 1);
 }
 
-void supervisor_wx_t::cancel_timer(timer_id_t timer_id) noexcept {
-    auto &timer = timers_map.at(timer_id);
-    timer->Stop();
-    timers_map.erase(timer_id);
+void supervisor_wx_t::disarm_timer() noexcept {
+    timer.Stop();
+    timer.self.reset();
 }
 
-void supervisor_wx_t::on_timer_trigger(timer_id_t timer_id) noexcept {
-    timers_map.erase(timer_id);
-    supervisor_t::on_timer_trigger(timer_id);
-    do_process();
+void supervisor_wx_t::defer_process() noexcept {
+    // the pending invocation will process the rest too
+    if (process_deferred) {
+        return;
+    }
+    process_deferred = true;
+    timer_t::supervisor_ptr_t self{this};
+    handler->CallAfter([self = std::move(self)]() {
+        auto &sup = *self;
+        sup.process_deferred = false;
+        sup.do_process();
+    });
 }
@@ -57,6 +57,75 @@ static_assert(std::is_base_of_v<r::arc_base_t<req3_t>, req3_t>, "zzz");
 
 using traits_t = r::request_traits_t<request_sample_t>;
 
+struct counted_res_t {
+    static int copies;
+    int value;
+    counted_res_t(int value_ = 0) : value{value_} {}
+    counted_res_t(const counted_res_t &other) : value{other.value} { ++copies; }
+};
+int counted_res_t::copies = 0;
+
+struct counted_req_t {
+    using response_t = counted_res_t;
+    int value;
+};
+
+using counted_traits_t = r::request_traits_t<counted_req_t>;
+
+struct direct_actor_t : public r::actor_base_t {
+    using r::actor_base_t::actor_base_t;
+    int res_val = 0;
+    r::address_ptr_t response_address;
+
+    void init_start() noexcept override {
+        subscribe(&direct_actor_t::on_request);
+        subscribe(&direct_actor_t::on_response);
+        r::actor_base_t::init_start();
+    }
+
+    void on_start(r::message_t<r::payload::start_actor_t> &msg) noexcept override {
+        r::actor_base_t::on_start(msg);
+        request<counted_req_t>(address, 4).send(r::pt::seconds(1));
+    }
+
+    void on_request(counted_traits_t::request::message_t &msg) noexcept { reply_to(msg, 5); }
+
+    void on_response(counted_traits_t::response::message_t &msg) noexcept {
+        res_val += msg.payload.res.value;
+        response_address = msg.address;
+    }
+};
+
+/* keeps the response, i.e. it is shared upon the delivery */
+struct keeping_actor_t : public r::actor_base_t {
+    using r::actor_base_t::actor_base_t;
+    using response_t = counted_traits_t::response::wrapped_t;
+    int res_val = 0;
+    r::address_ptr_t response_address;
+    r::message_ptr_t kept;
+
+    void init_start() noexcept override {
+        subscribe(&keeping_actor_t::on_request);
+        subscribe(&keeping_actor_t::on_response);
+        r::actor_base_t::init_start();
+    }
+
+    void on_start(r::message_t<r::payload::start_actor_t> &msg) noexcept override {
+        r::actor_base_t::on_start(msg);
+        request<counted_req_t>(address, 4).send(r::pt::seconds(1));
+    }
+
+    void on_request(counted_traits_t::request::message_t &msg) noexcept {
+        kept = r::make_message<response_t>(msg.payload.reply_to, counted_traits_t::request::message_ptr_t{&msg}, 5);
+        supervisor.put(kept);
+    }
+
+    void on_response(counted_traits_t::response::message_t &msg) noexcept {
+        res_val += msg.payload.res.value;
+        response_address = msg.address;
+    }
+};
+
 struct good_actor_t : public r::actor_base_t {
     using r::actor_base_t::actor_base_t;
     int req_val = 0;
@@ -117,6 +186,120 @@ struct bad_actor_t : public r::actor_base_t {
     }
 };
 
+struct forwarding_actor_t : public r::actor_base_t {
+    using r::actor_base_t::actor_base_t;
+    int res_val = 0;
+    int forwarded = 0;
+    int refused = 0;
+    r::address_ptr_t proxy_addr;
+    r::address_ptr_t worker_addr;
+    r::address_ptr_t response_address;
+    const void *sent_msg = nullptr;
+    const void *served_msg = nullptr;
+    const void *responded_msg = nullptr;
+
+    void init_start() noexcept override {
+        if (!proxy_addr) {
+            proxy_addr = supervisor.create_address();
+        }
+        worker_addr = supervisor.create_address();
+        subscribe(&forwarding_actor_t::on_forward, proxy_addr);
+        subscribe(&forwarding_actor_t::on_request, worker_addr);
+        subscribe(&forwarding_actor_t::on_response);
+        r::actor_base_t::init_start();
+    }
+
+    void on_start(r::message_t<r::payload::start_actor_t> &msg) noexcept override {
+        r::actor_base_t::on_start(msg);
+        request<counted_req_t>(proxy_addr, 4).send(r::pt::seconds(1));
+    }
+
+    void on_forward(counted_traits_t::request::message_t &msg) noexcept {
+        sent_msg = &msg;
+        if (forward_request(msg, worker_addr)) {
+            ++forwarded;
+        } else {
+            ++refused;
+            reply_to(msg, msg.payload.request_payload.value + 10);
+        }
+    }
+
+    void on_request(counted_traits_t::request::message_t &msg) noexcept {
+        served_msg = &msg;
+        reply_to(msg, msg.payload.request_payload.value + 1);
+    }
+
+    void on_response(counted_traits_t::response::message_t &msg) noexcept {
+        res_val += msg.payload.res.value;
+        responded_msg = msg.payload.req.get();
+        response_address = msg.address;
+    }
+};
+
+/* the other subscriber to the requests of the forwarding actor */
+struct observer_t : public r::actor_base_t {
+    using r::actor_base_t::actor_base_t;
+    int observed = 0;
+    r::address_ptr_t observed_addr;
+
+    void init_start() noexcept override {
+        subscribe(&observer_t::on_observe, observed_addr);
+        r::actor_base_t::init_start();
+    }
+
+    void on_observe(counted_traits_t::request::message_t &msg) noexcept {
+        ++observed;
+        REQUIRE(msg.address == observed_addr);
+    }
+};
+
+struct cancelling_actor_t : public r::actor_base_t {
+    using r::actor_base_t::actor_base_t;
+    int res_val = 0;
+    int responses = 0;
+    std::error_code ec;
+    r::request_id_t request_id = 0;
+    r::intrusive_ptr_t<traits_t::request::message_t> req_msg;
+    r::message_ptr_t cancelled_msg;
+    std::string events;
+
+    void init_start() noexcept override {
+        subscribe(&cancelling_actor_t::on_request);
+        subscribe(&cancelling_actor_t::on_response);
+        subscribe(&cancelling_actor_t::on_cancel);
+        r::actor_base_t::init_start();
+    }
+
+    void shutdown_start() noexcept override {
+        req_msg.reset();
+        cancelled_msg.reset();
+        r::actor_base_t::shutdown_start();
+    }
+
+    void on_start(r::message_t<r::payload::start_actor_t> &msg) noexcept override {
+        r::actor_base_t::on_start(msg);
+        request_id = request<request_sample_t>(address, 4).send(r::pt::seconds(1));
+    }
+
+    void on_request(traits_t::request::message_t &msg) noexcept {
+        events += "r";
+        req_msg.reset(&msg);
+    }
+
+    void on_cancel(r::message::cancel_request_t &msg) noexcept {
+        events += "c";
+        cancelled_msg = msg.payload.request;
+    }
+
+    void on_response(traits_t::response::message_t &msg) noexcept {
+        ++responses;
+        ec = msg.payload.ec;
+        if (!ec) {
+            res_val += msg.payload.res.value;
+        }
+    }
+};
+
 struct bad_actor2_t : public r::actor_base_t {
     using r::actor_base_t::actor_base_t;
     int req_val = 0;
@@ -656,3 +839,163 @@ TEST_CASE("intrusive pointer request/responce", "[actor]") {
     REQUIRE(sup->get_requests().size() == 0);
     REQUIRE(sup->active_timers.size() == 0);
 }
+
+TEST_CASE("response is delivered as is, without copying", "[actor]") {
+    r::system_context_t system_context;
+
+    auto timeout = r::pt::milliseconds{1};
+    rt::supervisor_config_test_t config(timeout, nullptr);
+    auto sup = system_context.create_supervisor<rt::supervisor_test_t>(nullptr, config);
+    auto actor = sup->create_actor<direct_actor_t>(timeout);
+    counted_res_t::copies = 0;
+    sup->do_process();
+
+    REQUIRE(actor->res_val == 5);
+    REQUIRE(counted_res_t::copies == 0);
+    REQUIRE(actor->response_address == actor->get_address());
+    REQUIRE(sup->active_timers.size() == 0);
+    REQUIRE(sup->get_requests().size() == 0);
+
+    sup->do_shutdown();
+    sup->do_process();
+    REQUIRE(sup->get_state() == r::state_t::SHUTTED_DOWN);
+}
+
+TEST_CASE("shared response is copied", "[actor]") {
+    r::system_context_t system_context;
+
+    auto timeout = r::pt::milliseconds{1};
+    rt::supervisor_config_test_t config(timeout, nullptr);
+    auto sup = system_context.create_supervisor<rt::supervisor_test_t>(nullptr, config);
+    auto actor = sup->create_actor<keeping_actor_t>(timeout);
+    counted_res_t::copies = 0;
+    sup->do_process();
+
+    REQUIRE(actor->res_val == 5);
+    REQUIRE(counted_res_t::copies == 1);
+    REQUIRE(actor->response_address == actor->get_address());
+    REQUIRE(actor->kept->address != actor->get_address());
+    REQUIRE(sup->active_timers.size() == 0);
+    REQUIRE(sup->get_requests().size() == 0);
+
+    actor->kept.reset();
+    sup->do_shutdown();
+    sup->do_process();
+    REQUIRE(sup->get_state() == r::state_t::SHUTTED_DOWN);
+}
+
+TEST_CASE("request cancellation", "[actor]") {
+    r::system_context_t system_context;
+
+    auto timeout = r::pt::milliseconds{1};
+    rt::supervisor_config_test_t config(timeout, nullptr);
+    auto sup = system_context.create_supervisor<rt::supervisor_test_t>(nullptr, config);
+    auto actor = sup->create_actor<cancelling_actor_t>(timeout);
+    sup->do_process();
+
+    REQUIRE(actor->req_msg);
+    REQUIRE(sup->active_timers.size() == 1);
+    REQUIRE(sup->get_requests().size() == 1);
+
+    REQUIRE(actor->cancel_request(actor->request_id));
+    REQUIRE(!actor->cancel_request(actor->request_id));
+    REQUIRE(sup->active_timers.size() == 0);
+    REQUIRE(sup->get_requests().size() == 0);
+    sup->do_process();
+
+    REQUIRE(actor->responses == 1);
+    REQUIRE(actor->ec == r::error_code_t::request_cancelled);
+    REQUIRE(actor->cancelled_msg.get() == actor->req_msg.get());
+
+    // late response is dropped
+    actor->reply_to(*actor->req_msg, 5);
+    sup->do_process();
+    REQUIRE(actor->responses == 1);
+    REQUIRE(actor->res_val == 0);
+
+    sup->do_shutdown();
+    sup->do_process();
+    REQUIRE(sup->get_state() == r::state_t::SHUTTED_DOWN);
+    REQUIRE(sup->get_leader_queue().size() == 0);
+    REQUIRE(sup->get_requests().size() == 0);
+    REQUIRE(sup->active_timers.size() == 0);
+}
+
+TEST_CASE("request cancellation right after sending", "[actor]") {
+    r::system_context_t system_context;
+
+    auto timeout = r::pt::milliseconds{1};
+    rt::supervisor_config_test_t config(timeout, nullptr);
+    auto sup = system_context.create_supervisor<rt::supervisor_test_t>(nullptr, config);
+    auto actor = sup->create_actor<cancelling_actor_t>(timeout);
+    sup->do_process();
+    REQUIRE(actor->cancel_request(actor->request_id));
+    sup->do_process();
+    REQUIRE(actor->events == "rc");
+
+    // the cancel notice does not overtake the request, which is still in the queue
+    actor->events.clear();
+    auto request_id = actor->request<request_sample_t>(actor->get_address(), 6).send(r::pt::seconds(1));
+    REQUIRE(actor->cancel_request(request_id));
+    sup->do_process();
+    REQUIRE(actor->events == "rc");
+    REQUIRE(actor->cancelled_msg.get() == actor->req_msg.get());
+    REQUIRE(actor->responses == 2);
+    REQUIRE(actor->ec == r::error_code_t::request_cancelled);
+
+    sup->do_shutdown();
+    sup->do_process();
+    REQUIRE(sup->get_state() == r::state_t::SHUTTED_DOWN);
+    REQUIRE(sup->get_leader_queue().size() == 0);
+    REQUIRE(sup->get_requests().size() == 0);
+    REQUIRE(sup->active_timers.size() == 0);
+}
+
+TEST_CASE("request forwarding, without copying", "[actor]") {
+    r::system_context_t system_context;
+
+    auto timeout = r::pt::milliseconds{1};
+    rt::supervisor_config_test_t config(timeout, nullptr);
+    auto sup = system_context.create_supervisor<rt::supervisor_test_t>(nullptr, config);
+    auto actor = sup->create_actor<forwarding_actor_t>(timeout);
+    sup->do_process();
+
+    REQUIRE(actor->forwarded == 1);
+    REQUIRE(actor->res_val == 5);
+    REQUIRE(actor->sent_msg);
+    REQUIRE(actor->served_msg == actor->sent_msg);
+    REQUIRE(actor->responded_msg == actor->sent_msg);
+    REQUIRE(actor->response_address == actor->get_address());
+    REQUIRE(sup->active_timers.size() == 0);
+    REQUIRE(sup->get_requests().size() == 0);
+
+    sup->do_shutdown();
+    sup->do_process();
+    REQUIRE(sup->get_state() == r::state_t::SHUTTED_DOWN);
+    REQUIRE(sup->get_leader_queue().size() == 0);
+}
+
+TEST_CASE("request is not forwarded, if there are other subscribers", "[actor]") {
+    r::system_context_t system_context;
+
+    auto timeout = r::pt::milliseconds{1};
+    rt::supervisor_config_test_t config(timeout, nullptr);
+    auto sup = system_context.create_supervisor<rt::supervisor_test_t>(nullptr, config);
+    auto observer = sup->create_actor<observer_t>(timeout);
+    auto actor = sup->create_actor<forwarding_actor_t>(timeout);
+    observer->observed_addr = actor->proxy_addr = sup->create_address();
+    sup->do_process();
+
+    REQUIRE(actor->forwarded == 0);
+    REQUIRE(actor->refused == 1);
+    REQUIRE(observer->observed == 1);
+    REQUIRE(actor->served_msg == nullptr);
+    REQUIRE(actor->res_val == 14);
+    REQUIRE(sup->active_timers.size() == 0);
+    REQUIRE(sup->get_requests().size() == 0);
+
+    sup->do_shutdown();
+    sup->do_process();
+    REQUIRE(sup->get_state() == r::state_t::SHUTTED_DOWN);
+    REQUIRE(sup->get_leader_queue().size() == 0);
+}
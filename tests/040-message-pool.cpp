@@ -0,0 +1,134 @@
+//
+// Copyright (c) 2019-2020 Ivan Baidakou (basiliscos) (the dot dmol at gmail dot com)
+//
+// Distributed under the MIT Software License
+//
+
+#include "catch.hpp"
+#include "rotor.hpp"
+#include "supervisor_test.h"
+
+namespace r = rotor;
+namespace rt = r::test;
+
+struct payload_t {
+    int value;
+};
+
+struct big_payload_t {
+    char data[r::message_pool_t::max_block_size];
+};
+
+struct sample_actor_t : public r::actor_base_t {
+    using r::actor_base_t::actor_base_t;
+    r::message_pool_t *pool = nullptr;
+    int received = 0;
+
+    void init_start() noexcept override {
+        subscribe(&sample_actor_t::on_payload);
+        r::actor_base_t::init_start();
+    }
+
+    void on_start(r::message_t<r::payload::start_actor_t> &msg) noexcept override {
+        r::actor_base_t::on_start(msg);
+        send<payload_t>(address, 5);
+    }
+
+    void on_payload(r::message_t<payload_t> &msg) noexcept {
+        pool = r::message_pool_t::current();
+        received += msg.payload.value;
+    }
+};
+
+TEST_CASE("message storage recycling", "[message]") {
+    auto pool = r::message_pool_ptr_t{new r::message_pool_t()};
+    REQUIRE(r::message_pool_t::current() == nullptr);
+
+    SECTION("no active pool, heap is used") {
+        auto msg = r::make_message<payload_t>(r::address_ptr_t{}, 1);
+        REQUIRE(pool->use_count() == 1);
+    }
+
+    SECTION("storage is recycled") {
+        r::message_pool_t::scope_t scope{pool.get()};
+        REQUIRE(r::message_pool_t::current() == pool.get());
+        auto msg = r::make_message<payload_t>(r::address_ptr_t{}, 1);
+        REQUIRE(pool->use_count() == 2);
+        auto raw_ptr = msg.get();
+        msg.reset();
+        REQUIRE(pool->use_count() == 1);
+        msg = r::make_message<payload_t>(r::address_ptr_t{}, 2);
+        REQUIRE(msg.get() == raw_ptr);
+    }
+
+    SECTION("storage is reclaimed from remote release") {
+        r::message_ptr_t msg;
+        {
+            r::message_pool_t::scope_t scope{pool.get()};
+            msg = r::make_message<payload_t>(r::address_ptr_t{}, 1);
+        }
+        msg.reset();
+        REQUIRE(pool->use_count() == 1);
+    }
+
+    SECTION("big messages are taken from heap") {
+        r::message_pool_t::scope_t scope{pool.get()};
+        auto msg = r::make_message<big_payload_t>(r::address_ptr_t{});
+        REQUIRE(pool->use_count() == 1);
+    }
+
+    SECTION("scopes can be nested") {
+        auto pool2 = r::message_pool_ptr_t{new r::message_pool_t()};
+        r::message_pool_t::scope_t scope{pool.get()};
+        {
+            r::message_pool_t::scope_t scope2{pool2.get()};
+            REQUIRE(r::message_pool_t::current() == pool2.get());
+        }
+        REQUIRE(r::message_pool_t::current() == pool.get());
+    }
+
+    SECTION("pool outlives its owner") {
+        r::message_ptr_t msg;
+        {
+            r::message_pool_t::scope_t scope{pool.get()};
+            msg = r::make_message<payload_t>(r::address_ptr_t{}, 1);
+        }
+        r::message_pool_t *raw_pool = pool.get();
+        pool.reset();
+        REQUIRE(raw_pool->use_count() == 1);
+        msg.reset();
+    }
+    REQUIRE(r::message_pool_t::current() == nullptr);
+}
+
+TEST_CASE("locality leader message pool", "[supervisor]") {
+    r::system_context_t system_context;
+    auto timeout = r::pt::milliseconds{1};
+    rt::supervisor_config_test_t config(timeout, nullptr);
+
+    SECTION("enabled") {
+        auto sup = system_context.create_supervisor<rt::supervisor_test_t>(nullptr, config);
+        auto actor = sup->create_actor<sample_actor_t>(timeout);
+        sup->do_process();
+        REQUIRE(actor->received == 5);
+        REQUIRE(actor->pool != nullptr);
+
+        sup->do_shutdown();
+        sup->do_process();
+        REQUIRE(sup->get_state() == r::state_t::SHUTTED_DOWN);
+    }
+
+    SECTION("disabled") {
+        config.message_pool = false;
+        auto sup = system_context.create_supervisor<rt::supervisor_test_t>(nullptr, config);
+        auto actor = sup->create_actor<sample_actor_t>(timeout);
+        sup->do_process();
+        REQUIRE(actor->received == 5);
+        REQUIRE(actor->pool == nullptr);
+
+        sup->do_shutdown();
+        sup->do_process();
+        REQUIRE(sup->get_state() == r::state_t::SHUTTED_DOWN);
+    }
+    REQUIRE(r::message_pool_t::current() == nullptr);
+}
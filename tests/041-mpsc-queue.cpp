@@ -0,0 +1,121 @@
+//
+// Copyright (c) 2019-2020 Ivan Baidakou (basiliscos) (the dot dmol at gmail dot com)
+//
+// Distributed under the MIT Software License
+//
+
+#include "catch.hpp"
+#include "rotor.hpp"
+#include "rotor/mpsc_queue.hpp"
+#include <deque>
+#include <thread>
+#include <vector>
+
+namespace r = rotor;
+
+struct payload_t {
+    std::size_t producer;
+    std::size_t value;
+};
+
+using message_t = r::message_t<payload_t>;
+
+TEST_CASE("mpsc queue basics", "[mpsc]") {
+    r::mpsc_queue_t inbound;
+    std::deque<r::message_ptr_t> queue;
+
+    REQUIRE(inbound.empty());
+    REQUIRE(!inbound.pop_all(queue));
+
+    auto msg = r::make_message<payload_t>(r::address_ptr_t{}, 0u, 1u);
+    auto raw_msg = msg.get();
+    REQUIRE(inbound.push(std::move(msg)));
+    REQUIRE(!inbound.push(r::make_message<payload_t>(r::address_ptr_t{}, 0u, 2u)));
+    REQUIRE(!inbound.push(r::make_message<payload_t>(r::address_ptr_t{}, 0u, 3u)));
+    REQUIRE(!inbound.empty());
+    REQUIRE(raw_msg->use_count() == 1);
+
+    REQUIRE(inbound.pop_all(queue));
+    REQUIRE(inbound.empty());
+    REQUIRE(queue.size() == 3);
+    for (std::size_t i = 0; i < queue.size(); ++i) {
+        auto &m = static_cast<message_t &>(*queue[i]);
+        REQUIRE(m.payload.value == i + 1);
+        REQUIRE(m.next == nullptr);
+    }
+    REQUIRE(queue.front().get() == raw_msg);
+    REQUIRE(raw_msg->use_count() == 1);
+
+    SECTION("queue becomes empty again") {
+        REQUIRE(inbound.push(r::make_message<payload_t>(r::address_ptr_t{}, 0u, 4u)));
+    }
+}
+
+TEST_CASE("mpsc queue, multiple producers", "[mpsc]") {
+    const std::size_t producers = 4;
+    const std::size_t per_producer = 10000;
+    r::mpsc_queue_t inbound;
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < producers; ++i) {
+        threads.emplace_back([&inbound, i] {
+            for (std::size_t j = 0; j < per_producer; ++j) {
+                inbound.push(r::make_message<payload_t>(r::address_ptr_t{}, i, j));
+            }
+        });
+    }
+
+    std::vector<std::size_t> expected(producers, 0);
+    std::size_t received = 0;
+    std::deque<r::message_ptr_t> queue;
+    bool ordered = true;
+    while (received < producers * per_producer) {
+        inbound.pop_all(queue);
+        while (!queue.empty()) {
+            auto &m = static_cast<message_t &>(*queue.front());
+            ordered = ordered && (expected[m.payload.producer]++ == m.payload.value);
+            queue.pop_front();
+            ++received;
+        }
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    REQUIRE(ordered);
+    REQUIRE(inbound.empty());
+}
+
+TEST_CASE("mpsc queue, the same message pushed several times", "[mpsc]") {
+    std::deque<r::message_ptr_t> queue;
+    auto msg = r::make_message<payload_t>(r::address_ptr_t{}, 0u, 1u);
+    auto raw_msg = msg.get();
+
+    SECTION("consumed") {
+        r::mpsc_queue_t inbound;
+        REQUIRE(inbound.push(r::message_ptr_t{msg}));
+        REQUIRE(!inbound.push(r::message_ptr_t{msg}));
+        REQUIRE(!inbound.push(r::make_message<payload_t>(r::address_ptr_t{}, 0u, 2u)));
+        REQUIRE(!inbound.push(r::message_ptr_t{msg}));
+        REQUIRE(raw_msg->linked);
+
+        REQUIRE(inbound.pop_all(queue) == 4);
+        REQUIRE(queue.size() == 4);
+        REQUIRE(queue[0].get() == raw_msg);
+        REQUIRE(queue[1].get() == raw_msg);
+        REQUIRE(static_cast<message_t &>(*queue[2]).payload.value == 2);
+        REQUIRE(queue[3].get() == raw_msg);
+        REQUIRE(!raw_msg->linked);
+        REQUIRE(raw_msg->next == nullptr);
+        queue.clear();
+        REQUIRE(raw_msg->use_count() == 1);
+    }
+
+    SECTION("released") {
+        {
+            r::mpsc_queue_t inbound;
+            inbound.push(r::message_ptr_t{msg});
+            inbound.push(r::message_ptr_t{msg});
+        }
+        REQUIRE(!raw_msg->linked);
+        REQUIRE(raw_msg->use_count() == 1);
+    }
+}
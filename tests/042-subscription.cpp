@@ -0,0 +1,264 @@
+//
+// Copyright (c) 2019-2020 Ivan Baidakou (basiliscos) (the dot dmol at gmail dot com)
+//
+// Distributed under the MIT Software License
+//
+
+#include "catch.hpp"
+#include "rotor.hpp"
+#include "supervisor_test.h"
+#include <random>
+#include <vector>
+
+namespace r = rotor;
+namespace rt = r::test;
+
+struct foo_t {};
+struct bar_t {};
+
+struct sample_actor_t : public r::actor_base_t {
+    using r::actor_base_t::actor_base_t;
+
+    void on_foo(r::message_t<foo_t> &) noexcept {}
+    void on_bar(r::message_t<bar_t> &) noexcept {}
+};
+
+struct foo_listener_t : public r::actor_base_t {
+    using r::actor_base_t::actor_base_t;
+
+    void init_start() noexcept override {
+        subscribe(&foo_listener_t::on_foo, topic);
+        r::actor_base_t::init_start();
+    }
+
+    void on_foo(r::message_t<foo_t> &) noexcept { ++received; }
+
+    r::address_ptr_t topic;
+    std::size_t received = 0;
+};
+
+TEST_CASE("subscription index", "[subscription]") {
+    r::system_context_t system_context;
+    auto timeout = r::pt::milliseconds{1};
+    rt::supervisor_config_test_t config(timeout, nullptr);
+    auto sup = system_context.create_supervisor<rt::supervisor_test_t>(nullptr, config);
+    auto actor = sup->create_actor<sample_actor_t>(timeout);
+    auto actor2 = sup->create_actor<sample_actor_t>(timeout);
+    sup->do_process();
+
+    r::subscription_t subscription(*sup);
+    auto foo_type = r::message_t<foo_t>::message_type;
+    auto bar_type = r::message_t<bar_t>::message_type;
+
+    SECTION("(address, message type) pairs") {
+        auto addr = sup->make_address();
+        auto h_foo = r::wrap_handler(*actor, &sample_actor_t::on_foo);
+        auto h_foo2 = r::wrap_handler(*actor2, &sample_actor_t::on_foo);
+        auto h_bar = r::wrap_handler(*actor, &sample_actor_t::on_bar);
+        REQUIRE(!subscription.get_recipients(*addr, foo_type));
+
+        subscription.subscribe(addr, h_foo);
+        subscription.subscribe(addr, h_foo2);
+        subscription.subscribe(addr, h_bar);
+        REQUIRE(subscription.size() == 2);
+
+        auto foos = subscription.get_recipients(*addr, foo_type);
+        REQUIRE(foos);
+        REQUIRE(foos->size() == 2);
+        REQUIRE(foos->at(0).mine);
+        REQUIRE(subscription.get_recipients(*addr, bar_type)->size() == 1);
+
+        auto msg = r::make_message<foo_t>(addr);
+        REQUIRE(subscription.get_recipients(*msg) == foos);
+        REQUIRE(!subscription.get_recipients(*sup->make_address(), foo_type));
+
+        subscription.unsubscribe(addr, h_foo);
+        REQUIRE(subscription.size() == 2);
+        REQUIRE(subscription.get_recipients(*addr, foo_type)->size() == 1);
+
+        subscription.unsubscribe(addr, h_foo2);
+        REQUIRE(subscription.size() == 1);
+        REQUIRE(!subscription.get_recipients(*addr, foo_type));
+
+        subscription.unsubscribe(addr, h_bar);
+        REQUIRE(subscription.size() == 0);
+        REQUIRE(!subscription.get_recipients(*addr, bar_type));
+    }
+
+    SECTION("growth and removals") {
+        const std::size_t count = 1000;
+        std::vector<r::address_ptr_t> addresses;
+        auto h_foo = r::wrap_handler(*actor, &sample_actor_t::on_foo);
+        auto h_bar = r::wrap_handler(*actor, &sample_actor_t::on_bar);
+        for (std::size_t i = 0; i < count; ++i) {
+            auto addr = sup->make_address();
+            subscription.subscribe(addr, h_foo);
+            subscription.subscribe(addr, h_bar);
+            addresses.emplace_back(std::move(addr));
+        }
+        REQUIRE(subscription.size() == count * 2);
+
+        std::mt19937 gen(count);
+        std::shuffle(addresses.begin(), addresses.end(), gen);
+        auto half = count / 2;
+        for (std::size_t i = 0; i < half; ++i) {
+            subscription.unsubscribe(addresses[i], h_foo);
+        }
+        REQUIRE(subscription.size() == count * 2 - half);
+
+        bool ok = true;
+        for (std::size_t i = 0; i < count; ++i) {
+            auto &addr = *addresses[i];
+            ok = ok && (!subscription.get_recipients(addr, foo_type) == (i < half));
+            ok = ok && subscription.get_recipients(addr, bar_type);
+        }
+        REQUIRE(ok);
+
+        for (std::size_t i = 0; i < count; ++i) {
+            if (i >= half) {
+                subscription.unsubscribe(addresses[i], h_foo);
+            }
+            subscription.unsubscribe(addresses[i], h_bar);
+        }
+        REQUIRE(subscription.size() == 0);
+    }
+
+    sup->do_shutdown();
+    sup->do_process();
+    REQUIRE(sup->get_state() == r::state_t::SHUTTED_DOWN);
+    REQUIRE(sup->get_subscription().size() == 0);
+}
+
+TEST_CASE("external handlers are batched per supervisor", "[subscription]") {
+    r::system_context_t system_context;
+
+    const char locality1[] = "l1";
+    const char locality2[] = "l2";
+    auto timeout = r::pt::milliseconds{1};
+    rt::supervisor_config_test_t config1(timeout, locality1);
+    rt::supervisor_config_test_t config2(timeout, locality2);
+    auto sup1 = system_context.create_supervisor<rt::supervisor_test_t>(nullptr, config1);
+    auto sup2 = sup1->create_actor<rt::supervisor_test_t>(timeout, config2);
+    auto topic = sup1->make_address();
+
+    const std::size_t count = 5;
+    std::vector<r::intrusive_ptr_t<foo_listener_t>> listeners;
+    for (std::size_t i = 0; i < count; ++i) {
+        auto listener = sup2->create_actor<foo_listener_t>(timeout);
+        listener->topic = topic;
+        listeners.emplace_back(std::move(listener));
+    }
+    auto local_listener = sup1->create_actor<foo_listener_t>(timeout);
+    local_listener->topic = topic;
+
+    while (!sup1->get_leader_queue().empty() || !sup2->get_leader_queue().empty()) {
+        sup1->do_process();
+        sup2->do_process();
+    }
+    auto entry = sup1->get_subscription().get_entry(*topic, r::message_t<foo_t>::message_type);
+    REQUIRE(entry);
+    REQUIRE(entry->recipients.size() == count + 1);
+    REQUIRE(entry->foreign.size() == 1);
+    REQUIRE(entry->foreign.front()->size() == count);
+
+    sup1->put(r::make_message<foo_t>(topic));
+    sup1->do_process();
+    REQUIRE(local_listener->received == 1);
+    REQUIRE(sup2->get_leader_queue().size() == 1);
+
+    sup2->do_process();
+    for (auto &listener : listeners) {
+        CHECK(listener->received == 1);
+    }
+
+    auto batch = entry->foreign.front();
+    sup2->do_shutdown();
+    while (!sup1->get_leader_queue().empty() || !sup2->get_leader_queue().empty()) {
+        sup1->do_process();
+        sup2->do_process();
+    }
+    REQUIRE(sup2->get_state() == r::state_t::SHUTTED_DOWN);
+    REQUIRE(batch->size() == count);
+    entry = sup1->get_subscription().get_entry(*topic, r::message_t<foo_t>::message_type);
+    REQUIRE(entry);
+    REQUIRE(entry->recipients.size() == 1);
+    REQUIRE(entry->foreign.empty());
+
+    sup1->do_shutdown();
+    while (!sup1->get_leader_queue().empty()) {
+        sup1->do_process();
+    }
+    REQUIRE(sup1->get_state() == r::state_t::SHUTTED_DOWN);
+    REQUIRE(sup1->get_subscription().size() == 0);
+}
+
+/* records, whether the message has been already forwarded to the other supervisor */
+struct probe_listener_t : public r::actor_base_t {
+    using r::actor_base_t::actor_base_t;
+
+    void init_start() noexcept override {
+        subscribe(&probe_listener_t::on_foo, topic);
+        r::actor_base_t::init_start();
+    }
+
+    void on_foo(r::message_t<foo_t> &) noexcept { forwarded = other->get_leader_queue().size(); }
+
+    r::address_ptr_t topic;
+    rt::supervisor_test_t *other = nullptr;
+    std::size_t forwarded = 0;
+};
+
+TEST_CASE("local and external handlers are invoked in the subscription order", "[subscription]") {
+    r::system_context_t system_context;
+
+    const char locality1[] = "l1";
+    const char locality2[] = "l2";
+    auto timeout = r::pt::milliseconds{1};
+    rt::supervisor_config_test_t config1(timeout, locality1);
+    rt::supervisor_config_test_t config2(timeout, locality2);
+    auto sup1 = system_context.create_supervisor<rt::supervisor_test_t>(nullptr, config1);
+    auto sup2 = sup1->create_actor<rt::supervisor_test_t>(timeout, config2);
+    auto topic = sup1->make_address();
+
+    auto local_listener = sup1->create_actor<probe_listener_t>(timeout);
+    local_listener->topic = topic;
+    local_listener->other = sup2.get();
+    while (!sup1->get_leader_queue().empty() || !sup2->get_leader_queue().empty()) {
+        sup1->do_process();
+        sup2->do_process();
+    }
+    auto listener = sup2->create_actor<foo_listener_t>(timeout);
+    listener->topic = topic;
+    while (!sup1->get_leader_queue().empty() || !sup2->get_leader_queue().empty()) {
+        sup1->do_process();
+        sup2->do_process();
+    }
+
+    sup1->put(r::make_message<foo_t>(topic));
+    sup1->do_process();
+    // the local handler has been subscribed first, i.e. it is invoked before the forwarding
+    REQUIRE(local_listener->forwarded == 0);
+    REQUIRE(sup2->get_leader_queue().size() == 1);
+    sup2->do_process();
+    REQUIRE(listener->received == 1);
+
+    sup1->do_shutdown();
+    while (!sup1->get_leader_queue().empty() || !sup2->get_leader_queue().empty()) {
+        sup1->do_process();
+        sup2->do_process();
+    }
+    REQUIRE(sup1->get_state() == r::state_t::SHUTTED_DOWN);
+}
+
+TEST_CASE("dense message type ids", "[message]") {
+    auto foo_type = r::message_t<foo_t>::message_type;
+    auto bar_type = r::message_t<bar_t>::message_type;
+    auto start_type = r::message_t<r::payload::start_actor_t>::message_type;
+    REQUIRE(foo_type != 0);
+    REQUIRE(bar_type != 0);
+    REQUIRE(foo_type != bar_type);
+    REQUIRE(foo_type != start_type);
+
+    auto msg = r::make_message<foo_t>(r::address_ptr_t{});
+    REQUIRE(msg->type_index == foo_type);
+}
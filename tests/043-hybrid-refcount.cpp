@@ -0,0 +1,74 @@
+//
+// Copyright (c) 2019-2020 Ivan Baidakou (basiliscos) (the dot dmol at gmail dot com)
+//
+// Distributed under the MIT Software License
+//
+
+#include "catch.hpp"
+#include "rotor.hpp"
+#include "rotor/mpsc_queue.hpp"
+#include <deque>
+#include <thread>
+#include <vector>
+
+namespace r = rotor;
+
+struct sample_t : public r::hybrid_arc_base_t<sample_t> {
+    sample_t(int &destroyed_) : destroyed{destroyed_} {}
+    ~sample_t() { ++destroyed; }
+    int &destroyed;
+};
+
+using sample_ptr_t = r::intrusive_ptr_t<sample_t>;
+
+struct payload_t {};
+
+TEST_CASE("hybrid refcounter", "[arc]") {
+    int destroyed = 0;
+    auto ptr = sample_ptr_t{new sample_t(destroyed)};
+    REQUIRE(!ptr->is_shared());
+    REQUIRE(ptr->use_count() == 1);
+
+    SECTION("local") {
+        auto copy = ptr;
+        REQUIRE(ptr->use_count() == 2);
+        copy.reset();
+        REQUIRE(ptr->use_count() == 1);
+        ptr.reset();
+        REQUIRE(destroyed == 1);
+    }
+
+    SECTION("shared") {
+        const std::size_t iterations = 100000;
+        ptr->share();
+        REQUIRE(ptr->is_shared());
+        auto fn = [&]() {
+            for (std::size_t i = 0; i < iterations; ++i) {
+                auto copy = ptr;
+            }
+        };
+        std::thread t1(fn), t2(fn);
+        t1.join();
+        t2.join();
+        REQUIRE(ptr->use_count() == 1);
+        ptr.reset();
+        REQUIRE(destroyed == 1);
+    }
+}
+
+#if defined(ROTOR_REFCOUNT_HYBRID) && !defined(ROTOR_REFCOUNT_THREADUNSAFE)
+TEST_CASE("messages are shared on hand over", "[message]") {
+    auto msg = r::make_message<payload_t>(r::address_ptr_t{});
+    auto envelope = r::make_message<r::payload::handler_call_t>(r::address_ptr_t{}, msg, r::handlers_batch_ptr_t{});
+    REQUIRE(!msg->is_shared());
+    REQUIRE(!envelope->is_shared());
+
+    r::mpsc_queue_t inbound;
+    inbound.push(std::move(envelope));
+    REQUIRE(msg->is_shared());
+
+    std::deque<r::message_ptr_t> queue;
+    inbound.pop_all(queue);
+    REQUIRE(queue.front()->is_shared());
+}
+#endif
@@ -0,0 +1,187 @@
+//
+// Copyright (c) 2019-2020 Ivan Baidakou (basiliscos) (the dot dmol at gmail dot com)
+//
+// Distributed under the MIT Software License
+//
+
+#include "catch.hpp"
+#include "rotor.hpp"
+#include "supervisor_test.h"
+
+namespace r = rotor;
+namespace rt = r::test;
+
+struct payload_t {
+    std::size_t value;
+};
+
+struct alarm_t {
+    std::size_t value;
+};
+
+namespace rotor {
+template <> struct payload_priority_t<alarm_t> : std::true_type {};
+} // namespace rotor
+
+using message_t = r::message_t<payload_t>;
+
+struct listener_t : public r::actor_base_t {
+    using r::actor_base_t::actor_base_t;
+    std::vector<std::size_t> received;
+
+    void init_start() noexcept override {
+        subscribe(&listener_t::on_payload);
+        subscribe(&listener_t::on_alarm);
+        r::actor_base_t::init_start();
+    }
+
+    void on_payload(r::message_t<payload_t> &msg) noexcept { received.push_back(msg.payload.value); }
+
+    void on_alarm(r::message_t<alarm_t> &msg) noexcept { received.push_back(msg.payload.value); }
+};
+
+TEST_CASE("message queue basics", "[queue]") {
+    r::message_queue_t queue;
+    REQUIRE(queue.empty());
+    REQUIRE(queue.capacity() == 0);
+
+    auto msg = r::make_message<payload_t>(r::address_ptr_t{}, 1u);
+    auto raw_msg = msg.get();
+    queue.emplace_back(std::move(msg));
+    REQUIRE(!msg);
+    REQUIRE(raw_msg->use_count() == 1);
+    REQUIRE(queue.size() == 1);
+    REQUIRE(queue.front().get() == raw_msg);
+
+    auto popped = queue.pop_front();
+    REQUIRE(popped.get() == raw_msg);
+    REQUIRE(raw_msg->use_count() == 1);
+    REQUIRE(queue.empty());
+}
+
+TEST_CASE("message queue growth and wrap around", "[queue]") {
+    r::message_queue_t queue(5);
+    REQUIRE(queue.capacity() == 16);
+
+    std::size_t pushed = 0, popped = 0;
+    bool ok = true;
+    auto check_pop = [&]() {
+        auto msg = queue.pop_front();
+        ok = ok && static_cast<message_t *>(msg.get())->payload.value == popped++;
+    };
+
+    // move the head, so the growth happens on wrapped buffer
+    for (std::size_t i = 0; i < 10; ++i) {
+        queue.emplace_back(r::make_message<payload_t>(r::address_ptr_t{}, pushed++));
+    }
+    for (std::size_t i = 0; i < 7; ++i) {
+        check_pop();
+    }
+    for (std::size_t i = 0; i < 100; ++i) {
+        queue.emplace_back(r::make_message<payload_t>(r::address_ptr_t{}, pushed++));
+    }
+    REQUIRE(queue.size() == 103);
+    REQUIRE(queue.capacity() == 128);
+
+    while (queue.size() > 3) {
+        check_pop();
+    }
+    REQUIRE(ok);
+
+    auto msg = r::make_message<payload_t>(r::address_ptr_t{}, pushed++);
+    auto raw_msg = msg.get();
+    queue.emplace_back(std::move(msg));
+    REQUIRE(raw_msg->use_count() == 1);
+    queue.clear();
+    REQUIRE(queue.empty());
+    REQUIRE(queue.capacity() == 128);
+}
+
+TEST_CASE("supervisor queue high water mark", "[queue]") {
+    r::system_context_t system_context;
+    auto timeout = r::pt::milliseconds{1};
+    rt::supervisor_config_test_t config(timeout, nullptr);
+    config.queue_reserve = 100;
+    auto sup = system_context.create_supervisor<rt::supervisor_test_t>(nullptr, config);
+    REQUIRE(sup->get_leader_queue().capacity() == 128);
+
+    sup->do_process();
+    REQUIRE(sup->get_state() == r::state_t::OPERATIONAL);
+
+    auto start_mark = sup->get_queue_high_water_mark();
+    REQUIRE(start_mark > 0);
+    for (std::size_t i = 0; i < start_mark + 10; ++i) {
+        sup->put(r::make_message<payload_t>(sup->get_address(), i));
+    }
+    sup->do_process();
+    REQUIRE(sup->get_queue_high_water_mark() == start_mark + 10);
+    REQUIRE(sup->get_leader_queue().capacity() == 128);
+
+    sup->do_shutdown();
+    sup->do_process();
+    REQUIRE(sup->get_state() == r::state_t::SHUTTED_DOWN);
+}
+
+TEST_CASE("message lanes", "[queue]") {
+    REQUIRE(!r::make_message<payload_t>(r::address_ptr_t{}, 0u)->urgent);
+    REQUIRE(r::make_message<alarm_t>(r::address_ptr_t{}, 0u)->urgent);
+    REQUIRE(r::make_message<r::payload::start_actor_t>(r::address_ptr_t{}, r::address_ptr_t{})->urgent);
+    REQUIRE(r::payload_priority_t<r::message::init_request_t::payload_t>::value);
+    REQUIRE(r::payload_priority_t<r::message::init_response_t::payload_t>::value);
+    // the shutdown does not overtake the user traffic, but it is never dropped
+    auto trigger = r::make_message<r::payload::shutdown_trigger_t>(r::address_ptr_t{}, r::address_ptr_t{});
+    REQUIRE(!trigger->urgent);
+    REQUIRE(trigger->control);
+    REQUIRE(!r::payload_priority_t<r::message::shutdown_request_t::payload_t>::value);
+    REQUIRE(!r::payload_priority_t<r::message::shutdown_response_t::payload_t>::value);
+
+    r::message_lanes_t lanes(20);
+    REQUIRE(lanes.capacity() == 32);
+    for (std::size_t i = 0; i < 3; ++i) {
+        lanes.emplace_back(r::make_message<payload_t>(r::address_ptr_t{}, i));
+    }
+    lanes.emplace_back(r::make_message<alarm_t>(r::address_ptr_t{}, 10u));
+    lanes.emplace_back(r::make_message<payload_t>(r::address_ptr_t{}, 3u));
+    lanes.emplace_back(r::make_message<alarm_t>(r::address_ptr_t{}, 11u));
+    REQUIRE(lanes.size() == 6);
+    REQUIRE(lanes.urgent_size() == 2);
+
+    std::vector<std::size_t> order;
+    while (!lanes.empty()) {
+        auto message = lanes.pop_front();
+        if (message->urgent) {
+            order.push_back(static_cast<r::message_t<alarm_t> &>(*message).payload.value);
+        } else {
+            order.push_back(static_cast<message_t &>(*message).payload.value);
+        }
+    }
+    REQUIRE(order == std::vector<std::size_t>{10, 11, 0, 1, 2, 3});
+}
+
+TEST_CASE("urgent messages overtake the regular ones", "[queue]") {
+    r::system_context_t system_context;
+    auto timeout = r::pt::milliseconds{1};
+    rt::supervisor_config_test_t config(timeout, nullptr);
+    auto sup = system_context.create_supervisor<rt::supervisor_test_t>(nullptr, config);
+    auto actor = sup->create_actor<listener_t>(timeout);
+    sup->do_process();
+    REQUIRE(actor->get_state() == r::state_t::OPERATIONAL);
+
+    auto addr = actor->get_address();
+    sup->put(r::make_message<payload_t>(addr, 1u));
+    sup->put(r::make_message<payload_t>(addr, 2u));
+    sup->put(r::make_message<alarm_t>(addr, 100u));
+    sup->do_process();
+    REQUIRE(actor->received == std::vector<std::size_t>{100, 1, 2});
+
+    // the shutdown does not overtake the messages, already queued for the actor
+    for (std::size_t i = 0; i < 10000; ++i) {
+        sup->put(r::make_message<payload_t>(addr, i));
+    }
+    sup->do_shutdown();
+    sup->do_process();
+    REQUIRE(sup->get_state() == r::state_t::SHUTTED_DOWN);
+    REQUIRE(actor->get_state() == r::state_t::SHUTTED_DOWN);
+    REQUIRE(actor->received.size() == 10003);
+    REQUIRE(sup->get_leader_queue().size() == 0);
+}
@@ -0,0 +1,306 @@
+//
+// Copyright (c) 2019-2020 Ivan Baidakou (basiliscos) (the dot dmol at gmail dot com)
+//
+// Distributed under the MIT Software License
+//
+
+#include "catch.hpp"
+#include "rotor.hpp"
+#include <algorithm>
+#include <map>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace r = rotor;
+
+using tick_t = r::timer_wheel_t::tick_t;
+using timer_id_t = r::timer_wheel_t::timer_id_t;
+
+TEST_CASE("timer wheel basics", "[timer]") {
+    // the wheel is started at the beginning of the lowest level round, so the
+    // near timers below are not cascaded, i.e. `next_tick` is their deadline
+    while (r::timer_wheel_t::now() % 64 > 32) {
+        std::this_thread::yield();
+    }
+    r::timer_wheel_t wheel;
+    std::vector<timer_id_t> expired;
+    auto base = r::timer_wheel_t::now();
+    REQUIRE(wheel.empty());
+    REQUIRE(wheel.next_tick() == r::timer_wheel_t::never);
+
+    wheel.start(1, base + 10);
+    wheel.start(2, base + 5);
+    wheel.start(3, base + 100000);
+    REQUIRE(wheel.size() == 3);
+    REQUIRE(wheel.next_tick() == base + 5);
+    REQUIRE(wheel.next_deadline() == base + 5);
+
+    wheel.advance(base + 4, expired);
+    REQUIRE(expired.empty());
+
+    wheel.advance(base + 10, expired);
+    REQUIRE(expired == std::vector<timer_id_t>{2, 1});
+    expired.clear();
+
+    REQUIRE(wheel.cancel(3));
+    REQUIRE(!wheel.cancel(3));
+    REQUIRE(wheel.empty());
+    wheel.advance(base + 200000, expired);
+    REQUIRE(expired.empty());
+
+    SECTION("deadline rounding") {
+        REQUIRE(r::timer_wheel_t::deadline(base, r::pt::milliseconds{10}) == base + 11);
+        REQUIRE(r::timer_wheel_t::deadline(base, r::pt::microseconds{1500}) == base + 3);
+        REQUIRE(r::timer_wheel_t::deadline(base, r::pt::milliseconds{0}) == base + 1);
+    }
+
+    SECTION("timeout is inverse of deadline") {
+        auto deadline = r::timer_wheel_t::deadline(base, r::pt::milliseconds{10});
+        REQUIRE(r::timer_wheel_t::timeout(base + 3, deadline) == r::pt::milliseconds{7});
+        REQUIRE(r::timer_wheel_t::deadline(base + 3, r::pt::milliseconds{7}) == deadline);
+        REQUIRE(r::timer_wheel_t::timeout(base + 20, deadline) == r::pt::milliseconds{0});
+    }
+}
+
+TEST_CASE("timer wheel vs reference", "[timer]") {
+    r::timer_wheel_t wheel;
+    std::vector<timer_id_t> expired;
+    auto now = r::timer_wheel_t::now();
+
+    std::mt19937_64 gen(42);
+    std::map<timer_id_t, tick_t> reference;
+    timer_id_t last_id = 0;
+    auto spawn = [&](tick_t max_delay) {
+        auto deadline = now + 1 + gen() % max_delay;
+        wheel.start(++last_id, deadline);
+        reference.emplace(last_id, deadline);
+    };
+
+    bool ok = true;
+    for (std::size_t round = 0; round < 2000 && ok; ++round) {
+        auto spawns = gen() % 8;
+        for (std::size_t i = 0; i < spawns; ++i) {
+            // short, medium, long and "overflow" timers
+            static const tick_t ranges[] = {64, 5000, 300000, tick_t{1} << 26};
+            spawn(ranges[gen() % 4]);
+        }
+        if (!reference.empty() && gen() % 3 == 0) {
+            auto it = reference.begin();
+            std::advance(it, gen() % reference.size());
+            ok = ok && wheel.cancel(it->first);
+            reference.erase(it);
+        }
+
+        // sometimes jump to the next deadline, sometimes far away
+        auto next = wheel.next_tick();
+        ok = ok && (reference.empty() == (next == r::timer_wheel_t::never));
+        auto next_deadline = wheel.next_deadline();
+        if (!reference.empty()) {
+            auto earliest = r::timer_wheel_t::never;
+            for (auto &it : reference) {
+                earliest = std::min(earliest, it.second);
+            }
+            // overflow timers are approximated by their re-insertion tick
+            ok = ok && next <= next_deadline && next_deadline <= earliest;
+            ok = ok && (((earliest ^ now) >> 24) || next_deadline == earliest);
+        }
+        tick_t step = gen() % 3 ? (gen() % 100) : (gen() % (tick_t{1} << 20));
+        now += step;
+        wheel.advance(now, expired);
+        for (auto id : expired) {
+            auto it = reference.find(id);
+            ok = ok && it != reference.end() && it->second <= now;
+            if (it != reference.end()) {
+                reference.erase(it);
+            }
+        }
+        expired.clear();
+        for (auto &it : reference) {
+            ok = ok && it.second > now;
+        }
+        ok = ok && wheel.size() == reference.size();
+    }
+    REQUIRE(ok);
+
+    // drain everything
+    now += tick_t{1} << 27;
+    wheel.advance(now, expired);
+    REQUIRE(expired.size() == reference.size());
+    REQUIRE(wheel.empty());
+}
+
+struct wheel_supervisor_t : public r::supervisor_t {
+    using r::supervisor_t::supervisor_t;
+    using r::supervisor_t::timers;
+
+    void start() noexcept override {}
+    void shutdown() noexcept override {}
+    void enqueue(r::message_ptr_t) noexcept override {}
+
+    void arm_timer(const r::pt::time_duration &delay) noexcept override {
+        ++armed;
+        last_delay = delay;
+    }
+    void disarm_timer() noexcept override { ++disarmed; }
+
+    std::size_t armed = 0;
+    std::size_t disarmed = 0;
+    r::pt::time_duration last_delay;
+};
+
+TEST_CASE("supervisor arms single native timer", "[timer]") {
+    r::system_context_t system_context;
+    r::supervisor_config_t config{r::pt::seconds{10}};
+    auto sup = system_context.create_supervisor<wheel_supervisor_t>(nullptr, config);
+    sup->do_process();
+    REQUIRE(sup->timers.empty());
+    auto armed = sup->armed;
+    auto disarmed = sup->disarmed;
+
+    sup->start_timer(r::pt::seconds{5}, 1001);
+    REQUIRE(sup->armed == armed + 1);
+    REQUIRE(sup->last_delay > r::pt::seconds{4});
+
+    // later deadline does not re-arm
+    sup->start_timer(r::pt::seconds{7}, 1002);
+    REQUIRE(sup->armed == armed + 1);
+
+    // earlier deadline re-arms
+    sup->start_timer(r::pt::milliseconds{1}, 1003);
+    REQUIRE(sup->armed == armed + 2);
+    REQUIRE(sup->last_delay <= r::pt::milliseconds{2});
+
+    sup->cancel_timer(1001);
+    sup->cancel_timer(1003);
+    REQUIRE(sup->disarmed == disarmed);
+    sup->cancel_timer(1002);
+    REQUIRE(sup->disarmed == disarmed + 1);
+    REQUIRE(sup->timers.empty());
+
+    sup->do_shutdown();
+    sup->do_process();
+    REQUIRE(sup->get_state() == r::state_t::SHUTTED_DOWN);
+}
+
+struct answer_t {
+    int value;
+};
+
+struct question_t {
+    using response_t = answer_t;
+    int value;
+};
+
+using traits_t = r::request_traits_t<question_t>;
+
+struct worker_t : public r::actor_base_t {
+    using r::actor_base_t::actor_base_t;
+    r::intrusive_ptr_t<traits_t::request::message_t> req_msg;
+
+    void init_start() noexcept override {
+        subscribe(&worker_t::on_request);
+        r::actor_base_t::init_start();
+    }
+
+    void on_request(traits_t::request::message_t &msg) noexcept { req_msg.reset(&msg); }
+};
+
+struct proxy_t : public r::actor_base_t {
+    using r::actor_base_t::actor_base_t;
+    r::address_ptr_t worker;
+    r::intrusive_ptr_t<traits_t::request::message_t> req_msg;
+
+    void init_start() noexcept override {
+        subscribe(&proxy_t::on_request);
+        subscribe(&proxy_t::on_response);
+        r::actor_base_t::init_start();
+    }
+
+    void on_request(traits_t::request::message_t &msg) noexcept {
+        req_msg.reset(&msg);
+        request<question_t>(worker, msg.payload.request_payload.value).send_within(msg.payload);
+    }
+
+    void on_response(traits_t::response::message_t &msg) noexcept {
+        reply_to(*req_msg, msg.payload.res.value);
+        req_msg.reset();
+    }
+};
+
+struct requester_t : public r::actor_base_t {
+    using r::actor_base_t::actor_base_t;
+    int value = 0;
+
+    void init_start() noexcept override {
+        subscribe(&requester_t::on_response);
+        r::actor_base_t::init_start();
+    }
+
+    void on_response(traits_t::response::message_t &msg) noexcept { value = msg.payload.res.value; }
+};
+
+TEST_CASE("nested request inherits the deadline", "[timer]") {
+    r::system_context_t system_context;
+    r::supervisor_config_t config{r::pt::seconds{10}};
+    auto sup = system_context.create_supervisor<wheel_supervisor_t>(nullptr, config);
+    auto worker = sup->create_actor<worker_t>(r::pt::seconds{10});
+    auto proxy = sup->create_actor<proxy_t>(r::pt::seconds{10});
+    auto requester = sup->create_actor<requester_t>(r::pt::seconds{10});
+    proxy->worker = worker->get_address();
+    sup->do_process();
+    REQUIRE(sup->timers.empty());
+
+    auto armed = sup->armed;
+    requester->request<question_t>(proxy->get_address(), 7).send(r::pt::seconds{5});
+    sup->do_process();
+    REQUIRE(worker->req_msg);
+    REQUIRE(proxy->req_msg);
+    REQUIRE(sup->timers.size() == 2);
+    REQUIRE(sup->armed == armed + 1);
+    REQUIRE(worker->req_msg->payload.deadline == proxy->req_msg->payload.deadline);
+    REQUIRE(sup->timers.next_deadline() == proxy->req_msg->payload.deadline);
+
+    worker->reply_to(*worker->req_msg, 42);
+    worker->req_msg.reset();
+    sup->do_process();
+    REQUIRE(requester->value == 42);
+    REQUIRE(sup->timers.empty());
+
+    sup->do_shutdown();
+    sup->do_process();
+    REQUIRE(sup->get_state() == r::state_t::SHUTTED_DOWN);
+}
+
+TEST_CASE("nested request of the request without deadline", "[timer]") {
+    r::system_context_t system_context;
+    r::supervisor_config_t config{r::pt::seconds{10}};
+    auto sup = system_context.create_supervisor<wheel_supervisor_t>(nullptr, config);
+    auto worker = sup->create_actor<worker_t>(r::pt::seconds{10});
+    auto proxy = sup->create_actor<proxy_t>(r::pt::seconds{10});
+    auto requester = sup->create_actor<requester_t>(r::pt::seconds{10});
+    proxy->worker = worker->get_address();
+    sup->do_process();
+
+    // the request is not sent via the builder, i.e. it has no deadline
+    auto reply_to = requester->get_address();
+    auto request = r::make_message<traits_t::request::wrapped_t>(proxy->get_address(), r::request_id_t{0}, reply_to, 7);
+    auto &payload = static_cast<traits_t::request::message_t &>(*request).payload;
+    REQUIRE(payload.deadline == r::timer_wheel_t::never);
+    sup->put(std::move(request));
+    sup->do_process();
+    REQUIRE(worker->req_msg);
+    REQUIRE(worker->req_msg->payload.deadline == r::timer_wheel_t::never);
+    REQUIRE(sup->timers.empty());
+
+    worker->reply_to(*worker->req_msg, 42);
+    worker->req_msg.reset();
+    sup->do_process();
+    REQUIRE(!proxy->req_msg);
+    REQUIRE(requester->value == 42);
+    REQUIRE(sup->timers.empty());
+
+    sup->do_shutdown();
+    sup->do_process();
+    REQUIRE(sup->get_state() == r::state_t::SHUTTED_DOWN);
+}
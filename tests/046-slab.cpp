@@ -0,0 +1,89 @@
+//
+// Copyright (c) 2019-2020 Ivan Baidakou (basiliscos) (the dot dmol at gmail dot com)
+//
+// Distributed under the MIT Software License
+//
+
+#include "catch.hpp"
+#include "rotor.hpp"
+#include <memory>
+#include <set>
+#include <string>
+
+namespace r = rotor;
+
+using slab_t = r::slab_t<std::string>;
+
+TEST_CASE("slab basics", "[slab]") {
+    slab_t slab;
+    REQUIRE(slab.empty());
+    REQUIRE(!slab.find(0));
+
+    auto k1 = slab.emplace("one");
+    auto k2 = slab.emplace("two");
+    REQUIRE(k1 != 0);
+    REQUIRE(k2 != 0);
+    REQUIRE(k1 != k2);
+    REQUIRE(slab.size() == 2);
+    REQUIRE(*slab.find(k1) == "one");
+    REQUIRE(*slab.find(k2) == "two");
+
+    REQUIRE(slab.erase(k1));
+    REQUIRE(!slab.erase(k1));
+    REQUIRE(!slab.find(k1));
+    REQUIRE(slab.size() == 1);
+
+    SECTION("slot is reused with other generation") {
+        auto k3 = slab.emplace("three");
+        REQUIRE(slab_t::index_of(k3) == slab_t::index_of(k1));
+        REQUIRE(k3 != k1);
+        REQUIRE(!slab.find(k1));
+        REQUIRE(*slab.find(k3) == "three");
+    }
+
+    SECTION("unknown index is not found") { REQUIRE(!slab.find(k2 + 100)); }
+}
+
+TEST_CASE("slab releases elements", "[slab]") {
+    auto value = std::make_shared<int>(5);
+    r::slab_t<std::shared_ptr<int>> slab;
+    auto key = slab.emplace(value);
+    REQUIRE(value.use_count() == 2);
+    slab.erase(key);
+    REQUIRE(value.use_count() == 1);
+}
+
+TEST_CASE("slab generation wraps around, key is never zero", "[slab]") {
+    // 4 generation bits, i.e. 15 generations per slot
+    using narrow_slab_t = r::slab_t<int, 60>;
+    narrow_slab_t slab;
+    std::set<r::slab_key_t> keys;
+    auto first = slab.emplace(0);
+    keys.emplace(first);
+    slab.erase(first);
+    bool ok = true;
+    for (std::size_t i = 1; i < 15; ++i) {
+        auto key = slab.emplace(1);
+        ok = ok && key != 0 && narrow_slab_t::index_of(key) == 0 && keys.emplace(key).second;
+        slab.erase(key);
+    }
+    REQUIRE(ok);
+    REQUIRE(keys.size() == 15);
+
+    // the generation wraps to the very first key, skipping zero
+    auto key = slab.emplace(2);
+    REQUIRE(key == first);
+    REQUIRE(*slab.find(key) == 2);
+}
+
+TEST_CASE("slab does not repeat keys of the reused slot", "[slab]") {
+    r::slab_t<int> slab;
+    std::set<r::slab_key_t> keys;
+    bool ok = true;
+    for (std::size_t i = 0; i < 100000; ++i) {
+        auto key = slab.emplace(1);
+        ok = ok && slab_t::index_of(key) == 0 && keys.emplace(key).second;
+        slab.erase(key);
+    }
+    REQUIRE(ok);
+}
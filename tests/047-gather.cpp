@@ -0,0 +1,247 @@
+//
+// Copyright (c) 2019-2020 Ivan Baidakou (basiliscos) (the dot dmol at gmail dot com)
+//
+// Distributed under the MIT Software License
+//
+
+#include "catch.hpp"
+#include "rotor.hpp"
+#include "supervisor_test.h"
+#include <vector>
+
+namespace r = rotor;
+namespace rt = r::test;
+
+struct answer_t {
+    int value;
+};
+
+struct question_t {
+    using response_t = answer_t;
+    int value;
+};
+
+using traits_t = r::request_traits_t<question_t>;
+
+struct probe_reply_t {
+    double value;
+};
+
+struct probe_t {
+    using response_t = probe_reply_t;
+};
+
+using probe_traits_t = r::request_traits_t<probe_t>;
+
+/* holds the probe request, to reply it later */
+struct prober_t : public r::actor_base_t {
+    using r::actor_base_t::actor_base_t;
+    r::intrusive_ptr_t<probe_traits_t::request::message_t> req_msg;
+
+    void init_start() noexcept override {
+        subscribe(&prober_t::on_probe);
+        r::actor_base_t::init_start();
+    }
+
+    void shutdown_start() noexcept override {
+        req_msg.reset();
+        r::actor_base_t::shutdown_start();
+    }
+
+    void on_probe(probe_traits_t::request::message_t &msg) noexcept { req_msg.reset(&msg); }
+};
+
+/* replies immediately, or holds the request if `silent` */
+struct service_t : public r::actor_base_t {
+    using r::actor_base_t::actor_base_t;
+    bool silent = false;
+    int cancellations = 0;
+    r::intrusive_ptr_t<traits_t::request::message_t> req_msg;
+
+    void init_start() noexcept override {
+        subscribe(&service_t::on_request);
+        subscribe(&service_t::on_cancel);
+        r::actor_base_t::init_start();
+    }
+
+    void shutdown_start() noexcept override {
+        req_msg.reset();
+        r::actor_base_t::shutdown_start();
+    }
+
+    void on_request(traits_t::request::message_t &msg) noexcept {
+        if (silent) {
+            req_msg.reset(&msg);
+        } else {
+            reply_to(msg, msg.payload.request_payload.value * 10);
+        }
+    }
+
+    void on_cancel(r::message::cancel_request_t &msg) noexcept {
+        if (msg.payload.request.get() == req_msg.get()) {
+            ++cancellations;
+        }
+    }
+};
+
+struct client_t : public r::actor_base_t {
+    using r::actor_base_t::actor_base_t;
+    std::vector<r::address_ptr_t> services;
+    r::request_id_t request_id = 0;
+    int results = 0;
+    std::error_code ec;
+    std::vector<int> values;
+    std::vector<std::error_code> errors;
+    std::vector<std::error_code> probe_errors;
+
+    void init_start() noexcept override {
+        subscribe(&client_t::on_gathered);
+        subscribe(&client_t::on_probe_reply);
+        r::actor_base_t::init_start();
+    }
+
+    void on_probe_reply(probe_traits_t::response::message_t &msg) noexcept { probe_errors.push_back(msg.payload.ec); }
+
+    void ask() noexcept {
+        auto builder = gather<question_t>();
+        int i = 0;
+        for (auto &service : services) {
+            builder.request(service, ++i);
+        }
+        request_id = builder.send(r::pt::seconds(1));
+    }
+
+    void on_gathered(traits_t::gather::message_t &msg) noexcept {
+        ++results;
+        ec = msg.payload.ec;
+        for (auto &response : msg.payload.responses) {
+            values.push_back(response->payload.res.value);
+            errors.push_back(response->payload.ec);
+        }
+    }
+};
+
+struct fixture_t : rt::system_test_t {
+    fixture_t(std::size_t services_count) {
+        client = sup->create_actor<client_t>(timeout);
+        for (std::size_t i = 0; i < services_count; ++i) {
+            auto service = sup->create_actor<service_t>(timeout);
+            services.push_back(service);
+            client->services.push_back(service->get_address());
+        }
+        sup->do_process();
+    }
+
+    r::intrusive_ptr_t<client_t> client;
+    std::vector<r::intrusive_ptr_t<service_t>> services;
+};
+
+TEST_CASE("all responses are gathered", "[gather]") {
+    fixture_t f(3);
+    f.client->ask();
+    REQUIRE(f.sup->active_timers.size() == 1);
+    REQUIRE(f.sup->get_requests().size() == 1);
+    f.sup->do_process();
+
+    REQUIRE(f.client->results == 1);
+    REQUIRE(!f.client->ec);
+    REQUIRE(f.client->values == std::vector<int>{10, 20, 30});
+    for (auto &ec : f.client->errors) {
+        CHECK(!ec);
+    }
+    REQUIRE(f.sup->active_timers.size() == 0);
+    REQUIRE(f.sup->get_requests().size() == 0);
+    f.finish();
+}
+
+TEST_CASE("missing response is replaced by timeout error", "[gather]") {
+    fixture_t f(3);
+    f.services[1]->silent = true;
+    f.client->ask();
+    f.sup->do_process();
+    REQUIRE(f.client->results == 0);
+    REQUIRE(f.sup->active_timers.size() == 1);
+
+    f.sup->on_timer_trigger(f.sup->get_timer(0));
+    f.sup->active_timers.clear();
+    f.sup->do_process();
+    REQUIRE(f.client->results == 1);
+    REQUIRE(f.client->ec == r::error_code_t::request_timeout);
+    REQUIRE(f.client->errors.size() == 3);
+    CHECK(!f.client->errors[0]);
+    CHECK(f.client->errors[1] == r::error_code_t::request_timeout);
+    CHECK(!f.client->errors[2]);
+    CHECK(f.client->values[2] == 30);
+
+    // late response is dropped
+    f.services[1]->reply_to(*f.services[1]->req_msg, 5);
+    f.sup->do_process();
+    REQUIRE(f.client->results == 1);
+    f.finish();
+}
+
+TEST_CASE("gather cancellation", "[gather]") {
+    fixture_t f(2);
+    f.services[0]->silent = true;
+    f.client->ask();
+    f.sup->do_process();
+    REQUIRE(f.client->results == 0);
+
+    REQUIRE(f.client->cancel_request(f.client->request_id));
+    REQUIRE(f.sup->active_timers.size() == 0);
+    f.sup->do_process();
+    REQUIRE(f.client->results == 1);
+    REQUIRE(f.client->ec == r::error_code_t::request_cancelled);
+    CHECK(f.client->errors[0] == r::error_code_t::request_cancelled);
+    CHECK(!f.client->errors[1]);
+    REQUIRE(f.services[0]->cancellations == 1);
+    REQUIRE(f.services[1]->cancellations == 0);
+    f.finish();
+}
+
+TEST_CASE("empty gather completes immediately", "[gather]") {
+    fixture_t f(0);
+    f.client->ask();
+    REQUIRE(f.sup->active_timers.size() == 0);
+    f.sup->do_process();
+    REQUIRE(f.client->results == 1);
+    REQUIRE(!f.client->ec);
+    REQUIRE(f.client->values.empty());
+    f.finish();
+}
+
+TEST_CASE("stale response of other type with the gather request id is ignored", "[gather]") {
+    fixture_t f(2);
+    auto prober = f.sup->create_actor<prober_t>(f.timeout);
+    f.sup->do_process();
+
+    auto probe_id = f.client->request<probe_t>(prober->get_address()).send(f.timeout);
+    f.sup->do_process();
+    REQUIRE(prober->req_msg);
+
+    f.services[0]->silent = true;
+    f.client->ask();
+    f.sup->do_process();
+    REQUIRE(f.client->results == 0);
+
+    // the late probe response carries the id of the gather, as if the slab key were reused
+    prober->req_msg->payload.id = f.client->request_id;
+    prober->reply_to(*prober->req_msg, 0.5);
+    f.sup->do_process();
+    REQUIRE(f.client->results == 0);
+    REQUIRE(f.client->probe_errors.empty());
+    REQUIRE(f.sup->get_requests().size() == 2);
+
+    f.services[0]->reply_to(*f.services[0]->req_msg, 7);
+    f.sup->do_process();
+    REQUIRE(f.client->results == 1);
+    REQUIRE(!f.client->ec);
+    REQUIRE(f.client->values == std::vector<int>{7, 20});
+
+    f.sup->on_timer_trigger(probe_id);
+    f.sup->active_timers.clear();
+    f.sup->do_process();
+    REQUIRE(f.client->probe_errors.size() == 1);
+    CHECK(f.client->probe_errors[0] == r::error_code_t::request_timeout);
+    f.finish();
+}
@@ -0,0 +1,353 @@
+//
+// Copyright (c) 2019-2020 Ivan Baidakou (basiliscos) (the dot dmol at gmail dot com)
+//
+// Distributed under the MIT Software License
+//
+
+#include "catch.hpp"
+#include "rotor.hpp"
+#include "supervisor_test.h"
+#include <map>
+#include <thread>
+#include <vector>
+
+namespace r = rotor;
+namespace rt = r::test;
+
+struct answer_t {
+    int value;
+};
+
+struct question_t {
+    using response_t = answer_t;
+    int value;
+};
+
+using traits_t = r::request_traits_t<question_t>;
+using router_t = r::router_t<question_t>;
+using router_config_t = r::router_config_t<question_t>;
+
+/* holds the requests until released */
+struct worker_t : public r::actor_base_t {
+    using r::actor_base_t::actor_base_t;
+    std::vector<r::intrusive_ptr_t<traits_t::request::message_t>> requests;
+    std::vector<int> served;
+
+    void init_start() noexcept override {
+        subscribe(&worker_t::on_request);
+        r::actor_base_t::init_start();
+    }
+
+    void shutdown_start() noexcept override {
+        requests.clear();
+        r::actor_base_t::shutdown_start();
+    }
+
+    void on_request(traits_t::request::message_t &msg) noexcept {
+        served.push_back(msg.payload.request_payload.value);
+        requests.emplace_back(&msg);
+    }
+
+    void release() noexcept {
+        for (auto &req : requests) {
+            reply_to(*req, req->payload.request_payload.value * 10);
+        }
+        requests.clear();
+    }
+};
+
+struct client_t : public r::actor_base_t {
+    using r::actor_base_t::actor_base_t;
+    r::address_ptr_t router_addr;
+    std::map<int, std::error_code> errors;
+    std::vector<int> values;
+
+    void init_start() noexcept override {
+        subscribe(&client_t::on_response);
+        r::actor_base_t::init_start();
+    }
+
+    void ask(int value, r::pt::time_duration timeout = r::pt::seconds(1)) noexcept {
+        request<question_t>(router_addr, value).send(timeout);
+    }
+
+    void on_response(traits_t::response::message_t &msg) noexcept {
+        auto value = msg.payload.req->payload.request_payload.value;
+        if (msg.payload.ec) {
+            errors[value] = msg.payload.ec;
+        } else {
+            values.push_back(msg.payload.res.value);
+        }
+    }
+};
+
+struct fixture_t : rt::system_test_t {
+    fixture_t(std::size_t workers_count, router_config_t config) {
+        for (std::size_t i = 0; i < workers_count; ++i) {
+            auto worker = sup->create_actor<worker_t>(timeout);
+            workers.push_back(worker);
+            config.workers.push_back(worker->get_address());
+        }
+        router = sup->create_actor<router_t>(timeout, config);
+        client = sup->create_actor<client_t>(timeout);
+        client->router_addr = router->get_address();
+        sup->do_process();
+    }
+
+    std::size_t outstanding(std::size_t index) { return router->get_workers()[index].outstanding; }
+
+    r::intrusive_ptr_t<router_t> router;
+    r::intrusive_ptr_t<client_t> client;
+    std::vector<r::intrusive_ptr_t<worker_t>> workers;
+};
+
+TEST_CASE("round robin routing, queueing and rejection", "[router]") {
+    router_config_t config;
+    config.queue_limit = 2;
+    fixture_t f(3, config);
+
+    for (int i = 1; i <= 6; ++i) {
+        f.client->ask(i);
+    }
+    f.sup->do_process();
+    REQUIRE(f.workers[0]->served == std::vector<int>{1});
+    REQUIRE(f.workers[1]->served == std::vector<int>{2});
+    REQUIRE(f.workers[2]->served == std::vector<int>{3});
+    REQUIRE(f.router->get_queue_size() == 2);
+    REQUIRE(f.client->errors.size() == 1);
+    REQUIRE(f.client->errors[6] == r::error_code_t::request_rejected);
+
+    // the freed worker gets the queued requests
+    f.workers[1]->release();
+    f.sup->do_process();
+    REQUIRE(f.client->values == std::vector<int>{20});
+    REQUIRE(f.workers[1]->served == std::vector<int>{2, 4});
+    REQUIRE(f.router->get_queue_size() == 1);
+    REQUIRE(f.outstanding(0) == 1);
+    REQUIRE(f.outstanding(1) == 1);
+
+    for (auto &worker : f.workers) {
+        worker->release();
+    }
+    f.sup->do_process();
+    for (auto &worker : f.workers) {
+        worker->release();
+    }
+    f.sup->do_process();
+    REQUIRE(f.client->values.size() == 5);
+    REQUIRE(f.router->get_queue_size() == 0);
+    for (std::size_t i = 0; i < f.workers.size(); ++i) {
+        CHECK(f.outstanding(i) == 0);
+    }
+    f.finish();
+}
+
+TEST_CASE("least outstanding routing", "[router]") {
+    router_config_t config;
+    config.routing = r::routing_t::least_outstanding;
+    config.max_outstanding = 3;
+    fixture_t f(2, config);
+
+    for (int i = 1; i <= 4; ++i) {
+        f.client->ask(i);
+    }
+    f.sup->do_process();
+    REQUIRE(f.outstanding(0) == 2);
+    REQUIRE(f.outstanding(1) == 2);
+
+    f.workers[0]->release();
+    f.sup->do_process();
+    REQUIRE(f.outstanding(0) == 0);
+
+    f.client->ask(5);
+    f.client->ask(6);
+    f.sup->do_process();
+    REQUIRE(f.outstanding(0) == 2);
+    REQUIRE(f.outstanding(1) == 2);
+    REQUIRE(f.workers[0]->requests.size() == 2);
+
+    for (auto &worker : f.workers) {
+        worker->release();
+    }
+    f.sup->do_process();
+    REQUIRE(f.client->values.size() == 6);
+    f.finish();
+}
+
+TEST_CASE("consistent hash routing", "[router]") {
+    router_config_t config;
+    config.routing = r::routing_t::consistent_hash;
+    config.max_outstanding = 100;
+    config.hasher = [](const question_t &q) { return static_cast<std::size_t>(q.value % 10); };
+    fixture_t f(4, config);
+
+    auto owners = [&]() {
+        std::map<int, std::size_t> result;
+        for (std::size_t i = 0; i < f.workers.size(); ++i) {
+            if (!f.workers[i]) {
+                continue;
+            }
+            for (auto value : f.workers[i]->served) {
+                auto key = value % 10;
+                auto it = result.find(key);
+                CHECK((it == result.end() || it->second == i));
+                result[key] = i;
+            }
+            f.workers[i]->served.clear();
+            f.workers[i]->release();
+        }
+        return result;
+    };
+
+    for (int i = 0; i < 50; ++i) {
+        f.client->ask(i);
+    }
+    f.sup->do_process();
+    auto before = owners();
+    REQUIRE(before.size() == 10);
+    f.sup->do_process();
+    REQUIRE(f.client->values.size() == 50);
+
+    // only the keys of the removed worker are re-mapped
+    REQUIRE(f.router->remove_worker(f.workers[1]->get_address()));
+    REQUIRE(!f.router->remove_worker(f.workers[1]->get_address()));
+    auto removed = f.workers[1];
+    f.workers[1].reset();
+    for (int i = 0; i < 50; ++i) {
+        f.client->ask(i);
+    }
+    f.sup->do_process();
+    REQUIRE(removed->served.empty());
+    auto after = owners();
+    REQUIRE(after.size() == 10);
+    for (auto &it : before) {
+        if (it.second != 1) {
+            CHECK(after[it.first] == it.second);
+        }
+    }
+    f.sup->do_process();
+    REQUIRE(f.client->values.size() == 100);
+    f.workers[1] = removed;
+    f.finish();
+}
+
+TEST_CASE("queued request with passed deadline is not dispatched", "[router]") {
+    router_config_t config;
+    config.queue_limit = 1;
+    fixture_t f(1, config);
+
+    f.client->ask(1);
+    f.client->ask(2, r::pt::milliseconds{1});
+    f.sup->do_process();
+    REQUIRE(f.router->get_queue_size() == 1);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds{5});
+    f.workers[0]->release();
+    f.sup->do_process();
+    REQUIRE(f.client->values == std::vector<int>{10});
+    REQUIRE(f.client->errors[2] == r::error_code_t::request_timeout);
+    REQUIRE(f.workers[0]->served == std::vector<int>{1});
+    REQUIRE(f.router->get_queue_size() == 0);
+
+    // the client's timer is not triggered by the test supervisor
+    f.sup->on_timer_trigger(f.sup->get_timer(0));
+    f.sup->active_timers.clear();
+    f.sup->do_process();
+    f.finish();
+}
+
+TEST_CASE("added worker serves the queued requests, shutdown releases the rest", "[router]") {
+    router_config_t config;
+    config.queue_limit = 10;
+    fixture_t f(0, config);
+
+    f.client->ask(1);
+    f.client->ask(2);
+    f.client->ask(3);
+    f.sup->do_process();
+    REQUIRE(f.router->get_queue_size() == 3);
+
+    auto worker = f.sup->create_actor<worker_t>(f.timeout);
+    f.sup->do_process();
+    f.router->add_worker(worker->get_address());
+    f.sup->do_process();
+    REQUIRE(worker->served == std::vector<int>{1});
+    REQUIRE(f.router->get_queue_size() == 2);
+
+    f.router->do_shutdown();
+    f.sup->do_process();
+    REQUIRE(f.client->errors.size() == 3);
+    REQUIRE(f.client->errors[1] == r::error_code_t::request_cancelled);
+    REQUIRE(f.client->errors[2] == r::error_code_t::request_rejected);
+    REQUIRE(f.client->errors[3] == r::error_code_t::request_rejected);
+
+    // late worker response is dropped
+    worker->release();
+    f.sup->do_process();
+    REQUIRE(f.client->values.empty());
+    f.finish();
+}
+
+TEST_CASE("removed and added again worker is not affected by the former responses", "[router]") {
+    router_config_t config;
+    config.routing = r::routing_t::least_outstanding;
+    config.max_outstanding = 2;
+    fixture_t f(1, config);
+
+    f.client->ask(1);
+    f.client->ask(2);
+    f.sup->do_process();
+    REQUIRE(f.outstanding(0) == 2);
+
+    auto address = f.workers[0]->get_address();
+    REQUIRE(f.router->remove_worker(address));
+    f.router->add_worker(address);
+    REQUIRE(f.outstanding(0) == 0);
+
+    f.client->ask(3);
+    f.sup->do_process();
+    REQUIRE(f.outstanding(0) == 1);
+
+    // the responses to the requests, sent before the removal, do not touch the new entry
+    auto former = std::move(f.workers[0]->requests);
+    f.workers[0]->requests.assign(former.begin() + 2, former.end());
+    former.resize(2);
+    for (auto &req : former) {
+        f.workers[0]->reply_to(*req, req->payload.request_payload.value * 10);
+    }
+    former.clear();
+    f.sup->do_process();
+    REQUIRE(f.client->values == std::vector<int>{10, 20});
+    REQUIRE(f.outstanding(0) == 1);
+
+    f.workers[0]->release();
+    f.sup->do_process();
+    REQUIRE(f.client->values == std::vector<int>{10, 20, 30});
+    REQUIRE(f.outstanding(0) == 0);
+
+    f.client->ask(4);
+    f.sup->do_process();
+    REQUIRE(f.workers[0]->served == std::vector<int>{1, 2, 3, 4});
+    f.workers[0]->release();
+    f.sup->do_process();
+    f.finish();
+}
+
+TEST_CASE("request without deadline is routed", "[router]") {
+    router_config_t config;
+    fixture_t f(1, config);
+
+    // the request is not sent via the builder, i.e. it has no deadline
+    auto reply_to = f.client->get_address();
+    f.sup->put(r::make_message<traits_t::request::wrapped_t>(f.router->get_address(), r::request_id_t{0}, reply_to, 1));
+    f.sup->do_process();
+    REQUIRE(f.workers[0]->served == std::vector<int>{1});
+    REQUIRE(f.client->errors.empty());
+    REQUIRE(f.sup->active_timers.size() == 0);
+
+    f.workers[0]->release();
+    f.sup->do_process();
+    REQUIRE(f.client->values == std::vector<int>{10});
+    REQUIRE(f.client->errors.empty());
+    f.finish();
+}
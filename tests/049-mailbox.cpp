@@ -0,0 +1,240 @@
+//
+// Copyright (c) 2019-2020 Ivan Baidakou (basiliscos) (the dot dmol at gmail dot com)
+//
+// Distributed under the MIT Software License
+//
+
+#include "catch.hpp"
+#include "rotor.hpp"
+#include "supervisor_test.h"
+#include <atomic>
+#include <deque>
+#include <thread>
+
+namespace r = rotor;
+namespace rt = r::test;
+
+struct item_t {
+    int value;
+};
+
+struct res_t {
+    int value;
+};
+
+struct req_t {
+    using response_t = res_t;
+    int value;
+};
+
+using item_message_t = r::message_t<item_t>;
+using traits_t = r::request_traits_t<req_t>;
+
+static r::message_ptr_t make_item(int value) { return r::make_message<item_t>(r::address_ptr_t{}, value); }
+
+static int value_of(const r::message_ptr_t &message) { return static_cast<item_message_t &>(*message).payload.value; }
+
+TEST_CASE("messages classification", "[mailbox]") {
+    CHECK(!make_item(0)->control);
+    CHECK(r::payload_control_t<r::payload::shutdown_trigger_t>::value);
+    CHECK(r::payload_control_t<r::message::init_request_t::payload_t>::value);
+    CHECK(r::payload_control_t<r::message::shutdown_response_t::payload_t>::value);
+    CHECK(!r::payload_control_t<traits_t::request::wrapped_t>::value);
+    CHECK(!make_item(0)->reject(r::make_error_code(r::error_code_t::request_rejected)));
+}
+
+TEST_CASE("drop newest", "[mailbox]") {
+    r::mailbox_t mailbox(2, r::overflow_policy_t::drop_newest);
+    r::mpsc_queue_t inbound;
+    std::deque<r::message_ptr_t> queue;
+
+    for (int i = 1; i <= 4; ++i) {
+        auto message = make_item(i);
+        if (mailbox.admit(message)) {
+            inbound.push(std::move(message));
+        } else {
+            CHECK(!message);
+        }
+    }
+    REQUIRE(mailbox.get_depth() == 2);
+    REQUIRE(mailbox.get_dropped() == 2);
+
+    // control messages are always admitted
+    auto control = r::make_message<r::payload::shutdown_trigger_t>(r::address_ptr_t{}, r::address_ptr_t{});
+    REQUIRE(mailbox.admit(control));
+    inbound.push(std::move(control));
+    REQUIRE(mailbox.get_depth() == 3);
+
+    auto count = inbound.pop_all(queue, [&](auto &message) { return mailbox.keep(message); });
+    mailbox.release(count);
+    REQUIRE(count == 3);
+    REQUIRE(queue.size() == 3);
+    REQUIRE(value_of(queue[0]) == 1);
+    REQUIRE(value_of(queue[1]) == 2);
+    REQUIRE(mailbox.get_depth() == 0);
+
+    auto message = make_item(5);
+    REQUIRE(mailbox.admit(message));
+}
+
+TEST_CASE("drop oldest", "[mailbox]") {
+    r::mailbox_t mailbox(2, r::overflow_policy_t::drop_oldest);
+    r::mpsc_queue_t inbound;
+    std::deque<r::message_ptr_t> queue;
+
+    for (int i = 1; i <= 5; ++i) {
+        auto message = make_item(i);
+        REQUIRE(mailbox.admit(message));
+        inbound.push(std::move(message));
+    }
+    REQUIRE(mailbox.get_depth() == 5);
+
+    auto count = inbound.pop_all(queue, [&](auto &message) { return mailbox.keep(message); });
+    mailbox.release(count);
+    REQUIRE(count == 5);
+    REQUIRE(queue.size() == 2);
+    REQUIRE(value_of(queue[0]) == 4);
+    REQUIRE(value_of(queue[1]) == 5);
+    REQUIRE(mailbox.get_dropped() == 3);
+    REQUIRE(mailbox.get_depth() == 0);
+}
+
+TEST_CASE("reject", "[mailbox]") {
+    r::system_context_t system_context;
+    rt::supervisor_config_test_t config(r::pt::milliseconds{1}, nullptr);
+    auto sup = system_context.create_supervisor<rt::supervisor_test_t>(nullptr, config);
+    sup->do_process();
+    auto reply_to = sup->get_address();
+
+    r::mailbox_t mailbox(1, r::overflow_policy_t::reject);
+    auto message = make_item(1);
+    REQUIRE(mailbox.admit(message));
+
+    // plain message is just dropped
+    message = make_item(2);
+    REQUIRE(!mailbox.admit(message));
+    REQUIRE(sup->get_leader_queue().size() == 0);
+
+    // request is replied with error
+    r::message_ptr_t request{new traits_t::request::message_t(r::address_ptr_t{}, 7u, reply_to, 3)};
+    auto raw_request = request.get();
+    REQUIRE(!mailbox.admit(request));
+    REQUIRE(!request);
+    REQUIRE(mailbox.get_rejected() == 2);
+    REQUIRE(sup->get_leader_queue().size() == 1);
+
+    auto reply = sup->get_leader_queue().pop_front();
+    auto &response = static_cast<traits_t::response::message_t &>(*reply);
+    REQUIRE(response.address == reply_to);
+    REQUIRE(response.payload.ec == r::error_code_t::request_rejected);
+    REQUIRE(response.payload.req.get() == raw_request);
+    REQUIRE(response.payload.request_id() == 7u);
+
+    sup->do_shutdown();
+    sup->do_process();
+    REQUIRE(sup->get_state() == r::state_t::SHUTTED_DOWN);
+}
+
+/* produces the requests into the full rejecting mailbox of other locality */
+struct producer_t : public r::actor_base_t {
+    using r::actor_base_t::actor_base_t;
+    r::mailbox_t *mailbox = nullptr;
+    r::address_ptr_t reply_to;
+    std::size_t own_queue = 0;
+    bool admitted = true;
+
+    void init_start() noexcept override {
+        subscribe(&producer_t::on_item);
+        r::actor_base_t::init_start();
+    }
+
+    void on_item(item_message_t &) noexcept {
+        auto &queue = static_cast<rt::supervisor_test_t &>(supervisor).get_leader_queue();
+        auto size = queue.size();
+        r::message_ptr_t request{new traits_t::request::message_t(r::address_ptr_t{}, 7u, reply_to, 3)};
+        admitted = mailbox->admit(request);
+        own_queue = queue.size() - size;
+    }
+};
+
+TEST_CASE("reject reply is routed by the producer supervisor", "[mailbox]") {
+    r::system_context_t system_context;
+    const char locality1[] = "l1";
+    const char locality2[] = "l2";
+    auto timeout = r::pt::milliseconds{1};
+    rt::supervisor_config_test_t config1(timeout, locality1);
+    rt::supervisor_config_test_t config2(timeout, locality2);
+    auto sup1 = system_context.create_supervisor<rt::supervisor_test_t>(nullptr, config1);
+    auto sup2 = sup1->create_actor<rt::supervisor_test_t>(timeout, config2);
+    auto producer = sup1->create_actor<producer_t>(timeout);
+    sup1->do_process();
+    sup2->do_process();
+    sup1->do_process();
+    REQUIRE(producer->get_state() == r::state_t::OPERATIONAL);
+
+    r::mailbox_t mailbox(1, r::overflow_policy_t::reject);
+    auto message = make_item(1);
+    REQUIRE(mailbox.admit(message));
+    producer->mailbox = &mailbox;
+    producer->reply_to = sup2->get_address();
+
+    REQUIRE(!r::supervisor_t::current_leader());
+    auto foreign = sup2->get_leader_queue().size();
+    sup1->put(r::make_message<item_t>(producer->get_address(), 2));
+    sup1->do_process();
+    REQUIRE(!r::supervisor_t::current_leader());
+    REQUIRE(!producer->admitted);
+    REQUIRE(mailbox.get_rejected() == 1);
+    // the reply has been put into the producer queue, and then forwarded to the reply address
+    REQUIRE(producer->own_queue == 1);
+    REQUIRE(sup1->get_leader_queue().size() == 0);
+    REQUIRE(sup2->get_leader_queue().size() == foreign + 1);
+    sup2->do_process();
+
+    sup1->do_shutdown();
+    sup1->do_process();
+    sup2->do_process();
+    sup1->do_process();
+    REQUIRE(sup1->get_state() == r::state_t::SHUTTED_DOWN);
+}
+
+TEST_CASE("block", "[mailbox]") {
+    const int total = 1000;
+    r::mailbox_t mailbox(4, r::overflow_policy_t::block);
+    r::mpsc_queue_t inbound;
+    std::atomic<std::size_t> max_depth{0};
+    std::atomic<bool> refused{false};
+
+    auto producer = std::thread([&]() {
+        for (int i = 0; i < total; ++i) {
+            auto message = make_item(i);
+            if (!mailbox.admit(message)) {
+                refused = true;
+            }
+            auto depth = mailbox.get_depth();
+            if (depth > max_depth) {
+                max_depth = depth;
+            }
+            inbound.push(std::move(message));
+        }
+    });
+
+    std::deque<r::message_ptr_t> queue;
+    while (queue.size() < static_cast<std::size_t>(total)) {
+        auto count = inbound.pop_all(queue);
+        if (count) {
+            mailbox.release(count);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+
+    REQUIRE(!refused);
+    REQUIRE(max_depth <= 4);
+    REQUIRE(mailbox.get_depth() == 0);
+    REQUIRE(mailbox.get_dropped() == 0);
+    for (int i = 0; i < total; ++i) {
+        CHECK(value_of(queue[i]) == i);
+    }
+}
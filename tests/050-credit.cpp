@@ -0,0 +1,152 @@
+//
+// Copyright (c) 2019-2020 Ivan Baidakou (basiliscos) (the dot dmol at gmail dot com)
+//
+// Distributed under the MIT Software License
+//
+
+#include "catch.hpp"
+#include "rotor.hpp"
+#include "supervisor_test.h"
+#include <deque>
+#include <memory>
+
+namespace r = rotor;
+namespace rt = r::test;
+
+struct item_t {
+    int value;
+};
+
+struct producer_t : public r::actor_base_t {
+    using r::actor_base_t::actor_base_t;
+    std::unique_ptr<r::credit_sender_t<item_t>> channel;
+    int total = 0;
+    int next = 0;
+    std::size_t foreign_grants = 0;
+
+    void init_start() noexcept override {
+        subscribe(&producer_t::on_grant);
+        r::actor_base_t::init_start();
+    }
+
+    void on_grant(r::message::credit_grant_t &msg) noexcept {
+        if (!channel->on_grant(msg)) {
+            ++foreign_grants;
+            return;
+        }
+        while (next < total && channel->send(next)) {
+            ++next;
+        }
+    }
+};
+
+struct consumer_t : public r::actor_base_t {
+    using r::actor_base_t::actor_base_t;
+    std::unique_ptr<r::credit_receiver_t> receiver;
+    std::deque<int> held;
+    std::vector<int> processed;
+    std::size_t max_held = 0;
+
+    void init_start() noexcept override {
+        subscribe(&consumer_t::on_item);
+        r::actor_base_t::init_start();
+    }
+
+    void on_item(r::message_t<item_t> &msg) noexcept {
+        held.push_back(msg.payload.value);
+        max_held = std::max(max_held, held.size());
+    }
+
+    void process(std::size_t count) noexcept {
+        for (std::size_t i = 0; i < count && !held.empty(); ++i) {
+            processed.push_back(held.front());
+            held.pop_front();
+            receiver->consumed();
+        }
+    }
+};
+
+struct fixture_t : rt::system_test_t {
+    fixture_t(int total, std::size_t window, std::size_t batch) {
+        producer = sup->create_actor<producer_t>(timeout);
+        consumer = sup->create_actor<consumer_t>(timeout);
+        producer->total = total;
+        producer->channel.reset(new r::credit_sender_t<item_t>(*producer, consumer->get_address()));
+        consumer->receiver.reset(new r::credit_receiver_t(*consumer, producer->get_address(), window, batch));
+        sup->do_process();
+        REQUIRE(consumer->get_state() == r::state_t::OPERATIONAL);
+    }
+
+    r::intrusive_ptr_t<producer_t> producer;
+    r::intrusive_ptr_t<consumer_t> consumer;
+};
+
+TEST_CASE("credits are granted by batches", "[credit]") {
+    fixture_t f(100, 8, 4);
+    auto &receiver = *f.consumer->receiver;
+    REQUIRE(receiver.get_batch() == 4);
+
+    // nothing is sent without credits
+    REQUIRE(!f.producer->channel->send(-1));
+    REQUIRE(f.producer->channel->get_sent() == 0);
+
+    receiver.open();
+    f.sup->do_process();
+    REQUIRE(f.consumer->held.size() == 8);
+    REQUIRE(f.producer->next == 8);
+    REQUIRE(f.producer->channel->get_credits() == 0);
+
+    // the credits are not granted individually
+    f.consumer->process(3);
+    f.sup->do_process();
+    REQUIRE(receiver.get_pending() == 3);
+    REQUIRE(receiver.get_grants() == 1);
+    REQUIRE(f.producer->next == 8);
+
+    f.consumer->process(1);
+    f.sup->do_process();
+    REQUIRE(receiver.get_pending() == 0);
+    REQUIRE(receiver.get_grants() == 2);
+    REQUIRE(f.producer->next == 12);
+    REQUIRE(f.consumer->held.size() == 8);
+
+    while (f.consumer->processed.size() < 100) {
+        f.consumer->process(3);
+        f.sup->do_process();
+    }
+    REQUIRE(f.consumer->max_held == 8);
+    REQUIRE(f.producer->channel->get_sent() == 100);
+    for (int i = 0; i < 100; ++i) {
+        CHECK(f.consumer->processed[i] == i);
+    }
+    REQUIRE(receiver.get_grants() == 1 + 100 / 4);
+    REQUIRE(f.producer->channel->get_credits() + f.consumer->held.size() + receiver.get_pending() == 8);
+    f.finish();
+}
+
+TEST_CASE("default batch, flush and foreign grants", "[credit]") {
+    fixture_t f(10, 5, 0);
+    auto &receiver = *f.consumer->receiver;
+    REQUIRE(receiver.get_batch() == 2);
+
+    receiver.open();
+    f.sup->do_process();
+    REQUIRE(f.consumer->held.size() == 5);
+
+    f.consumer->process(1);
+    receiver.flush();
+    receiver.flush();
+    f.sup->do_process();
+    REQUIRE(receiver.get_grants() == 2);
+    REQUIRE(f.producer->next == 6);
+
+    // the grant for other consumer does not give credits
+    f.sup->send<r::payload::credit_grant_t>(f.producer->get_address(), f.sup->get_address(), std::size_t{10});
+    f.sup->do_process();
+    REQUIRE(f.producer->foreign_grants == 1);
+    REQUIRE(f.producer->next == 6);
+    REQUIRE(f.producer->channel->get_credits() == 0);
+
+    REQUIRE(r::payload_control_t<r::payload::credit_grant_t>::value);
+    f.finish();
+}
@@ -0,0 +1,121 @@
+//
+// Copyright (c) 2019-2020 Ivan Baidakou (basiliscos) (the dot dmol at gmail dot com)
+//
+// Distributed under the MIT Software License
+//
+
+#include "catch.hpp"
+#include "rotor.hpp"
+#include "supervisor_test.h"
+#include <chrono>
+#include <thread>
+
+namespace r = rotor;
+namespace rt = r::test;
+
+struct item_t {
+    int value;
+};
+
+struct sink_actor_t : public r::actor_base_t {
+    using r::actor_base_t::actor_base_t;
+    std::vector<int> received;
+    r::pt::time_duration delay;
+
+    void init_start() noexcept override {
+        subscribe(&sink_actor_t::on_item);
+        r::actor_base_t::init_start();
+    }
+
+    void on_item(r::message_t<item_t> &msg) noexcept {
+        received.push_back(msg.payload.value);
+        if (!delay.is_zero()) {
+            std::this_thread::sleep_for(std::chrono::microseconds{delay.total_microseconds()});
+        }
+    }
+};
+
+struct fixture_t : rt::system_test_t {
+    fixture_t(const rt::supervisor_config_test_t &config) : rt::system_test_t{config} {
+        actor = sup->create_actor<sink_actor_t>(timeout);
+        process_all();
+        REQUIRE(actor->get_state() == r::state_t::OPERATIONAL);
+        sup->deferred = 0;
+    }
+
+    void put(int count) {
+        for (int i = 0; i < count; ++i) {
+            sup->put(r::make_message<item_t>(actor->get_address(), i));
+        }
+    }
+
+    void process_all() {
+        sup->do_process();
+        while (sup->get_queue_size()) {
+            sup->do_process();
+        }
+    }
+
+    r::intrusive_ptr_t<sink_actor_t> actor;
+};
+
+TEST_CASE("messages budget", "[supervisor]") {
+    rt::supervisor_config_test_t config(r::pt::milliseconds{1}, nullptr);
+    config.process_budget = 10;
+    fixture_t f(config);
+
+    f.put(25);
+    f.sup->do_process();
+    REQUIRE(f.actor->received.size() == 10);
+    REQUIRE(f.sup->get_queue_size() == 15);
+    REQUIRE(f.sup->deferred == 1);
+
+    f.sup->do_process();
+    REQUIRE(f.actor->received.size() == 20);
+    f.sup->do_process();
+    REQUIRE(f.actor->received.size() == 25);
+    REQUIRE(f.sup->get_queue_size() == 0);
+    REQUIRE(f.sup->deferred == 2);
+
+    // exact budget does not defer
+    f.put(10);
+    f.sup->do_process();
+    REQUIRE(f.actor->received.size() == 35);
+    REQUIRE(f.sup->deferred == 2);
+    f.finish();
+}
+
+TEST_CASE("time budget", "[supervisor]") {
+    rt::supervisor_config_test_t config(r::pt::milliseconds{1}, nullptr);
+    config.process_time_budget = r::pt::milliseconds{5};
+    fixture_t f(config);
+    f.actor->delay = r::pt::milliseconds{2};
+
+    f.put(10);
+    f.sup->do_process();
+    auto count = f.actor->received.size();
+    REQUIRE(count >= 1);
+    REQUIRE(count < 10);
+    REQUIRE(f.sup->deferred == 1);
+
+    // at least one message is processed per invocation
+    f.actor->delay = r::pt::milliseconds{10};
+    f.sup->do_process();
+    REQUIRE(f.actor->received.size() == count + 1);
+
+    f.actor->delay = r::pt::time_duration{};
+    f.sup->do_process();
+    REQUIRE(f.actor->received.size() == 10);
+    f.finish();
+}
+
+TEST_CASE("unlimited budget by default", "[supervisor]") {
+    rt::supervisor_config_test_t config(r::pt::milliseconds{1}, nullptr);
+    fixture_t f(config);
+
+    f.put(1000);
+    f.sup->do_process();
+    REQUIRE(f.actor->received.size() == 1000);
+    REQUIRE(f.sup->deferred == 0);
+    f.finish();
+}
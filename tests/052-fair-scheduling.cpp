@@ -0,0 +1,184 @@
+//
+// Copyright (c) 2019-2020 Ivan Baidakou (basiliscos) (the dot dmol at gmail dot com)
+//
+// Distributed under the MIT Software License
+//
+
+#include "catch.hpp"
+#include "rotor.hpp"
+#include "supervisor_test.h"
+#include <algorithm>
+#include <string>
+
+namespace r = rotor;
+namespace rt = r::test;
+
+struct item_t {
+    char tag;
+};
+
+struct sink_actor_t : public r::actor_base_t {
+    using r::actor_base_t::actor_base_t;
+    std::string *log = nullptr;
+
+    void init_start() noexcept override {
+        subscribe(&sink_actor_t::on_item);
+        r::actor_base_t::init_start();
+    }
+
+    void on_item(r::message_t<item_t> &msg) noexcept { log->push_back(msg.payload.tag); }
+};
+
+struct fixture_t : rt::system_test_t {
+    fixture_t(r::scheduling_t scheduling, std::size_t weight_a = 1, std::size_t weight_b = 1)
+        : rt::system_test_t{make_config(scheduling)} {
+        rt::supervisor_config_test_t config_a(timeout, nullptr);
+        config_a.weight = weight_a;
+        auto sup_a = sup->create_actor<rt::supervisor_test_t>(timeout, config_a);
+        rt::supervisor_config_test_t config_b(timeout, nullptr);
+        config_b.weight = weight_b;
+        auto sup_b = sup->create_actor<rt::supervisor_test_t>(timeout, config_b);
+
+        sink_a = sup_a->create_actor<sink_actor_t>(timeout);
+        sink_b = sup_b->create_actor<sink_actor_t>(timeout);
+        sink_a->log = sink_b->log = &log;
+        sup->do_process();
+        REQUIRE(sink_a->get_state() == r::state_t::OPERATIONAL);
+        REQUIRE(sink_b->get_state() == r::state_t::OPERATIONAL);
+    }
+
+    void put(r::intrusive_ptr_t<sink_actor_t> &sink, char tag, int count) {
+        for (int i = 0; i < count; ++i) {
+            sup->put(r::make_message<item_t>(sink->get_address(), tag));
+        }
+    }
+
+    static rt::supervisor_config_test_t make_config(r::scheduling_t scheduling) {
+        rt::supervisor_config_test_t config(r::pt::milliseconds{1}, nullptr);
+        config.scheduling = scheduling;
+        return config;
+    }
+
+    r::intrusive_ptr_t<sink_actor_t> sink_a;
+    r::intrusive_ptr_t<sink_actor_t> sink_b;
+    std::string log;
+};
+
+TEST_CASE("fifo scheduling", "[supervisor]") {
+    fixture_t f(r::scheduling_t::fifo);
+    f.put(f.sink_b, 'b', 6);
+    f.put(f.sink_a, 'a', 2);
+    REQUIRE(f.sup->get_queue_size() == 8);
+    f.sup->do_process();
+    REQUIRE(f.log == "bbbbbbaa");
+    f.finish();
+}
+
+TEST_CASE("round robin scheduling", "[supervisor]") {
+    fixture_t f(r::scheduling_t::round_robin, 5, 1);
+    f.put(f.sink_b, 'b', 6);
+    f.put(f.sink_a, 'a', 2);
+    REQUIRE(f.sup->get_queue_size() == 8);
+    f.sup->do_process();
+    // weights are ignored
+    REQUIRE(f.log == "babab" "bbb");
+    f.finish();
+}
+
+TEST_CASE("weighted scheduling", "[supervisor]") {
+    fixture_t f(r::scheduling_t::weighted, 3, 1);
+    f.put(f.sink_b, 'b', 6);
+    f.put(f.sink_a, 'a', 7);
+    f.sup->do_process();
+    REQUIRE(f.log == "baaa" "baaa" "ba" "bbb");
+
+    // the messages, produced during the processing, are scheduled too
+    f.log.clear();
+    f.put(f.sink_b, 'b', 4);
+    f.sup->do_process();
+    REQUIRE(f.log == "bbbb");
+    f.finish();
+}
+
+TEST_CASE("fair scheduling with processing budget", "[supervisor]") {
+    rt::supervisor_config_test_t config(r::pt::milliseconds{1}, nullptr);
+    config.scheduling = r::scheduling_t::round_robin;
+    config.process_budget = 3;
+    auto timeout = r::pt::milliseconds{1};
+    r::system_context_t system_context;
+    auto root = system_context.create_supervisor<rt::supervisor_test_t>(nullptr, config);
+    rt::supervisor_config_test_t config_child(timeout, nullptr);
+    auto child = root->create_actor<rt::supervisor_test_t>(timeout, config_child);
+    auto sink = child->create_actor<sink_actor_t>(timeout);
+    std::string log;
+    sink->log = &log;
+    while (root->get_queue_size()) {
+        root->do_process();
+    }
+    REQUIRE(sink->get_state() == r::state_t::OPERATIONAL);
+
+    for (int i = 0; i < 5; ++i) {
+        root->put(r::make_message<item_t>(sink->get_address(), 'x'));
+    }
+    REQUIRE(child->get_queue_size() == 5);
+    root->do_process();
+    REQUIRE(log == "xxx");
+    REQUIRE(root->get_queue_size() == 2);
+    root->do_process();
+    REQUIRE(log == "xxxxx");
+
+    root->do_shutdown();
+    while (root->get_queue_size()) {
+        root->do_process();
+    }
+    REQUIRE(root->get_state() == r::state_t::SHUTTED_DOWN);
+}
+
+TEST_CASE("high water mark accounts the sub-queues", "[supervisor]") {
+    fixture_t f(r::scheduling_t::round_robin);
+    auto mark = f.sup->get_queue_high_water_mark();
+    f.put(f.sink_b, 'b', 20);
+    f.put(f.sink_a, 'a', 20);
+    REQUIRE(f.sup->get_leader_queue().size() == 0);
+    REQUIRE(f.sup->get_queue_size() == 40);
+    REQUIRE(f.sup->get_queue_high_water_mark() == std::max(mark, std::size_t{40}));
+    f.sup->do_process();
+    REQUIRE(f.log.size() == 40);
+    f.finish();
+}
+
+struct mortal_supervisor_t : public rt::supervisor_test_t {
+    using rt::supervisor_test_t::supervisor_test_t;
+    bool *destroyed = nullptr;
+    ~mortal_supervisor_t() { *destroyed = true; }
+};
+
+TEST_CASE("destroyed supervisor leaves the turns", "[supervisor]") {
+    rt::supervisor_config_test_t config(r::pt::milliseconds{1}, nullptr);
+    config.scheduling = r::scheduling_t::round_robin;
+    auto timeout = r::pt::milliseconds{1};
+    r::system_context_t system_context;
+    auto root = system_context.create_supervisor<rt::supervisor_test_t>(nullptr, config);
+    rt::supervisor_config_test_t config_child(timeout, nullptr);
+    auto child = root->create_actor<mortal_supervisor_t>(timeout, config_child);
+    bool destroyed = false;
+    child->destroyed = &destroyed;
+    root->do_process();
+    REQUIRE(child->get_state() == r::state_t::OPERATIONAL);
+
+    child->do_shutdown();
+    root->do_process();
+    REQUIRE(child->get_state() == r::state_t::SHUTTED_DOWN);
+
+    root->put(r::make_message<item_t>(child->get_address(), 'x'));
+    root->put(r::make_message<item_t>(child->get_address(), 'y'));
+    REQUIRE(root->get_queue_size() == 2);
+    child.reset();
+    REQUIRE(destroyed);
+    REQUIRE(root->get_queue_size() == 0);
+    root->do_process();
+
+    root->do_shutdown();
+    root->do_process();
+    REQUIRE(root->get_state() == r::state_t::SHUTTED_DOWN);
+}
@@ -0,0 +1,100 @@
+//
+// Copyright (c) 2019-2020 Ivan Baidakou (basiliscos) (the dot dmol at gmail dot com)
+//
+// Distributed under the MIT Software License
+//
+
+#include "catch.hpp"
+#include "rotor.hpp"
+#include "rotor/spsc_ring.hpp"
+#include <deque>
+#include <thread>
+
+namespace r = rotor;
+
+struct payload_t {
+    std::size_t value;
+};
+
+using message_t = r::message_t<payload_t>;
+
+TEST_CASE("spsc ring basics", "[spsc]") {
+    r::spsc_ring_t ring(3);
+    std::deque<r::message_ptr_t> queue;
+    REQUIRE(ring.capacity() == 4);
+    REQUIRE(ring.empty());
+    REQUIRE(!ring.pop_all(queue));
+
+    auto msg = r::make_message<payload_t>(r::address_ptr_t{}, 0u);
+    auto raw_msg = msg.get();
+    REQUIRE(ring.push(msg));
+    REQUIRE(!msg);
+    REQUIRE(raw_msg->use_count() == 1);
+    for (std::size_t i = 1; i < 4; ++i) {
+        auto m = r::make_message<payload_t>(r::address_ptr_t{}, i);
+        REQUIRE(ring.push(m));
+    }
+    REQUIRE(!ring.empty());
+
+    // the message is left intact, when the ring is full
+    auto extra = r::make_message<payload_t>(r::address_ptr_t{}, 4u);
+    REQUIRE(!ring.push(extra));
+    REQUIRE(extra);
+
+    REQUIRE(ring.pop_all(queue) == 4);
+    REQUIRE(ring.empty());
+    REQUIRE(queue.front().get() == raw_msg);
+    REQUIRE(raw_msg->use_count() == 1);
+    for (std::size_t i = 0; i < queue.size(); ++i) {
+        REQUIRE(static_cast<message_t &>(*queue[i]).payload.value == i);
+    }
+
+    // the room is available again, wrapping around
+    REQUIRE(ring.push(extra));
+    REQUIRE(ring.pop_all(queue) == 1);
+    REQUIRE(static_cast<message_t &>(*queue.back()).payload.value == 4);
+
+    SECTION("not consumed messages are released") {
+        auto m = r::make_message<payload_t>(r::address_ptr_t{}, 5u);
+        auto raw_m = m.get();
+        intrusive_ptr_add_ref(raw_m);
+        {
+            r::spsc_ring_t other(2);
+            REQUIRE(other.push(m));
+            REQUIRE(raw_m->use_count() == 2);
+        }
+        REQUIRE(raw_m->use_count() == 1);
+        intrusive_ptr_release(raw_m);
+    }
+}
+
+TEST_CASE("spsc ring, producer and consumer threads", "[spsc]") {
+    const std::size_t total = 100000;
+    r::spsc_ring_t ring(64);
+    auto producer = std::thread([&ring] {
+        for (std::size_t i = 0; i < total; ++i) {
+            auto m = r::make_message<payload_t>(r::address_ptr_t{}, i);
+            while (!ring.push(m)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    std::size_t received = 0;
+    std::deque<r::message_ptr_t> queue;
+    bool ordered = true;
+    while (received < total) {
+        if (!ring.pop_all(queue)) {
+            std::this_thread::yield();
+        }
+        while (!queue.empty()) {
+            auto &m = static_cast<message_t &>(*queue.front());
+            ordered = ordered && (m.payload.value == received);
+            queue.pop_front();
+            ++received;
+        }
+    }
+    producer.join();
+    REQUIRE(ordered);
+    REQUIRE(ring.empty());
+}
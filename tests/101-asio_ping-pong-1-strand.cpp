@@ -99,6 +99,6 @@ TEST_CASE("ping/pong ", "[supervisor][asio]") {
 
     pinger.reset();
     ponger.reset();
-    REQUIRE(sup->get_timers_map().size() == 0);
+    REQUIRE(sup->get_timers().size() == 0);
     REQUIRE(destroyed == 4);
 }
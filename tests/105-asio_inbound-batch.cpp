@@ -0,0 +1,79 @@
+//
+// Copyright (c) 2019-2020 Ivan Baidakou (basiliscos) (the dot dmol at gmail dot com)
+//
+// Distributed under the MIT Software License
+//
+
+#include "catch.hpp"
+#include "rotor.hpp"
+#include "rotor/asio.hpp"
+#include "supervisor_asio_test.h"
+
+namespace r = rotor;
+namespace ra = rotor::asio;
+namespace rt = r::test;
+namespace asio = boost::asio;
+
+struct item_t {};
+
+struct counting_supervisor_t : public rt::supervisor_asio_test_t {
+    using rt::supervisor_asio_test_t::supervisor_asio_test_t;
+    std::size_t process_calls = 0;
+
+    void do_process() noexcept override {
+        ++process_calls;
+        rt::supervisor_asio_test_t::do_process();
+    }
+};
+
+struct sink_actor_t : public r::actor_base_t {
+    using r::actor_base_t::actor_base_t;
+    std::size_t received = 0;
+
+    void init_start() noexcept override {
+        subscribe(&sink_actor_t::on_item);
+        r::actor_base_t::init_start();
+    }
+
+    void on_item(r::message_t<item_t> &) noexcept { ++received; }
+};
+
+TEST_CASE("inbound messages are delivered in batch", "[supervisor][asio]") {
+    asio::io_context io_context{1};
+    auto timeout = r::pt::milliseconds{10};
+    auto system_context = ra::system_context_asio_t::ptr_t{new ra::system_context_asio_t(io_context)};
+    auto stand = std::make_shared<asio::io_context::strand>(io_context);
+    ra::supervisor_config_asio_t conf{timeout, std::move(stand)};
+    auto sup = system_context->create_supervisor<counting_supervisor_t>(conf);
+    auto actor = sup->create_actor<sink_actor_t>(timeout);
+
+    sup->start();
+    io_context.run();
+    REQUIRE(actor->get_state() == r::state_t::OPERATIONAL);
+
+    sup->process_calls = 0;
+    for (int i = 0; i < 10; ++i) {
+        sup->enqueue(r::make_message<item_t>(actor->get_address()));
+    }
+    REQUIRE(sup->get_leader_queue().size() == 0);
+
+    io_context.restart();
+    io_context.run();
+    REQUIRE(actor->received == 10);
+    REQUIRE(sup->process_calls == 1);
+
+    sup->enqueue(r::make_message<item_t>(actor->get_address()));
+    io_context.restart();
+    io_context.run();
+    REQUIRE(actor->received == 11);
+    REQUIRE(sup->process_calls == 2);
+
+    sup->shutdown();
+    io_context.restart();
+    io_context.run();
+
+    REQUIRE(sup->get_state() == r::state_t::SHUTTED_DOWN);
+    REQUIRE(sup->get_leader_queue().size() == 0);
+    REQUIRE(sup->get_points().size() == 0);
+    REQUIRE(sup->get_subscription().size() == 0);
+}
@@ -0,0 +1,141 @@
+//
+// Copyright (c) 2019-2020 Ivan Baidakou (basiliscos) (the dot dmol at gmail dot com)
+//
+// Distributed under the MIT Software License
+//
+
+#include "catch.hpp"
+#include "rotor.hpp"
+#include "rotor/asio.hpp"
+#include "supervisor_asio_test.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace r = rotor;
+namespace ra = rotor::asio;
+namespace rt = r::test;
+namespace asio = boost::asio;
+
+static const constexpr int total = 2000;
+static const constexpr std::size_t window = 16;
+
+struct item_t {
+    int value;
+};
+
+struct producer_t : public r::actor_base_t {
+    using r::actor_base_t::actor_base_t;
+    std::unique_ptr<r::credit_sender_t<item_t>> channel;
+    std::atomic<bool> ready{false};
+    std::size_t max_credits = 0;
+    int next = 0;
+
+    void init_start() noexcept override {
+        subscribe(&producer_t::on_grant);
+        r::actor_base_t::init_start();
+    }
+
+    void on_start(r::message_t<r::payload::start_actor_t> &msg) noexcept override {
+        r::actor_base_t::on_start(msg);
+        ready = true;
+    }
+
+    void on_grant(r::message::credit_grant_t &msg) noexcept {
+        channel->on_grant(msg);
+        max_credits = std::max(max_credits, channel->get_credits());
+        while (next < total && channel->send(next)) {
+            ++next;
+        }
+    }
+};
+
+struct consumer_t : public r::actor_base_t {
+    using r::actor_base_t::actor_base_t;
+    std::unique_ptr<r::credit_receiver_t> receiver;
+    r::supervisor_t *producer_sup = nullptr;
+    int received = 0;
+    bool ordered = true;
+
+    void init_start() noexcept override {
+        subscribe(&consumer_t::on_item);
+        r::actor_base_t::init_start();
+    }
+
+    void on_start(r::message_t<r::payload::start_actor_t> &msg) noexcept override {
+        r::actor_base_t::on_start(msg);
+        receiver->open();
+    }
+
+    void on_item(r::message_t<item_t> &msg) noexcept {
+        ordered = ordered && msg.payload.value == received;
+        ++received;
+        if (received % 100 == 0) {
+            // slow stage
+            std::this_thread::sleep_for(std::chrono::microseconds{200});
+        }
+        receiver->consumed();
+        if (received == total) {
+            supervisor.shutdown();
+            producer_sup->shutdown();
+        }
+    }
+};
+
+struct holding_supervisor_t : public rt::supervisor_asio_test_t {
+    using guard_t = asio::executor_work_guard<asio::io_context::executor_type>;
+
+    holding_supervisor_t(ra::supervisor_asio_t *sup, const ra::supervisor_config_asio_t &cfg)
+        : rt::supervisor_asio_test_t{sup, cfg}, guard{asio::make_work_guard(cfg.strand->context())} {}
+    guard_t guard;
+
+    void shutdown_finish() noexcept override {
+        rt::supervisor_asio_test_t::shutdown_finish();
+        guard.reset();
+    }
+};
+
+TEST_CASE("credit flow on 2 threads", "[supervisor][asio]") {
+    asio::io_context io_ctx1;
+    asio::io_context io_ctx2;
+
+    auto timeout = r::pt::milliseconds{100};
+    auto sys_ctx1 = ra::system_context_asio_t::ptr_t{new ra::system_context_asio_t(io_ctx1)};
+    auto sys_ctx2 = ra::system_context_asio_t::ptr_t{new ra::system_context_asio_t(io_ctx2)};
+    auto stand1 = std::make_shared<asio::io_context::strand>(io_ctx1);
+    auto stand2 = std::make_shared<asio::io_context::strand>(io_ctx2);
+    ra::supervisor_config_asio_t conf1{timeout, std::move(stand1)};
+    ra::supervisor_config_asio_t conf2{timeout, std::move(stand2)};
+
+    // the consumer never gets more items, than it has granted
+    conf2.mailbox_capacity = window + 4;
+    conf2.overflow_policy = r::overflow_policy_t::drop_newest;
+
+    auto sup1 = sys_ctx1->create_supervisor<holding_supervisor_t>(conf1);
+    auto sup2 = sys_ctx2->create_supervisor<holding_supervisor_t>(conf2);
+    auto producer = sup1->create_actor<producer_t>(timeout);
+    auto consumer = sup2->create_actor<consumer_t>(timeout);
+    producer->channel.reset(new r::credit_sender_t<item_t>(*producer, consumer->get_address()));
+    consumer->receiver.reset(new r::credit_receiver_t(*consumer, producer->get_address(), window));
+    consumer->producer_sup = sup1.get();
+
+    sup1->start();
+    auto t1 = std::thread([&] { io_ctx1.run(); });
+    while (!producer->ready) {
+        std::this_thread::yield();
+    }
+    sup2->start();
+    auto t2 = std::thread([&] { io_ctx2.run(); });
+    t1.join();
+    t2.join();
+
+    REQUIRE(consumer->received == total);
+    REQUIRE(consumer->ordered);
+    REQUIRE(producer->channel->get_sent() == total);
+    REQUIRE(producer->max_credits <= window);
+    REQUIRE(sup2->get_mailbox()->get_dropped() == 0);
+    REQUIRE(consumer->receiver->get_grants() == 1 + total / (window / 2));
+
+    REQUIRE(sup1->get_state() == r::state_t::SHUTTED_DOWN);
+    REQUIRE(sup2->get_state() == r::state_t::SHUTTED_DOWN);
+}
@@ -0,0 +1,85 @@
+//
+// Copyright (c) 2019-2020 Ivan Baidakou (basiliscos) (the dot dmol at gmail dot com)
+//
+// Distributed under the MIT Software License
+//
+
+#include "catch.hpp"
+#include "rotor.hpp"
+#include "rotor/asio.hpp"
+#include "supervisor_asio_test.h"
+
+namespace r = rotor;
+namespace ra = rotor::asio;
+namespace rt = r::test;
+namespace asio = boost::asio;
+
+static const constexpr int total = 1000;
+
+struct item_t {
+    int value;
+};
+
+struct storm_actor_t : public r::actor_base_t {
+    using r::actor_base_t::actor_base_t;
+    int received = 0;
+    int seen_by_io = -1;
+
+    void init_start() noexcept override {
+        subscribe(&storm_actor_t::on_item);
+        r::actor_base_t::init_start();
+    }
+
+    void on_start(r::message_t<r::payload::start_actor_t> &msg) noexcept override {
+        r::actor_base_t::on_start(msg);
+        for (int i = 0; i < total; ++i) {
+            send<item_t>(address, i);
+        }
+        // an I/O completion, which is ready while the messages are being processed
+        auto &io_context = static_cast<ra::supervisor_asio_t &>(supervisor).get_strand().context();
+        asio::post(io_context, [this]() { seen_by_io = received; });
+    }
+
+    void on_item(r::message_t<item_t> &) noexcept { ++received; }
+};
+
+TEST_CASE("process budget", "[supervisor][asio]") {
+    asio::io_context io_context{1};
+    auto timeout = r::pt::milliseconds{10};
+    auto system_context = ra::system_context_asio_t::ptr_t{new ra::system_context_asio_t(io_context)};
+    auto stand = std::make_shared<asio::io_context::strand>(io_context);
+    ra::supervisor_config_asio_t conf{timeout, std::move(stand)};
+
+    SECTION("unlimited") {
+        auto sup = system_context->create_supervisor<rt::supervisor_asio_test_t>(conf);
+        auto actor = sup->create_actor<storm_actor_t>(timeout);
+        sup->start();
+        io_context.run();
+        REQUIRE(actor->received == total);
+        REQUIRE(actor->seen_by_io == total);
+
+        sup->shutdown();
+        io_context.restart();
+        io_context.run();
+        REQUIRE(sup->get_state() == r::state_t::SHUTTED_DOWN);
+    }
+
+    SECTION("limited") {
+        conf.process_budget = 50;
+        auto sup = system_context->create_supervisor<rt::supervisor_asio_test_t>(conf);
+        auto actor = sup->create_actor<storm_actor_t>(timeout);
+        sup->start();
+        io_context.run();
+        REQUIRE(actor->received == total);
+        REQUIRE(actor->seen_by_io >= 0);
+        REQUIRE(actor->seen_by_io < total);
+        REQUIRE(sup->get_leader_queue().size() == 0);
+
+        sup->shutdown();
+        io_context.restart();
+        io_context.run();
+        REQUIRE(sup->get_state() == r::state_t::SHUTTED_DOWN);
+    }
+
+    REQUIRE(io_context.stopped());
+}
@@ -30,7 +30,7 @@ struct supervisor_ev_test_t : public re::supervisor_ev_t {
     r::state_t &get_state() noexcept { return state; }
     queue_t &get_leader_queue() { return get_leader().queue; }
     supervisor_ev_test_t &get_leader() { return *static_cast<supervisor_ev_test_t *>(locality_leader); }
-    queue_t &get_inbound_queue() noexcept { return inbound; }
+    r::mpsc_queue_t &get_inbound_queue() noexcept { return inbound; }
     subscription_points_t &get_points() noexcept { return points; }
     subscription_map_t &get_subscription() noexcept { return subscription_map; }
 };
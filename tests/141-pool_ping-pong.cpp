@@ -0,0 +1,170 @@
+//
+// Copyright (c) 2019-2020 Ivan Baidakou (basiliscos) (the dot dmol at gmail dot com)
+//
+// Distributed under the MIT Software License
+//
+
+#include "catch.hpp"
+#include "rotor.hpp"
+#include "rotor/pool.hpp"
+#include "supervisor_pool_test.h"
+#include <atomic>
+#include <vector>
+
+namespace r = rotor;
+namespace rp = rotor::pool;
+namespace rt = r::test;
+
+static const constexpr std::size_t pairs = 8;
+static const constexpr std::uint32_t pings = 1000;
+
+struct hello_t {};
+struct ping_t {};
+struct pong_t {};
+
+/* whoever starts later, greets the other one; the pinger starts on the first greeting */
+struct ponger_t : public r::actor_base_t {
+    using r::actor_base_t::actor_base_t;
+    r::address_ptr_t pinger_addr;
+    std::uint32_t ping_received = 0;
+
+    void init_start() noexcept override {
+        subscribe(&ponger_t::on_hello);
+        subscribe(&ponger_t::on_ping);
+        r::actor_base_t::init_start();
+    }
+
+    void on_start(r::message_t<r::payload::start_actor_t> &msg) noexcept override {
+        r::actor_base_t::on_start(msg);
+        send<hello_t>(pinger_addr);
+    }
+
+    void on_hello(r::message_t<hello_t> &) noexcept { send<hello_t>(pinger_addr); }
+
+    void on_ping(r::message_t<ping_t> &) noexcept {
+        ++ping_received;
+        send<pong_t>(pinger_addr);
+    }
+};
+
+struct pinger_t : public r::actor_base_t {
+    using r::actor_base_t::actor_base_t;
+    r::address_ptr_t ponger_addr;
+    r::supervisor_t *root = nullptr;
+    std::atomic<std::size_t> *finished = nullptr;
+    std::uint32_t pong_received = 0;
+    bool pinging = false;
+
+    void init_start() noexcept override {
+        subscribe(&pinger_t::on_hello);
+        subscribe(&pinger_t::on_pong);
+        r::actor_base_t::init_start();
+    }
+
+    void on_start(r::message_t<r::payload::start_actor_t> &msg) noexcept override {
+        r::actor_base_t::on_start(msg);
+        send<hello_t>(ponger_addr);
+    }
+
+    void on_hello(r::message_t<hello_t> &) noexcept {
+        if (!pinging) {
+            pinging = true;
+            send<ping_t>(ponger_addr);
+        }
+    }
+
+    void on_pong(r::message_t<pong_t> &) noexcept {
+        if (++pong_received < pings) {
+            send<ping_t>(ponger_addr);
+        } else if (++(*finished) == pairs) {
+            root->shutdown();
+        }
+    }
+};
+
+TEST_CASE("ping/pong of many localities on 4 threads", "[supervisor][pool]") {
+    auto timeout = r::pt::milliseconds{500};
+    auto system_context = rp::system_context_pool_t::ptr_t{new rp::system_context_pool_t(4)};
+    REQUIRE(system_context->get_threads() == 4);
+    rp::supervisor_config_pool_t conf{timeout};
+    auto root = system_context->create_supervisor<rt::supervisor_pool_test_t>(conf);
+
+    std::atomic<std::size_t> finished{0};
+    std::vector<r::intrusive_ptr_t<rt::supervisor_pool_test_t>> sups;
+    std::vector<r::intrusive_ptr_t<pinger_t>> pingers;
+    std::vector<r::intrusive_ptr_t<ponger_t>> pongers;
+    for (std::size_t i = 0; i < pairs; ++i) {
+        auto sup1 = root->create_actor<rt::supervisor_pool_test_t>(timeout, conf);
+        auto sup2 = root->create_actor<rt::supervisor_pool_test_t>(timeout, conf);
+        auto pinger = sup1->create_actor<pinger_t>(timeout);
+        auto ponger = sup2->create_actor<ponger_t>(timeout);
+        pinger->ponger_addr = ponger->get_address();
+        pinger->root = root.get();
+        pinger->finished = &finished;
+        ponger->pinger_addr = pinger->get_address();
+        REQUIRE(!sup1->get_address()->same_locality(*sup2->get_address()));
+        sups.insert(sups.end(), {sup1, sup2});
+        pingers.push_back(pinger);
+        pongers.push_back(ponger);
+    }
+
+    root->start();
+    system_context->run();
+
+    REQUIRE(finished == pairs);
+    REQUIRE(root->get_state() == r::state_t::SHUTTED_DOWN);
+    REQUIRE(root->get_leader_queue().size() == 0);
+    REQUIRE(root->get_subscription().size() == 0);
+    for (auto &sup : sups) {
+        REQUIRE(sup->get_state() == r::state_t::SHUTTED_DOWN);
+        REQUIRE(sup->get_leader_queue().size() == 0);
+        REQUIRE(!sup->violated);
+    }
+    for (std::size_t i = 0; i < pairs; ++i) {
+        REQUIRE(pingers[i]->pong_received == pings);
+        REQUIRE(pongers[i]->ping_received == pings);
+        REQUIRE(pingers[i]->get_state() == r::state_t::SHUTTED_DOWN);
+    }
+    REQUIRE(!root->violated);
+    // the localities, scheduled by busy workers, are picked up by idle ones
+    REQUIRE(system_context->get_steals() > 0);
+}
+
+TEST_CASE("shared locality and the single thread", "[supervisor][pool]") {
+    auto timeout = r::pt::milliseconds{500};
+    auto system_context = rp::system_context_pool_t::ptr_t{new rp::system_context_pool_t(1)};
+    rp::supervisor_config_pool_t conf{timeout};
+    auto root = system_context->create_supervisor<rt::supervisor_pool_test_t>(conf);
+
+    rp::supervisor_config_pool_t conf_shared{timeout, false};
+    // the single worker would wait for itself
+    rp::supervisor_config_pool_t conf_blocking{timeout};
+    conf_blocking.mailbox_capacity = 16;
+    conf_blocking.overflow_policy = r::overflow_policy_t::block;
+    std::atomic<std::size_t> finished{0};
+    auto sup1 = root->create_actor<rt::supervisor_pool_test_t>(timeout, conf_shared);
+    auto sup2 = root->create_actor<rt::supervisor_pool_test_t>(timeout, conf_blocking);
+    REQUIRE(sup2->get_mailbox()->get_policy() == r::overflow_policy_t::drop_newest);
+    REQUIRE(sup1->get_address()->same_locality(*root->get_address()));
+    REQUIRE(&sup1->get_leader() == root.get());
+    REQUIRE(!sup2->get_address()->same_locality(*root->get_address()));
+
+    auto pinger = sup1->create_actor<pinger_t>(timeout);
+    auto ponger = sup2->create_actor<ponger_t>(timeout);
+    pinger->ponger_addr = ponger->get_address();
+    pinger->root = root.get();
+    pinger->finished = &finished;
+    ponger->pinger_addr = pinger->get_address();
+
+    // the single pair finishes the test
+    finished = pairs - 1;
+    root->start();
+    system_context->run();
+
+    REQUIRE(pinger->pong_received == pings);
+    REQUIRE(root->get_state() == r::state_t::SHUTTED_DOWN);
+    REQUIRE(sup1->get_state() == r::state_t::SHUTTED_DOWN);
+    REQUIRE(sup2->get_state() == r::state_t::SHUTTED_DOWN);
+    // there is nothing to steal from
+    REQUIRE(system_context->get_steals() == 0);
+}
@@ -0,0 +1,62 @@
+//
+// Copyright (c) 2019-2020 Ivan Baidakou (basiliscos) (the dot dmol at gmail dot com)
+//
+// Distributed under the MIT Software License
+//
+
+#include "catch.hpp"
+#include "rotor.hpp"
+#include "rotor/pool.hpp"
+#include "supervisor_pool_test.h"
+
+namespace r = rotor;
+namespace rp = rotor::pool;
+namespace rt = r::test;
+
+struct sample_res_t {};
+struct sample_req_t {
+    using response_t = sample_res_t;
+};
+
+using traits_t = r::request_traits_t<sample_req_t>;
+
+struct bad_actor_t : public r::actor_base_t {
+    using r::actor_base_t::actor_base_t;
+    std::error_code ec;
+    r::supervisor_t *root = nullptr;
+
+    void init_start() noexcept override {
+        subscribe(&bad_actor_t::on_response);
+        r::actor_base_t::init_start();
+    }
+
+    void on_start(r::message_t<r::payload::start_actor_t> &msg) noexcept override {
+        r::actor_base_t::on_start(msg);
+        request<traits_t::request::type>(address).send(r::pt::milliseconds(5));
+    }
+
+    void on_response(traits_t::response::message_t &msg) noexcept {
+        ec = msg.payload.ec;
+        root->shutdown();
+    }
+};
+
+TEST_CASE("timer", "[supervisor][pool]") {
+    auto timeout = r::pt::milliseconds{500};
+    auto system_context = rp::system_context_pool_t::ptr_t{new rp::system_context_pool_t(2)};
+    rp::supervisor_config_pool_t conf{timeout};
+    auto root = system_context->create_supervisor<rt::supervisor_pool_test_t>(conf);
+    auto sup = root->create_actor<rt::supervisor_pool_test_t>(timeout, conf);
+    auto actor = sup->create_actor<bad_actor_t>(timeout);
+    actor->root = root.get();
+
+    root->start();
+    system_context->run();
+
+    REQUIRE(actor->ec == r::error_code_t::request_timeout);
+    REQUIRE(root->get_state() == r::state_t::SHUTTED_DOWN);
+    REQUIRE(sup->get_state() == r::state_t::SHUTTED_DOWN);
+    REQUIRE(sup->get_leader_queue().size() == 0);
+    REQUIRE(sup->get_points().size() == 0);
+    REQUIRE(sup->get_subscription().size() == 0);
+}
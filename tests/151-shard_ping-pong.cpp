@@ -0,0 +1,203 @@
+//
+// Copyright (c) 2019-2020 Ivan Baidakou (basiliscos) (the dot dmol at gmail dot com)
+//
+// Distributed under the MIT Software License
+//
+
+#include "catch.hpp"
+#include "rotor.hpp"
+#include "rotor/shard.hpp"
+#include "supervisor_shard_test.h"
+
+namespace r = rotor;
+namespace rs = rotor::shard;
+namespace rt = r::test;
+
+static const constexpr std::uint32_t pings = 1000;
+static const constexpr std::uint32_t total = 100;
+
+struct ping_t {};
+struct pong_t {};
+struct go_t {};
+struct item_t {
+    std::uint32_t value;
+};
+
+struct pinger_t : public r::actor_base_t {
+    using r::actor_base_t::actor_base_t;
+    r::address_ptr_t ponger_addr;
+    r::supervisor_t *root = nullptr;
+    std::uint32_t pong_received = 0;
+
+    void init_start() noexcept override {
+        subscribe(&pinger_t::on_pong);
+        r::actor_base_t::init_start();
+    }
+
+    void on_start(r::message_t<r::payload::start_actor_t> &msg) noexcept override {
+        r::actor_base_t::on_start(msg);
+        send<ping_t>(ponger_addr);
+    }
+
+    void on_pong(r::message_t<pong_t> &) noexcept {
+        if (++pong_received < pings) {
+            send<ping_t>(ponger_addr);
+        } else {
+            root->shutdown();
+            ponger_addr->supervisor.shutdown();
+        }
+    }
+};
+
+struct ponger_t : public r::actor_base_t {
+    using r::actor_base_t::actor_base_t;
+    r::address_ptr_t pinger_addr;
+    std::uint32_t ping_received = 0;
+
+    void init_start() noexcept override {
+        subscribe(&ponger_t::on_ping);
+        r::actor_base_t::init_start();
+    }
+
+    void on_ping(r::message_t<ping_t> &) noexcept {
+        ++ping_received;
+        send<pong_t>(pinger_addr);
+    }
+};
+
+struct burster_t : public r::actor_base_t {
+    using r::actor_base_t::actor_base_t;
+    r::address_ptr_t sink_addr;
+
+    void init_start() noexcept override {
+        subscribe(&burster_t::on_go);
+        r::actor_base_t::init_start();
+    }
+
+    void on_go(r::message_t<go_t> &) noexcept {
+        for (std::uint32_t i = 0; i < total; ++i) {
+            send<item_t>(sink_addr, i);
+        }
+    }
+};
+
+struct sink_t : public r::actor_base_t {
+    using r::actor_base_t::actor_base_t;
+    r::address_ptr_t burster_addr;
+    std::uint32_t received = 0;
+    bool ordered = true;
+
+    void init_start() noexcept override {
+        subscribe(&sink_t::on_item);
+        r::actor_base_t::init_start();
+    }
+
+    void on_start(r::message_t<r::payload::start_actor_t> &msg) noexcept override {
+        r::actor_base_t::on_start(msg);
+        send<go_t>(burster_addr);
+    }
+
+    void on_item(r::message_t<item_t> &msg) noexcept {
+        ordered = ordered && msg.payload.value == received;
+        if (++received == total) {
+            supervisor.shutdown();
+            burster_addr->supervisor.shutdown();
+        }
+    }
+};
+
+TEST_CASE("ping/pong between shards", "[supervisor][shard]") {
+    auto timeout = r::pt::milliseconds{500};
+    std::size_t idle_spins = 0;
+    SECTION("parking") { idle_spins = 100; }
+    SECTION("spinning") { idle_spins = rs::system_context_shard_t::never_park; }
+
+    auto system_context = rs::system_context_shard_t::ptr_t{new rs::system_context_shard_t(2, 16, idle_spins)};
+    REQUIRE(system_context->get_shards() == 2);
+    rs::supervisor_config_shard_t conf_sup1{timeout, 0};
+    auto sup1 = system_context->create_supervisor<rt::supervisor_shard_test_t>(conf_sup1);
+    // the shard thread might wait for itself
+    rs::supervisor_config_shard_t conf_blocking{timeout, 1};
+    conf_blocking.mailbox_capacity = 16;
+    conf_blocking.overflow_policy = r::overflow_policy_t::block;
+    auto sup2 = system_context->create_supervisor<rt::supervisor_shard_test_t>(conf_blocking);
+    REQUIRE(system_context->get_supervisor(1) == sup2);
+    REQUIRE(sup2->get_mailbox()->get_policy() == r::overflow_policy_t::drop_newest);
+
+    // the child supervisor shares the shard locality
+    auto child = sup1->create_actor<rt::supervisor_shard_test_t>(timeout, rs::supervisor_config_shard_t{timeout, 1});
+    REQUIRE(child->get_shard() == 0);
+    REQUIRE(&child->get_leader() == sup1.get());
+    REQUIRE(!sup1->get_address()->same_locality(*sup2->get_address()));
+
+    auto pinger = child->create_actor<pinger_t>(timeout);
+    auto ponger = sup2->create_actor<ponger_t>(timeout);
+    pinger->ponger_addr = ponger->get_address();
+    pinger->root = sup1.get();
+    ponger->pinger_addr = pinger->get_address();
+
+    // the threads are not started yet, so it is safe to initialize in the main thread;
+    // the ponger have to be ready before the first ping
+    sup2->do_process();
+    sup1->do_process();
+    REQUIRE(ponger->get_state() == r::state_t::OPERATIONAL);
+    system_context->run();
+
+    REQUIRE(pinger->pong_received == pings);
+    REQUIRE(ponger->ping_received == pings);
+    REQUIRE(sup1->get_state() == r::state_t::SHUTTED_DOWN);
+    REQUIRE(sup2->get_state() == r::state_t::SHUTTED_DOWN);
+    REQUIRE(child->get_state() == r::state_t::SHUTTED_DOWN);
+    REQUIRE(sup1->get_leader_queue().size() == 0);
+    REQUIRE(sup2->get_leader_queue().size() == 0);
+    REQUIRE(sup1->get_subscription().size() == 0);
+    REQUIRE(sup2->get_subscription().size() == 0);
+}
+
+TEST_CASE("backlog of the full ring", "[supervisor][shard]") {
+    auto timeout = r::pt::milliseconds{500};
+    auto system_context = rs::system_context_shard_t::ptr_t{new rs::system_context_shard_t(2, 4)};
+    rs::supervisor_config_shard_t conf_sup1{timeout, 0};
+    auto sup1 = system_context->create_supervisor<rt::supervisor_shard_test_t>(conf_sup1);
+    rs::supervisor_config_shard_t conf_sup2{timeout, 1};
+    auto sup2 = system_context->create_supervisor<rt::supervisor_shard_test_t>(conf_sup2);
+
+    auto burster = sup1->create_actor<burster_t>(timeout);
+    auto sink = sup2->create_actor<sink_t>(timeout);
+    burster->sink_addr = sink->get_address();
+    sink->burster_addr = burster->get_address();
+
+    // the burst is sent from the shard thread, i.e. via the ring
+    sup1->do_process();
+    sup2->do_process();
+    system_context->run();
+
+    REQUIRE(sink->received == total);
+    REQUIRE(sink->ordered);
+    REQUIRE(system_context->get_backlogged() > 0);
+    REQUIRE(sup1->get_state() == r::state_t::SHUTTED_DOWN);
+    REQUIRE(sup2->get_state() == r::state_t::SHUTTED_DOWN);
+}
+
+struct system_context_shard_test_t : public rs::system_context_shard_t {
+    using rs::system_context_shard_t::send;
+    using rs::system_context_shard_t::system_context_shard_t;
+};
+
+TEST_CASE("message to the shard without root supervisor is dropped", "[supervisor][shard]") {
+    auto timeout = r::pt::milliseconds{500};
+    auto system_context = r::intrusive_ptr_t<system_context_shard_test_t>{new system_context_shard_test_t(2, 4)};
+    rs::supervisor_config_shard_t conf_sup1{timeout, 0};
+    auto sup1 = system_context->create_supervisor<rt::supervisor_shard_test_t>(conf_sup1);
+    REQUIRE(!system_context->get_supervisor(1));
+
+    // the threads are not started, i.e. it is sent from the foreign thread
+    system_context->send(1, r::make_message<item_t>(sup1->get_address(), 1u));
+    system_context->send(2, r::make_message<item_t>(sup1->get_address(), 2u));
+    REQUIRE(system_context->get_dropped() == 2);
+
+    sup1->do_process();
+    sup1->do_shutdown();
+    sup1->do_process();
+    REQUIRE(sup1->get_state() == r::state_t::SHUTTED_DOWN);
+}
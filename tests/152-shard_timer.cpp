@@ -0,0 +1,66 @@
+//
+// Copyright (c) 2019-2020 Ivan Baidakou (basiliscos) (the dot dmol at gmail dot com)
+//
+// Distributed under the MIT Software License
+//
+
+#include "catch.hpp"
+#include "rotor.hpp"
+#include "rotor/shard.hpp"
+#include "supervisor_shard_test.h"
+
+namespace r = rotor;
+namespace rs = rotor::shard;
+namespace rt = r::test;
+
+struct sample_res_t {};
+struct sample_req_t {
+    using response_t = sample_res_t;
+};
+
+using traits_t = r::request_traits_t<sample_req_t>;
+
+struct bad_actor_t : public r::actor_base_t {
+    using r::actor_base_t::actor_base_t;
+    std::error_code ec;
+    r::supervisor_t *root = nullptr;
+
+    void init_start() noexcept override {
+        subscribe(&bad_actor_t::on_response);
+        r::actor_base_t::init_start();
+    }
+
+    void on_start(r::message_t<r::payload::start_actor_t> &msg) noexcept override {
+        r::actor_base_t::on_start(msg);
+        request<traits_t::request::type>(address).send(r::pt::milliseconds(5));
+    }
+
+    void on_response(traits_t::response::message_t &msg) noexcept {
+        ec = msg.payload.ec;
+        root->shutdown();
+    }
+};
+
+TEST_CASE("timer", "[supervisor][shard]") {
+    auto timeout = r::pt::milliseconds{500};
+    auto system_context = rs::system_context_shard_t::ptr_t{new rs::system_context_shard_t(2, 16, 100)};
+    rs::supervisor_config_shard_t conf_root{timeout, 1};
+    auto root = system_context->create_supervisor<rt::supervisor_shard_test_t>(conf_root);
+    rs::supervisor_config_shard_t conf_other{timeout, 0};
+    auto other = system_context->create_supervisor<rt::supervisor_shard_test_t>(conf_other);
+    auto sup = root->create_actor<rt::supervisor_shard_test_t>(timeout, rs::supervisor_config_shard_t{timeout});
+    auto actor = sup->create_actor<bad_actor_t>(timeout);
+    actor->root = root.get();
+    other->shutdown();
+
+    root->start();
+    system_context->run();
+
+    REQUIRE(actor->ec == r::error_code_t::request_timeout);
+    REQUIRE(root->get_state() == r::state_t::SHUTTED_DOWN);
+    REQUIRE(other->get_state() == r::state_t::SHUTTED_DOWN);
+    REQUIRE(sup->get_state() == r::state_t::SHUTTED_DOWN);
+    REQUIRE(sup->get_leader_queue().size() == 0);
+    REQUIRE(sup->get_points().size() == 0);
+    REQUIRE(sup->get_subscription().size() == 0);
+}
@@ -14,7 +14,7 @@ namespace test {
 struct supervisor_asio_test_t : public rotor::asio::supervisor_asio_t {
     using rotor::asio::supervisor_asio_t::supervisor_asio_t;
 
-    timers_map_t& get_timers_map() noexcept { return timers_map; }
+    timer_wheel_t& get_timers() noexcept { return timers; }
     state_t &get_state() noexcept { return state; }
     queue_t& get_leader_queue() { return get_leader().queue; }
     supervisor_asio_test_t& get_leader() { return *static_cast<supervisor_asio_test_t*>(locality_leader); }
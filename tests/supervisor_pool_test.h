@@ -0,0 +1,39 @@
+#pragma once
+
+//
+// Copyright (c) 2019-2020 Ivan Baidakou (basiliscos) (the dot dmol at gmail dot com)
+//
+// Distributed under the MIT Software License
+//
+
+#include "rotor/pool/supervisor_pool.h"
+#include <atomic>
+
+namespace rotor {
+namespace test {
+
+struct supervisor_pool_test_t : public rotor::pool::supervisor_pool_t {
+    using rotor::pool::supervisor_pool_t::supervisor_pool_t;
+
+    state_t &get_state() noexcept { return state; }
+    queue_t& get_leader_queue() { return get_leader().queue; }
+    supervisor_pool_test_t& get_leader() { return *static_cast<supervisor_pool_test_t*>(locality_leader); }
+    subscription_points_t &get_points() noexcept { return points; }
+    subscription_map_t &get_subscription() noexcept { return subscription_map; }
+
+    // set while the locality is processed, to detect the concurrent processing
+    std::atomic_bool busy{false};
+    std::atomic_bool violated{false};
+
+  protected:
+    void process() noexcept override {
+        if (busy.exchange(true)) {
+            violated = true;
+        }
+        rotor::pool::supervisor_pool_t::process();
+        busy = false;
+    }
+};
+
+} // namespace test
+} // namespace rotor
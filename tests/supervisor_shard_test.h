@@ -0,0 +1,25 @@
+#pragma once
+
+//
+// Copyright (c) 2019-2020 Ivan Baidakou (basiliscos) (the dot dmol at gmail dot com)
+//
+// Distributed under the MIT Software License
+//
+
+#include "rotor/shard/supervisor_shard.h"
+
+namespace rotor {
+namespace test {
+
+struct supervisor_shard_test_t : public rotor::shard::supervisor_shard_t {
+    using rotor::shard::supervisor_shard_t::supervisor_shard_t;
+
+    state_t &get_state() noexcept { return state; }
+    queue_t& get_leader_queue() { return get_leader().queue; }
+    supervisor_shard_test_t& get_leader() { return *static_cast<supervisor_shard_test_t*>(locality_leader); }
+    subscription_points_t &get_points() noexcept { return points; }
+    subscription_map_t &get_subscription() noexcept { return subscription_map; }
+};
+
+} // namespace test
+} // namespace rotor
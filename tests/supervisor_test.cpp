@@ -45,6 +45,24 @@ supervisor_t::timer_id_t supervisor_test_t::get_timer(std::size_t index) noexcep
 
 void supervisor_test_t::shutdown() noexcept { INFO("supervisor_test_t::shutdown()") }
 
+void supervisor_test_t::defer_process() noexcept { ++deferred; }
+
 void supervisor_test_t::enqueue(message_ptr_t message) noexcept {
     get_leader().queue.emplace_back(std::move(message));
 }
+
+system_test_t::system_test_t(const supervisor_config_test_t &config) : timeout{config.shutdown_timeout} {
+    sup = system_context.create_supervisor<supervisor_test_t>(nullptr, config);
+}
+
+void system_test_t::finish() {
+    sup->do_shutdown();
+    sup->do_process();
+    while (sup->get_queue_size()) {
+        sup->do_process();
+    }
+    REQUIRE(sup->get_state() == state_t::SHUTTED_DOWN);
+    REQUIRE(sup->get_leader_queue().size() == 0);
+    REQUIRE(sup->get_requests().size() == 0);
+    REQUIRE(sup->active_timers.size() == 0);
+}
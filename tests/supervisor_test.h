@@ -33,6 +33,7 @@ struct supervisor_test_t : public supervisor_t {
     virtual void shutdown() noexcept override;
     virtual void enqueue(rotor::message_ptr_t message) noexcept override;
     virtual address_ptr_t make_address() noexcept override;
+    virtual void defer_process() noexcept override;
 
     state_t &get_state() noexcept { return state; }
     queue_t& get_leader_queue() { return get_leader().queue; }
@@ -44,6 +45,19 @@ struct supervisor_test_t : public supervisor_t {
 
     const void *locality;
     timers_t active_timers;
+    std::size_t deferred = 0;
+};
+
+/* the system context with the root test supervisor, on which a test case creates its actors */
+struct system_test_t {
+    system_test_t(const supervisor_config_test_t &config = {pt::milliseconds{1}, nullptr});
+
+    /* shuts the root supervisor down and checks, that nothing is left behind */
+    void finish();
+
+    pt::time_duration timeout;
+    system_context_t system_context;
+    intrusive_ptr_t<supervisor_test_t> sup;
 };
 
 } // namespace test